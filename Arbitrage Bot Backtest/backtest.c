@@ -0,0 +1,691 @@
+//
+//  backtest.c
+//  Arbitrage Bot Backtest
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Headless backtest of the `on_tick` strategy of `main.c`, replayed from a capture file (see `capture.h`).
+//
+// The block range is split at keyframes and each shard runs on its own thread: it rebuilds the rate matrix block by
+// block, like `AdjacencyList.spotPicture`, and calls `on_tick`. The strategy talks to stand-in implementations of
+// `add_opportunity_in_queue` and `process_opportunities`, which simulate the best queued cycle on the captured
+// reserves instead of sending a transaction.
+//
+// Usage: backtest <capture> [--from block] [--to block] [--threads count] [--verbose]
+
+#include "arbitrager.h"
+#include "capture.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+void on_tick(void *dataStore, const double *rates, const CToken *tokens, size_t size, size_t systemTime);
+
+/// Same bounds as `BuilderStep.optimalPrice`, in whole tokens
+#define MAX_AMOUNT_IN 10000.0
+#define GOLDEN_ITERATIONS 80
+#define MAX_TOKENS 65536
+#define MAX_POOLS_PER_PAIR 8
+#define THREAD_STACK_SIZE (64 << 20)
+
+static uint64_t now_ns(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+
+// MARK: - Market state
+
+typedef struct {
+    bool defined;
+    uint8_t decimals;
+    uint8_t address[CAPTURE_ADDRESS_LENGTH];
+    char name[CAPTURE_NAME_LENGTH + 1];
+} token_t;
+
+typedef struct {
+    uint16_t exchange;
+    uint16_t fee;
+    double reserve0;
+    double reserve1;
+    double spot01;
+    double spot10;
+} pool_t;
+
+/// Pools of a pair, `token0` has the lowest address
+typedef struct {
+    uint32_t key; // token0 << 16 | token1, 0 for an empty slot (a token can't pair with itself)
+    uint32_t count;
+    pool_t pools[MAX_POOLS_PER_PAIR];
+} pair_t;
+
+typedef struct {
+    pair_t *slots;
+    size_t capacity; // power of two
+    size_t count;
+} pair_table_t;
+
+static inline uint32_t pair_key(uint16_t token0, uint16_t token1) {
+    return (uint32_t)token0 << 16 | token1;
+}
+
+static inline size_t pair_hash(uint32_t key, size_t capacity) {
+    return (size_t)((key * 0x9E3779B1u) >> 7) & (capacity - 1);
+}
+
+static pair_t *pair_find(const pair_table_t *table, uint32_t key) {
+    if (table->capacity == 0) {
+        return NULL;
+    }
+    for (size_t i = pair_hash(key, table->capacity);; i = (i + 1) & (table->capacity - 1)) {
+        if (table->slots[i].key == key) {
+            return &table->slots[i];
+        }
+        if (table->slots[i].key == 0) {
+            return NULL;
+        }
+    }
+}
+
+static pair_t *pair_insert(pair_table_t *table, uint32_t key) {
+    if ((table->count + 1) * 2 > table->capacity) {
+        pair_table_t grown = { .capacity = table->capacity ? table->capacity * 2 : 256 };
+        grown.slots = calloc(grown.capacity, sizeof(pair_t));
+        if (!grown.slots) {
+            return NULL;
+        }
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->slots[i].key) {
+                pair_t *slot = &grown.slots[pair_hash(table->slots[i].key, grown.capacity)];
+                while (slot->key) {
+                    slot = slot + 1 == grown.slots + grown.capacity ? grown.slots : slot + 1;
+                }
+                *slot = table->slots[i];
+                grown.count++;
+            }
+        }
+        free(table->slots);
+        *table = grown;
+    }
+    size_t i = pair_hash(key, table->capacity);
+    while (table->slots[i].key && table->slots[i].key != key) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    if (!table->slots[i].key) {
+        table->slots[i].key = key;
+        table->slots[i].count = 0;
+        table->count++;
+    }
+    return &table->slots[i];
+}
+
+static void pair_clear(pair_table_t *table) {
+    if (table->slots) {
+        memset(table->slots, 0, table->capacity * sizeof(pair_t));
+    }
+    table->count = 0;
+}
+
+static inline double reserve_value(const uint64_t reserve[2]) {
+    return (double)reserve[0] + ldexp((double)reserve[1], 64);
+}
+
+// MARK: - Worker
+
+typedef struct {
+    uint8_t address[CAPTURE_ADDRESS_LENGTH];
+    char name[CAPTURE_NAME_LENGTH + 1];
+    uint8_t decimals;
+    double profit; // in whole tokens
+} pnl_t;
+
+typedef struct {
+    // Shard
+    const char *path;
+    uint64_t from;
+    uint64_t to; // exclusive
+
+    // Replay state
+    token_t *tokens;
+    pair_table_t pairs;
+    uint16_t *matrix_tokens; // matrix index -> token id
+    int32_t *matrix_index;   // token id -> matrix index, -1 when absent
+    double *rates;
+    CToken *ctokens;
+    size_t size;
+    uint64_t block;
+
+    // Queued opportunities of the current tick
+    double best_profit;
+    uint16_t best_token;
+
+    // Results
+    uint64_t blocks;
+    uint64_t opportunities;
+    uint64_t trades;
+    uint64_t *durations; // on_tick time, per block
+    size_t durations_capacity;
+    uint64_t matrix_time;
+    pnl_t *pnl;
+    size_t pnl_count;
+    bool failed;
+    /// Whether its thread was created, and has to be joined
+    bool started;
+} worker_t;
+
+static int compare_addresses(const void *lhs, const void *rhs, void *context) {
+    const token_t *tokens = context;
+    return memcmp(tokens[*(const uint16_t *)lhs].address, tokens[*(const uint16_t *)rhs].address, CAPTURE_ADDRESS_LENGTH);
+}
+
+/// Insertion sort, token counts are small and `qsort_r` isn't portable
+static void sort_tokens(uint16_t *ids, size_t count, token_t *tokens) {
+    for (size_t i = 1; i < count; i++) {
+        uint16_t id = ids[i];
+        size_t j = i;
+        while (j > 0 && compare_addresses(&ids[j - 1], &id, tokens) > 0) {
+            ids[j] = ids[j - 1];
+            j--;
+        }
+        ids[j] = id;
+    }
+}
+
+/// Rebuilds the rate matrix like `AdjacencyList.spotPicture`: tokens sorted by address, best spot price across
+/// exchanges, 1 on the diagonal and infinity for pairs without pools.
+static bool rebuild_matrix(worker_t *worker) {
+    static const int32_t absent = -1;
+    for (size_t i = 0; i < worker->size; i++) {
+        worker->matrix_index[worker->matrix_tokens[i]] = absent;
+    }
+    size_t size = 0;
+    for (size_t i = 0; i < worker->pairs.capacity; i++) {
+        const pair_t *pair = &worker->pairs.slots[i];
+        if (!pair->key || !pair->count) {
+            continue;
+        }
+        uint16_t ids[2] = { pair->key >> 16, pair->key & 0xffff };
+        for (int k = 0; k < 2; k++) {
+            if (worker->matrix_index[ids[k]] == absent) {
+                worker->matrix_index[ids[k]] = (int32_t)size;
+                worker->matrix_tokens[size++] = ids[k];
+            }
+        }
+    }
+    sort_tokens(worker->matrix_tokens, size, worker->tokens);
+    for (size_t i = 0; i < size; i++) {
+        worker->matrix_index[worker->matrix_tokens[i]] = (int32_t)i;
+    }
+
+    if (size != worker->size) {
+        free(worker->rates);
+        free(worker->ctokens);
+        worker->rates = malloc(size * size * sizeof(double) + 1);
+        worker->ctokens = malloc(size * sizeof(CToken) + 1);
+        if (!worker->rates || !worker->ctokens) {
+            return false;
+        }
+        worker->size = size;
+    }
+    for (size_t i = 0; i < size; i++) {
+        CToken token = { ._index = (int)i, .address = worker->tokens[worker->matrix_tokens[i]].address };
+        memcpy(&worker->ctokens[i], &token, sizeof(token));
+        for (size_t j = 0; j < size; j++) {
+            worker->rates[i * size + j] = i == j ? 1 : INFINITY;
+        }
+    }
+    for (size_t i = 0; i < worker->pairs.capacity; i++) {
+        const pair_t *pair = &worker->pairs.slots[i];
+        if (!pair->key || !pair->count) {
+            continue;
+        }
+        size_t row = (size_t)worker->matrix_index[pair->key >> 16];
+        size_t col = (size_t)worker->matrix_index[pair->key & 0xffff];
+        double forward = 0, backward = 0;
+        for (uint32_t p = 0; p < pair->count; p++) {
+            forward = fmax(forward, isnan(pair->pools[p].spot01) ? 0 : pair->pools[p].spot01);
+            backward = fmax(backward, isnan(pair->pools[p].spot10) ? 0 : pair->pools[p].spot10);
+        }
+        worker->rates[row * size + col] = forward;
+        worker->rates[col * size + row] = backward;
+    }
+    return true;
+}
+
+static void apply_reserve(worker_t *worker, const capture_reserve_t *reserve) {
+    pair_t *pair = pair_insert(&worker->pairs, pair_key(reserve->token0, reserve->token1));
+    if (!pair) {
+        worker->failed = true;
+        return;
+    }
+    uint32_t p = 0;
+    while (p < pair->count && pair->pools[p].exchange != reserve->exchange) {
+        p++;
+    }
+    if (p == MAX_POOLS_PER_PAIR) {
+        return;
+    }
+    pair->count = p == pair->count ? p + 1 : pair->count;
+    pair->pools[p] = (pool_t){
+        .exchange = reserve->exchange,
+        .fee = reserve->fee,
+        .reserve0 = reserve_value(reserve->reserve0),
+        .reserve1 = reserve_value(reserve->reserve1),
+        .spot01 = reserve->spot01,
+        .spot10 = reserve->spot10,
+    };
+}
+
+static void record_duration(worker_t *worker, uint64_t duration) {
+    if (worker->blocks == worker->durations_capacity) {
+        size_t capacity = worker->durations_capacity ? worker->durations_capacity * 2 : 4096;
+        uint64_t *durations = realloc(worker->durations, capacity * sizeof(uint64_t));
+        if (!durations) {
+            worker->failed = true;
+            return;
+        }
+        worker->durations = durations;
+        worker->durations_capacity = capacity;
+    }
+    worker->durations[worker->blocks++] = duration;
+}
+
+static void *run_worker(void *context) {
+    worker_t *worker = context;
+    worker->tokens = calloc(MAX_TOKENS, sizeof(token_t));
+    worker->matrix_tokens = calloc(MAX_TOKENS, sizeof(uint16_t));
+    worker->matrix_index = malloc(MAX_TOKENS * sizeof(int32_t));
+    capture_reader_t *reader = capture_reader_open(worker->path);
+    if (!worker->tokens || !worker->matrix_tokens || !worker->matrix_index || !reader
+        || !capture_reader_seek(reader, worker->from)) {
+        worker->failed = true;
+        capture_reader_close(reader);
+        return NULL;
+    }
+    memset(worker->matrix_index, 0xff, MAX_TOKENS * sizeof(int32_t));
+
+    capture_record_t record;
+    bool dirty = true;
+    while (capture_reader_next(reader, &record) && !worker->failed) {
+        if (record.type == CAPTURE_RECORD_TOKEN) {
+            token_t *token = &worker->tokens[record.token->id];
+            token->defined = true;
+            token->decimals = record.token->decimals;
+            memcpy(token->address, record.token->address, CAPTURE_ADDRESS_LENGTH);
+            memcpy(token->name, record.token->name, record.token->name_length);
+            token->name[record.token->name_length] = '\0';
+            dirty = true;
+            continue;
+        }
+        if (record.type != CAPTURE_RECORD_BLOCK) {
+            continue;
+        }
+
+        const capture_block_t *block = record.block;
+        if (block->block >= worker->to) {
+            break;
+        }
+        // Keyframes hold every pool, what isn't in them is gone
+        if (block->flags & CAPTURE_BLOCK_KEYFRAME) {
+            pair_clear(&worker->pairs);
+        }
+        for (uint32_t i = 0; i < block->reserve_count; i++) {
+            apply_reserve(worker, &record.reserves[i]);
+        }
+        dirty = dirty || block->reserve_count > 0 || (block->flags & CAPTURE_BLOCK_KEYFRAME);
+        // Blocks before the start of the shard only rebuild the state
+        if (block->block < worker->from) {
+            continue;
+        }
+
+        uint64_t start = now_ns();
+        if (dirty && !rebuild_matrix(worker)) {
+            worker->failed = true;
+            break;
+        }
+        dirty = false;
+        uint64_t built = now_ns();
+        worker->matrix_time += built - start;
+
+        worker->block = block->block;
+        if (worker->size > 0) {
+            on_tick(worker, worker->rates, worker->ctokens, worker->size, (uint32_t)block->block);
+        }
+        record_duration(worker, now_ns() - built);
+    }
+    capture_reader_close(reader);
+    return NULL;
+}
+
+static void free_worker(worker_t *worker) {
+    free(worker->tokens);
+    free(worker->pairs.slots);
+    free(worker->matrix_tokens);
+    free(worker->matrix_index);
+    free(worker->rates);
+    free(worker->ctokens);
+    free(worker->durations);
+    free(worker->pnl);
+}
+
+// MARK: - Simulation
+
+/// Constant product output, with the fee over 1000 like `UniswapV2.getAmountOut`
+static inline double amount_out(double amount_in, double reserve_in, double reserve_out, uint16_t fee) {
+    if (amount_in <= 0 || reserve_in <= 0 || reserve_out <= 0) {
+        return 0;
+    }
+    double with_fee = amount_in * (1000 - fee);
+    return with_fee * reserve_out / (reserve_in * 1000 + with_fee);
+}
+
+/// Output of a cycle, taking the best pool of each hop (like `BuilderStep.price(for:)`)
+static double cycle_output(const worker_t *worker, const int *order, size_t size, double amount) {
+    for (size_t i = 0; i + 1 < size && amount > 0; i++) {
+        uint16_t from = worker->matrix_tokens[order[i]];
+        uint16_t to = worker->matrix_tokens[order[i + 1]];
+        const pair_t *pair = pair_find(&worker->pairs, pair_key(from, to));
+        bool forward = pair != NULL;
+        pair = pair ? pair : pair_find(&worker->pairs, pair_key(to, from));
+        if (!pair) {
+            return 0;
+        }
+        double best = 0;
+        for (uint32_t p = 0; p < pair->count; p++) {
+            const pool_t *pool = &pair->pools[p];
+            double out = forward ? amount_out(amount, pool->reserve0, pool->reserve1, pool->fee)
+                                 : amount_out(amount, pool->reserve1, pool->reserve0, pool->fee);
+            best = fmax(best, out);
+        }
+        amount = best;
+    }
+    return amount;
+}
+
+/// Profit of the cycle at its optimal input, in whole tokens of its first token. The profit of a chain of constant
+/// product pools is concave in the input, so a golden section search finds its maximum.
+static double simulate(const worker_t *worker, const int *order, size_t size) {
+    const token_t *start = &worker->tokens[worker->matrix_tokens[order[0]]];
+    double unit = pow(10, start->decimals);
+    double a = 0, b = MAX_AMOUNT_IN * unit;
+    const double ratio = 0.6180339887498949;
+    double c = b - ratio * (b - a), d = a + ratio * (b - a);
+    double fc = cycle_output(worker, order, size, c) - c;
+    double fd = cycle_output(worker, order, size, d) - d;
+    for (int i = 0; i < GOLDEN_ITERATIONS; i++) {
+        if (fc > fd) {
+            b = d, d = c, fd = fc;
+            c = b - ratio * (b - a);
+            fc = cycle_output(worker, order, size, c) - c;
+        } else {
+            a = c, c = d, fc = fd;
+            d = a + ratio * (b - a);
+            fd = cycle_output(worker, order, size, d) - d;
+        }
+    }
+    return fmax(fc, fd) / unit;
+}
+
+static void add_profit(worker_t *worker, uint16_t id, double profit) {
+    const token_t *token = &worker->tokens[id];
+    for (size_t i = 0; i < worker->pnl_count; i++) {
+        if (memcmp(worker->pnl[i].address, token->address, CAPTURE_ADDRESS_LENGTH) == 0) {
+            worker->pnl[i].profit += profit;
+            return;
+        }
+    }
+    pnl_t *pnl = realloc(worker->pnl, (worker->pnl_count + 1) * sizeof(pnl_t));
+    if (!pnl) {
+        worker->failed = true;
+        return;
+    }
+    worker->pnl = pnl;
+    pnl_t *entry = &worker->pnl[worker->pnl_count++];
+    memcpy(entry->address, token->address, CAPTURE_ADDRESS_LENGTH);
+    memcpy(entry->name, token->name, sizeof(entry->name));
+    entry->decimals = token->decimals;
+    entry->profit = profit;
+}
+
+// MARK: - Stand-ins
+
+void get_name_for_token(void *_Nonnull dataStore, const uint8_t *_Nonnull tokenAddress, char *_Nonnull result) {
+    worker_t *worker = dataStore;
+    for (size_t i = 0; i < worker->size; i++) {
+        const token_t *token = &worker->tokens[worker->matrix_tokens[i]];
+        if (memcmp(token->address, tokenAddress, CAPTURE_ADDRESS_LENGTH) == 0) {
+            // Like the live implementation, `result` is a `char **` receiving a copy of the name
+            *(char **)result = strdup(token->name);
+            return;
+        }
+    }
+}
+
+void add_opportunity_in_queue(void *_Nonnull dataStore, int *_Nonnull order, size_t size, size_t systemTime) {
+    worker_t *worker = dataStore;
+    if (size < 2 || systemTime != (uint32_t)worker->block) {
+        return;
+    }
+    worker->opportunities++;
+    double profit = simulate(worker, order, size);
+    if (profit > worker->best_profit) {
+        worker->best_profit = profit;
+        worker->best_token = worker->matrix_tokens[order[0]];
+    }
+}
+
+void process_opportunities(void *_Nonnull dataStore, size_t systemTime) {
+    (void)systemTime;
+    worker_t *worker = dataStore;
+    // Like `Builder.process`, only the best opportunity is executed, if profitable
+    if (worker->best_profit > 0) {
+        worker->trades++;
+        add_profit(worker, worker->best_token, worker->best_profit);
+    }
+    worker->best_profit = 0;
+}
+
+void trace_cycle_search(size_t systemTime) {
+    (void)systemTime;
+}
+
+// MARK: - Report
+
+static int compare_durations(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return (a > b) - (a < b);
+}
+
+static double percentile(const uint64_t *sorted, size_t count, double quantile) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t index = (size_t)(quantile * (double)(count - 1) + 0.5);
+    return (double)sorted[index] / 1e3;
+}
+
+static void report(FILE *out, worker_t *workers, size_t count, uint64_t wall) {
+    uint64_t blocks = 0, opportunities = 0, trades = 0, matrix_time = 0, tick_time = 0;
+    for (size_t i = 0; i < count; i++) {
+        blocks += workers[i].blocks;
+        opportunities += workers[i].opportunities;
+        trades += workers[i].trades;
+        matrix_time += workers[i].matrix_time;
+    }
+    uint64_t *durations = malloc(blocks * sizeof(uint64_t) + 1);
+    size_t offset = 0;
+    for (size_t i = 0; i < count && durations; i++) {
+        if (workers[i].blocks == 0) continue; // Empty or failed shard, without durations
+        memcpy(durations + offset, workers[i].durations, workers[i].blocks * sizeof(uint64_t));
+        offset += workers[i].blocks;
+    }
+    if (durations) {
+        for (size_t i = 0; i < blocks; i++) {
+            tick_time += durations[i];
+        }
+        qsort(durations, blocks, sizeof(uint64_t), compare_durations);
+    }
+
+    fprintf(out, "Blocks: %llu in %zu shards, %.2fs (%.0f blocks/s)\n", (unsigned long long)blocks, count,
+            (double)wall / 1e9, wall ? (double)blocks * 1e9 / (double)wall : 0);
+    fprintf(out, "Opportunities: %llu, trades: %llu\n", (unsigned long long)opportunities, (unsigned long long)trades);
+    if (durations && blocks > 0) {
+        fprintf(out, "on_tick per block: mean %.1fµs, p50 %.1fµs, p99 %.1fµs, max %.1fµs\n",
+                (double)tick_time / (double)blocks / 1e3, percentile(durations, blocks, 0.5),
+                percentile(durations, blocks, 0.99), (double)durations[blocks - 1] / 1e3);
+        fprintf(out, "Rate matrix per block: mean %.1fµs\n", (double)matrix_time / (double)blocks / 1e3);
+    }
+    free(durations);
+
+    // Merge the PnL of every shard, per token
+    fprintf(out, "PnL:\n");
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < workers[i].pnl_count; j++) {
+            pnl_t *entry = &workers[i].pnl[j];
+            if (isnan(entry->profit)) {
+                continue;
+            }
+            double total = entry->profit;
+            for (size_t k = i + 1; k < count; k++) {
+                for (size_t l = 0; l < workers[k].pnl_count; l++) {
+                    if (memcmp(workers[k].pnl[l].address, entry->address, CAPTURE_ADDRESS_LENGTH) == 0) {
+                        total += workers[k].pnl[l].profit;
+                        workers[k].pnl[l].profit = NAN;
+                    }
+                }
+            }
+            fprintf(out, "  %-16s %+.6f\n", entry->name, total);
+        }
+    }
+}
+
+// MARK: - Main
+
+static void usage(void) {
+    fprintf(stderr, "Usage: backtest <capture> [--from block] [--to block] [--threads count] [--verbose]\n");
+}
+
+int main(int argc, const char *argv[]) {
+    const char *path = NULL;
+    uint64_t from = 0, to = UINT64_MAX;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            to = strtoull(argv[++i], NULL, 10) + 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (!path) {
+        usage();
+        return 1;
+    }
+
+    capture_reader_t *reader = capture_reader_open(path);
+    if (!reader) {
+        fprintf(stderr, "Couldn't open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    const capture_index_entry_t *index = capture_reader_index(reader);
+    size_t count = capture_reader_block_count(reader);
+
+    // Shards start at keyframes, so each one can rebuild the full state on its own
+    size_t *keyframes = malloc(count * sizeof(size_t) + 1);
+    size_t keyframe_count = 0;
+    for (size_t i = 0; i < count && keyframes; i++) {
+        if ((index[i].flags & CAPTURE_BLOCK_KEYFRAME) && index[i].block > from && index[i].block < to) {
+            keyframes[keyframe_count++] = i;
+        }
+    }
+    // The first shard starts at `from`, replaying from the keyframe before it
+    size_t shards = threads < 1 ? 1 : (size_t)threads;
+    shards = shards > keyframe_count + 1 ? keyframe_count + 1 : shards;
+    worker_t *workers = calloc(shards, sizeof(worker_t));
+    if (!keyframes || !workers) {
+        free(keyframes);
+        free(workers);
+        capture_reader_close(reader);
+        return 1;
+    }
+    for (size_t shard = 0; shard < shards; shard++) {
+        size_t first = shard * (keyframe_count + 1) / shards;
+        size_t next = (shard + 1) * (keyframe_count + 1) / shards;
+        workers[shard].path = path;
+        workers[shard].from = first == 0 ? from : index[keyframes[first - 1]].block;
+        workers[shard].to = shard + 1 < shards ? index[keyframes[next - 1]].block : to;
+    }
+    free(keyframes);
+    capture_reader_close(reader);
+
+    pthread_t *handles = calloc(shards, sizeof(pthread_t));
+    if (!handles) {
+        fprintf(stderr, "Couldn't allocate %zu threads\n", shards);
+        free(workers);
+        return 1;
+    }
+
+    // The strategy logs to stdout, keep it for the report only
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!verbose) {
+        fflush(stdout);
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        close(null);
+    }
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    // `on_tick` keeps its matrices on the stack
+    pthread_attr_setstacksize(&attributes, THREAD_STACK_SIZE);
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < shards; i++) {
+        int error = pthread_create(&handles[i], &attributes, run_worker, &workers[i]);
+        if (error) {
+            // The other shards still run, their results are reported as partial
+            fprintf(stderr, "Couldn't start the thread of shard %zu: %s\n", i, strerror(error));
+            workers[i].failed = true;
+            continue;
+        }
+        workers[i].started = true;
+    }
+    bool failed = false;
+    for (size_t i = 0; i < shards; i++) {
+        if (workers[i].started) {
+            pthread_join(handles[i], NULL);
+        }
+        failed = failed || workers[i].failed;
+    }
+    uint64_t wall = now_ns() - start;
+    pthread_attr_destroy(&attributes);
+    free(handles);
+
+    fflush(stdout);
+    if (failed) {
+        fprintf(stderr, "Backtest failed, results are partial\n");
+    }
+    report(out ? out : stderr, workers, shards, wall);
+    if (out) {
+        fclose(out);
+    }
+    for (size_t i = 0; i < shards; i++) {
+        free_worker(&workers[i]);
+    }
+    free(workers);
+    return failed ? 1 : 0;
+}
@@ -14,6 +14,7 @@
 #include "negate_log.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifndef DBL_MAX
@@ -30,6 +31,8 @@ void processArbitrage(void *dataStore, const CToken *tokens, int *arbitrageOrder
 void BellmanFord(const double *matrix, size_t size, int src, int *cycle, double *cycle_weight, int *cycle_length);
 
 // MARK: - Main
+// The backtest (see `Arbitrage Bot Backtest/backtest.c`) provides its own `main` and drives `on_tick` directly.
+#ifndef BACKTEST
 int arbitrage_main(int argc, const char *argv[]) {
     // Start the server
     Server *server = new_server("botconfig.json");
@@ -40,7 +43,13 @@ int arbitrage_main(int argc, const char *argv[]) {
     
     server->pipe(store);
     
-    start_server(server, 8080);
+    // SERVER_THREADS=0 runs one server thread per core
+    const char *threads = getenv("SERVER_THREADS");
+    if (threads) {
+        start_server_threads(server, 8080, atoi(threads));
+    } else {
+        start_server(server, 8080);
+    }
     
     return 0;
 }
@@ -49,6 +58,7 @@ int arbitrage_main(int argc, const char *argv[]) {
 #else
 int main(int argc, const char *argv[]) { arbitrage_main(argc, argv); }
 #endif
+#endif // BACKTEST
 
 // For DEBUG
 void print_kernel(double *kernel, int size, const CToken *tokens, void *dataStore) {
@@ -88,13 +98,16 @@ void on_tick(void *dataStore, const double *rates, const CToken *tokens, size_t
     
     calculate_neg_log(rates, weights, (int)rateSize);
     
+#ifndef BACKTEST
     print_kernel(rates, size, tokens, dataStore);
+#endif
     
     int src = 0; // Source vertex as 0
     int cycle[size * 2]; // Adjust the size to accommodate the two extra elements.
     double cycle_weight; // Create a new array to store weights
     int cycle_length;
     BellmanFord(weights, size, src, cycle, &cycle_weight, &cycle_length); // Start from the second index
+    trace_cycle_search(systemTime);
     
     if (cycle_weight > 0 || cycle_length <= 3 || cycle[0] != src) {
         return;
@@ -132,6 +145,7 @@ void BellmanFord(const double* matrix, size_t size, int src, int* cycle, double*
     double distance[size];
     int predecessor[size];
     *cycle_weight = 0;
+    *cycle_length = 0;
     
     for (int i = 0; i < size; i++) {
         distance[i] = DBL_MAX;
@@ -165,7 +179,7 @@ void BellmanFord(const double* matrix, size_t size, int src, int* cycle, double*
                 memset(visited, false, sizeof(visited));
                 int cycle_vertix = k;
                 do {
-                    if (visited[cycle_vertix]) {
+                    if (cycle_vertix < 0 || visited[cycle_vertix]) {
                         break;
                     }
                     visited[cycle_vertix] = true;
@@ -58,6 +58,7 @@ public func addOpportunityForReview(storeId: Int32, order: UnsafePointer<Int32>,
         guard let step = try await priceDataStores[Int(storeId)]?
             .adjacencyList
             .buildSteps(from: arbitrageOrder.map { Int($0) }) else { return }
+        StageTracer.mark(.buildSteps, systemTime: systemTime)
         
         priceDataStores[Int(storeId)]?
             .adjacencyList
@@ -69,11 +70,9 @@ public func addOpportunityForReview(storeId: Int32, order: UnsafePointer<Int32>,
 @_cdecl("_review_and_process_opportunities")
 public func reviewAndProcessOpportunities(storeId: Int, systemTime: Int) {
     print("Reviewing process: \(systemTime)")
-    guard priceDataStores[storeId]?
-        .adjacencyList
-        .builder
-        .steps
-        .count ?? 0 > 0 else { return }
+    let steps = priceDataStores[storeId]?.adjacencyList.builder.steps ?? []
+    HTTPSnapshots.storeOpportunities(steps, storeId: storeId, systemTime: systemTime)
+    guard steps.count > 0 else { return }
     priceDataStores[storeId]?
         .adjacencyList
         .builder
@@ -87,18 +86,37 @@ public func createStore() -> Int32 {
     return Int32(PriceDataStoreWrapper.createStore())
 }
 
+@_cdecl("_register_realtime_topics")
+public func registerRealtimeTopics(publish: @escaping RealtimeTopics.Publish, subscribe: @escaping RealtimeTopics.Subscribe) {
+    RealtimeTopics.register(publish: publish, subscribe: subscribe)
+}
+
+@_cdecl("_register_http_snapshots")
+public func registerHTTPSnapshots(store: @escaping HTTPSnapshots.Store) {
+    HTTPSnapshots.register(store: store)
+}
+
+@_cdecl("_resync_realtime_topic")
+public func resyncRealtimeTopic(topic: UnsafePointer<CChar>, length: Int) {
+    RealtimeTopics.resync(String(decoding: UnsafeRawBufferPointer(start: topic, count: length), as: UTF8.self))
+}
+
 @_cdecl("_create_realtime_server_controller")
-public func createRealtimeServerController(storeId: Int, callback: @escaping (@convention(c) (UnsafePointer<CChar>, UInt16, UnsafeRawPointer) -> Void), userData: UnsafeRawPointer) -> Int {
-    let id = controllers.count
-    let controller = RealtimeServerControllerWrapper(id: id, storeId: storeId, userData: userData, callback: callback)
+public func createRealtimeServerController(storeId: Int, callback: @escaping (@convention(c) (UnsafePointer<CChar>, Int, UnsafeRawPointer) -> Void), userData: UnsafeRawPointer, binary: Bool) -> Int {
+    let id = controllers.nextId()
+    let controller = RealtimeServerControllerWrapper(id: id, storeId: storeId, userData: userData, binary: binary, callback: callback)
     controllers[id] = controller
+    controllers.requests.lock()
     controller.loadConfig()
+    controllers.requests.unlock()
     return id
 }
 
 @_cdecl("_close_realtime_server_controller")
 public func closeRealtimeServerController(id: Int) {
-    controllers.removeValue(forKey: id)
+    controllers.requests.lock()
+    defer { controllers.requests.unlock() }
+    controllers.removeValue(forKey: id)?.serverController.close()
 }
 
 @_cdecl("_realtime_server_handle_request")
@@ -109,6 +127,8 @@ public func handleRequest(controllerId: Int, request: UnsafePointer<CChar>, size
     }
     let requestString = String(cString: request).prefix(size)
     
+    controllers.requests.lock()
+    defer { controllers.requests.unlock() }
     controller.handleRequest(request: String(requestString), completion: { error in
         print("Request failed: \(error)")
     })
@@ -132,8 +152,12 @@ public func loadConfigurationFromFile(cName: UnsafePointer<CChar>?, storeId: Int
         
         RealtimeServerControllerWrapper.config = config
         
+        // Pair addresses are static, compute them once instead of on every block
+        PairAddressIndex.shared.load(environment: config.environment)
+        PairAddressIndex.shared.build(queries: config.queries, environment: config.environment)
+        
         if config.headless {
-            let id = controllers.count
+            let id = controllers.nextId()
             let controller = RealtimeServerControllerWrapper(id: id, storeId: storeId) { msg in
                 print(msg)
             }
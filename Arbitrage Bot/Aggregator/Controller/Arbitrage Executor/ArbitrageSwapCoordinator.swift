@@ -10,29 +10,35 @@ import Euler
 
 class ArbitrageSwapCoordinator {
     
-    func coordinateFlashSwapArbitrage(with optimum: BuilderStep.OptimumResult) async throws {
+    func coordinateFlashSwapArbitrage(with optimum: BuilderStep.OptimumResult, systemTime: Int) async throws {
         let contract = Credentials.shared.web3.eth.Contract(type: SwapRouteCoordinator.self)
-        let invocation = contract.startArbitrage(startAmount: optimum.amountIn.asBigUInt,
-                                                 lapExchange: optimum.path[0].intermediary, // First must be the lap
-                                                 steps: optimum.path)
-        let from = Credentials.shared.privateWallet.address
-        let gasPrice = try await Credentials.shared.web3.eth.gasPrice()
-        let nonce = try await Credentials.shared.web3.eth.getTransactionCount(address: from, block: .latest)
-        let tx = invocation.createTransaction(nonce: nonce,
-                                              gasPrice: gasPrice,
-                                              maxFeePerGas: EthereumQuantity(quantity: 20.gwei),
-                                              maxPriorityFeePerGas: nil,
-                                              gasLimit: 1000000,
-                                              from: from,
-                                              value: 0,
-                                              accessList: .init(),
-                                              transactionType: .legacy)
-        guard let signed = try tx?.sign(with: Credentials.shared.privateWallet, chainId: 97) else { return }
+        let gasPrice = try await GasPriceCache.shared.price()
+        let nonce = try await NonceManager.shared.reserve()
+        let template = StartArbitrageTemplate.shared(steps: optimum.path.count)
+        let signed: Bytes
+        do {
+            signed = try template.signedTransaction(startAmount: optimum.amountIn.asBigUInt,
+                                                    lapExchange: optimum.path[0].intermediary, // First must be the lap
+                                                    steps: optimum.path,
+                                                    to: contract.address ?? swapCoordinatorDevAddress,
+                                                    nonce: nonce,
+                                                    gasPrice: gasPrice,
+                                                    gasLimit: 1000000,
+                                                    chainId: 97,
+                                                    key: Credentials.shared.privateWallet)
+        } catch {
+            await NonceManager.shared.release(nonce)
+            throw error
+        }
+        StageTracer.mark(.signed, systemTime: systemTime)
         
         // MARK: - Dispatch Decision
         var response = BotResponse(status: .success, topic: .decision)
-        guard let first = optimum.path.first?.token else { return }
-        guard let token = TokenList.values.first(where: { $0.address == first }) else { return }
+        guard let first = optimum.path.first?.token,
+              let token = TokenList.values.first(where: { $0.address == first }) else {
+            await NonceManager.shared.release(nonce)
+            return
+        }
         response.executedTrade = Trade(timestamp: .now,
                                        token: token.name,
                                        startAmount: (BN(optimum.amountIn) / 1e18).asDouble() ?? 0,
@@ -44,38 +50,26 @@ class ArbitrageSwapCoordinator {
         
         DecisionDataPublisher.shared.publishDecision(decision: response)
         
-        guard RealtimeServerControllerWrapper.config.testingMode == false else { return }
-        
-        let txHash = try await Credentials.shared.web3.eth.sendRawTransaction(transaction: signed)
-        
-        // Let's wait for the transaction to be mined
-        try await Task.sleep(nanoseconds: 10_000_000_000) // 10 second should be enough
-        
-        // Get the transaction fees
-        let receipt = try await Credentials.shared.web3.eth.getTransactionReceipt(transactionHash: txHash)
-        
-        let events = contract.events.compactMap { try! EthereumData(ethereumValue: $0.signature.sha3(.keccak256) )}
-        
-        let logs: [EthereumLogObject] = receipt?
-            .logs
-            .filter { events.contains($0.topics) } ?? []
-        
-        guard let amountOut = logs
-            .first?
-            .data
-            .ethereumValue()
-            .ethereumQuantity?
-            .quantity else { return }
-        
-        
-        if let profit = (BigDouble(amountOut.euler) / 1e18).asDouble() {
-            response.executedTrade?.profit = profit
+        guard RealtimeServerControllerWrapper.config.testingMode == false else {
+            await NonceManager.shared.release(nonce)
+            return
         }
-        response.executedTrade?.txHash = txHash.hex()
-        if let gasUsed = receipt?.cumulativeGasUsed {
-            response.executedTrade?.fees = (BN((gasUsed.quantity * gasPrice.quantity).euler) / 1e18).asDouble()
+        
+        let txHash: EthereumData
+        do {
+            txHash = try await Credentials.shared.web3.eth.sendRawTransaction(raw: EthereumData(signed))
+        } catch {
+            // The node's count is the only truth after a rejection
+            await NonceManager.shared.resync()
+            throw error
         }
         
-        DecisionDataPublisher.shared.publishDecision(decision: response)
+        // The receipt is checked on the next heads, the builder can look for the next trade already
+        let event = EthereumData(Array(contract.events[0].signature.utf8).keccak256())
+        await ReceiptTracker.shared.track(.init(hash: txHash,
+                                                response: response,
+                                                gasPrice: gasPrice,
+                                                event: event,
+                                                environment: Credentials.shared.environment))
     }
 }
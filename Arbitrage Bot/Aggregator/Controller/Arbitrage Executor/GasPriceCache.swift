@@ -0,0 +1,67 @@
+//
+//  GasPriceCache.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+
+/// Gas price of the latest block, refreshed on every new head so trades don't wait for `eth_gasPrice`.
+final class GasPriceCache {
+    static let shared = GasPriceCache()
+
+    private let lock = NSLock()
+    private var price: EthereumQuantity? = nil
+    /// Block of `price`, and the latest block a refresh was started for
+    private var block: UInt64 = 0
+    private var requested: UInt64 = 0
+
+    /// Cached price, `nil` before the first head
+    var current: EthereumQuantity? {
+        lock.lock()
+        defer { lock.unlock() }
+        return price
+    }
+
+    /// Fetches the gas price for `block`. Every store subscribes to new heads, only the first refresh of a block is sent,
+    /// and answers for older blocks are ignored.
+    func refresh(block: UInt64, web3: Web3 = Credentials.shared.web3) {
+        lock.lock()
+        guard block > requested else {
+            lock.unlock()
+            return
+        }
+        requested = block
+        lock.unlock()
+
+        web3.eth.gasPrice { response in
+            guard let price = response.result else {
+                print("Couldn't refresh gas price: \(response.error?.localizedDescription ?? "unknown error")")
+                return
+            }
+            self.lock.lock()
+            defer { self.lock.unlock() }
+            guard block >= self.block else { return }
+            self.block = block
+            self.price = price
+        }
+    }
+
+    /// Forgets the cached price, when switching environment
+    func invalidate() {
+        lock.lock()
+        defer { lock.unlock() }
+        price = nil
+        block = 0
+        requested = 0
+    }
+
+    /// Cached price, or the node's when nothing is cached yet
+    func price(web3: Web3 = Credentials.shared.web3) async throws -> EthereumQuantity {
+        if let current {
+            return current
+        }
+        return try await web3.eth.gasPrice()
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  NonceManager.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import BigInt
+
+/// Hands out the nonces of our wallet without asking the node on every trade.
+///
+/// The pending transaction count is fetched once, then incremented locally. When a transaction is rejected, or the
+/// environment changes, the count is fetched again on the next trade.
+actor NonceManager {
+    static let shared = NonceManager(address: Credentials.shared.privateWallet.address) {
+        (Credentials.shared.web3, Credentials.shared.environment)
+    }
+
+    private let address: EthereumAddress
+    /// Node to sync from, and the environment it belongs to
+    private let source: () -> (Web3, BotRequest.Environment)
+
+    private var next: BigUInt? = nil
+    private var environment: BotRequest.Environment? = nil
+    /// Sync in flight, shared by concurrent callers
+    private var syncing: Task<BigUInt, Error>? = nil
+
+    init(address: EthereumAddress, source: @escaping () -> (Web3, BotRequest.Environment)) {
+        self.address = address
+        self.source = source
+    }
+
+    /// Reserves the next nonce. Only waits for the node when the count isn't known yet.
+    func reserve() async throws -> EthereumQuantity {
+        let nonce = try await load()
+        next = nonce + 1
+        return EthereumQuantity(quantity: nonce)
+    }
+
+    /// Gives back a nonce that wasn't broadcast. Only the last reserved nonce can be given back, otherwise there would be a gap.
+    func release(_ nonce: EthereumQuantity) {
+        guard let next, next == nonce.quantity + 1 else { return }
+        self.next = nonce.quantity
+    }
+
+    /// Forgets the local count, after a transaction was rejected (nonce too low, replaced...)
+    func resync() {
+        next = nil
+        syncing = nil
+    }
+
+    /// Fetches the count ahead of the first trade
+    func prefetch() async {
+        _ = try? await load()
+    }
+
+    /// Next nonce, synced from the node if needed
+    private func load() async throws -> BigUInt {
+        let (web3, environment) = source()
+        if environment != self.environment {
+            resync()
+            self.environment = environment
+        }
+        if let next {
+            return next
+        }
+        let synced = try await sync(web3: web3)
+        // Another caller may have synced, and reserved, while we were waiting
+        if next == nil {
+            next = synced
+        }
+        return next!
+    }
+
+    private func sync(web3: Web3) async throws -> BigUInt {
+        if let syncing {
+            return try await syncing.value
+        }
+        let address = self.address
+        let task = Task {
+            try await web3.eth.getTransactionCount(address: address, block: .pending).quantity
+        }
+        syncing = task
+        defer {
+            if syncing == task {
+                syncing = nil
+            }
+        }
+        return try await task.value
+    }
+}
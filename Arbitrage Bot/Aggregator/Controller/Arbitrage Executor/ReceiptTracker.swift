@@ -0,0 +1,118 @@
+//
+//  ReceiptTracker.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Euler
+
+/// Follows the transactions we sent until they are mined.
+///
+/// On every new head, the receipts of all pending transactions are fetched in a single batch. Mined trades are published
+/// again with their actual profit and fees, so the coordinator doesn't have to wait for them.
+actor ReceiptTracker {
+    static let shared = ReceiptTracker()
+
+    /// Blocks to wait for a receipt, before considering the transaction dropped
+    static let maximumBlocks = 50
+
+    struct Pending {
+        let hash: EthereumData
+        var response: BotResponse
+        let gasPrice: EthereumQuantity
+        /// Topic of the event carrying the amount out
+        let event: EthereumData
+        let environment: BotRequest.Environment
+        var blocks = 0
+    }
+
+    private var pending = [EthereumData: Pending]()
+    /// Transactions whose receipts are being fetched. `onHead` suspends while fetching, so the next head must skip them.
+    private var inFlight = Set<EthereumData>()
+    private var lastBlock: UInt64 = 0
+
+    /// Web3 of each environment, `Credentials` by default
+    private let web3: (BotRequest.Environment) -> Web3
+    private let publish: (BotResponse) -> Void
+
+    init(web3: @escaping (BotRequest.Environment) -> Web3 = { Credentials.shared.web3(for: $0) },
+         publish: @escaping (BotResponse) -> Void = { DecisionDataPublisher.shared.publishDecision(decision: $0) }) {
+        self.web3 = web3
+        self.publish = publish
+    }
+
+    var count: Int {
+        pending.count
+    }
+
+    func track(_ transaction: Pending) {
+        pending[transaction.hash] = transaction
+    }
+
+    /// Checks the receipts of the pending transactions. Every store subscribes to new heads, only the first call of a block is used.
+    func onHead(block: UInt64) async {
+        guard block > lastBlock, !pending.isEmpty else { return }
+        lastBlock = block
+
+        let transactions = pending.values.filter { !inFlight.contains($0.hash) }
+        inFlight.formUnion(transactions.map(\.hash))
+        defer { inFlight.subtract(transactions.map(\.hash)) }
+
+        let environments = Dictionary(grouping: transactions, by: \.environment)
+        for (environment, transactions) in environments {
+            let receipts = await fetchReceipts(transactions.map(\.hash), web3: web3(environment))
+            for (transaction, receipt) in zip(transactions, receipts) {
+                if let receipt {
+                    // Only the call that removes it publishes the trade
+                    guard let transaction = pending.removeValue(forKey: transaction.hash) else { continue }
+                    publish(settle(transaction, receipt: receipt))
+                } else if var transaction = pending[transaction.hash] {
+                    transaction.blocks += 1
+                    guard transaction.blocks >= Self.maximumBlocks else {
+                        pending[transaction.hash] = transaction
+                        continue
+                    }
+                    print("Transaction \(transaction.hash.hex()) wasn't mined after \(Self.maximumBlocks) blocks, dropping it")
+                    pending[transaction.hash] = nil
+                    // Its nonce may never have been used
+                    await NonceManager.shared.resync()
+                }
+            }
+        }
+    }
+
+    /// Decision with the actual profit and fees
+    private func settle(_ transaction: Pending, receipt: EthereumTransactionReceiptObject) -> BotResponse {
+        var response = transaction.response
+        response.executedTrade?.txHash = transaction.hash.hex()
+        response.executedTrade?.fees = (BN((receipt.gasUsed.quantity * transaction.gasPrice.quantity).euler) / 1e18).asDouble()
+
+        let amountOut = receipt.logs
+            .first { $0.topics.first == transaction.event }?
+            .data
+            .ethereumValue()
+            .ethereumQuantity?
+            .quantity
+        if let amountOut, let profit = (BigDouble(amountOut.euler) / 1e18).asDouble() {
+            response.executedTrade?.profit = profit
+        } else if receipt.status?.quantity == 0 {
+            // Reverted
+            response.executedTrade?.profit = 0
+        }
+        return response
+    }
+
+    /// Receipts in the order of `hashes`, `nil` for the transactions that aren't mined yet
+    private func fetchReceipts(_ hashes: [EthereumData], web3: Web3) async -> [EthereumTransactionReceiptObject?] {
+        let requests = hashes.map { hash in
+            BasicRPCRequest(id: web3.rpcId, jsonrpc: Web3.jsonrpc, method: "eth_getTransactionReceipt", params: [hash])
+        }
+        return await withCheckedContinuation { continuation in
+            web3.provider.send(batch: requests) { (responses: [Web3Response<EthereumTransactionReceiptObject?>]) in
+                continuation.resume(returning: responses.map { $0.result ?? nil })
+            }
+        }
+    }
+}
@@ -104,16 +104,31 @@ final class UniswapV2: Exchange {
         return (token0, token1)
     }
 
+    /// UniswapV2 Pair init code hash
+    var pairInitCodeHash: [UInt8]? {
+        UniswapV2PairHash[UniType(rawValue: self.name) ?? .uniswap]
+    }
+
     func pairFor(factory: EthereumAddress, tokenA: EthereumAddress, tokenB: EthereumAddress) throws -> EthereumAddress {
+        if let pair = PairAddressIndex.shared[factory, tokenA, tokenB] {
+            return pair
+        }
+        let pair = try computePairAddress(factory: factory, tokenA: tokenA, tokenB: tokenB)
+        PairAddressIndex.shared[factory, tokenA, tokenB] = pair
+        return pair
+    }
+
+    /// CREATE2 derivation of the pair address. Prefer `pairFor`, which goes through the `PairAddressIndex`.
+    func computePairAddress(factory: EthereumAddress, tokenA: EthereumAddress, tokenB: EthereumAddress) throws -> EthereumAddress {
         let (token0, token1) = try sortTokens(tokenA: tokenA, tokenB: tokenB)
-        guard let initCodeHash = UniswapV2PairHash[UniType(rawValue: self.name) ?? .uniswap] else { // UniswapV2 Pair init code hash
+        guard let initCodeHash = pairInitCodeHash else {
             throw UniswapV2Error.pairForEncodeIssue
         }
 
         var concat = token0.rawAddress
         concat.append(contentsOf: token1.rawAddress)
 
-        let salt = concat.sha3(.keccak256)
+        let salt = concat.keccak256()
 
         let create2 = try EthereumUtils.getCreate2Address(from: factory, salt: salt, initCodeHash: initCodeHash)
 
@@ -126,28 +141,21 @@ final class UniswapV2: Exchange {
         tokenB: EthereumAddress
     ) async throws -> (Euler.BigInt, Euler.BigInt) {
         let computedPair = try pairFor(factory: factory, tokenA: tokenA, tokenB: tokenB)
-        let pair = Credentials.shared.web3.eth.Contract(type: UniswapV2Pair.self, address: computedPair)
-        let invocation: [String: Any] = try await withCheckedThrowingContinuation { continuation in
-            pair.getReserves().call { result, e in
-                if let error = e {
-                    print("Pair \(tokenA.hex(eip55: false))-\(tokenB.hex(eip55: false)) does not exist on \(factory.hex(eip55: false)))")
-                    print("Pair address: \(computedPair.hex(eip55: false))")
-                    return continuation.resume(throwing: error)
-                }
-                continuation.resume(returning: result ?? [:])
-            }
-        }
-
-        guard let reserve0 = invocation["reserve0"] as? Web3BigUInt else {
-            throw UniswapV2Error.getReserveIssue(computedPair)
-        }
-        guard  let reserve1 = invocation["reserve1"] as? Web3BigUInt else {
+        let call = EthereumCall(to: computedPair, data: EthereumData(UniswapV2Pair.Reserves.selector))
+        let reserves: UniswapV2Pair.Reserves
+        do {
+            let data = try await Credentials.shared.web3.eth.call(call: call, block: .latest)
+            reserves = try StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: data.bytes)
+        } catch is StaticABIDecoder.Error {
+            // Calling an address without code returns an empty result
+            print("Pair \(tokenA.hex(eip55: false))-\(tokenB.hex(eip55: false)) does not exist on \(factory.hex(eip55: false)))")
+            print("Pair address: \(computedPair.hex(eip55: false))")
             throw UniswapV2Error.getReserveIssue(computedPair)
         }
 
         let (token0, _) = try sortTokens(tokenA: tokenA, tokenB: tokenB)
 
-        return tokenA == token0 ? (reserve0.euler, reserve1.euler) : (reserve1.euler, reserve0.euler);
+        return tokenA == token0 ? (reserves.reserve0.euler, reserves.reserve1.euler) : (reserves.reserve1.euler, reserves.reserve0.euler);
     }
 
     func getAmountOut(
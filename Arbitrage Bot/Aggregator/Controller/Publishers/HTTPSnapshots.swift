@@ -0,0 +1,97 @@
+//
+//  HTTPSnapshots.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+
+/// Bodies of the GET endpoints of the realtime server, for dashboards and scripts that poll the current state.
+///
+/// Each body is serialized once per block and handed to the server, which answers every request from it with an ETag
+/// (a hash of the body), so a poll costs no encoding, and nothing at all when it gets a 304. Only available when
+/// running behind the uWS server.
+enum HTTPSnapshots {
+    typealias Store = @convention(c) (UnsafePointer<CChar>, Int, UnsafePointer<CChar>, Int) -> Void
+
+    private static var storeFunction: Store? = nil
+
+    static var isAvailable: Bool {
+        storeFunction != nil
+    }
+
+    static func register(store: @escaping Store) {
+        storeFunction = store
+    }
+
+    // MARK: - Endpoints
+
+    /// Rates matrix of the last block, row by row
+    static let matrix = "/matrix"
+    /// Tokens of the matrix, in order
+    static let tokens = "/tokens"
+    /// Routes sent for review on the last block
+    static let opportunities = "/opportunities"
+
+    struct Matrix: Encodable {
+        var storeId: Int
+        var systemTime: UInt32
+        var tokens: [String]
+        var rates: [Double]
+    }
+
+    struct Opportunities: Encodable {
+        var storeId: Int
+        var systemTime: Int
+        var routes: [[Token]]
+    }
+
+    private static let encoder: JSONEncoder = {
+        let encoder = JSONEncoder()
+        // Missing edges are infinite
+        encoder.nonConformingFloatEncodingStrategy = .convertToString(positiveInfinity: "Infinity", negativeInfinity: "-Infinity", nan: "NaN")
+        return encoder
+    }()
+
+    private static let lock = NSLock()
+    private static var storedTokens = [Int: [Token]]()
+
+    static func storeMatrix(_ rates: [Double], tokens: [Token], storeId: Int, systemTime: UInt32) {
+        guard isAvailable else { return }
+        store(Matrix(storeId: storeId, systemTime: systemTime, tokens: tokens.map { $0.address.hex(eip55: false) }, rates: rates), at: matrix)
+
+        // Tokens only change when pairs are added
+        lock.lock()
+        let changed = storedTokens[storeId] != tokens
+        storedTokens[storeId] = tokens
+        lock.unlock()
+        if changed {
+            store(tokens, at: self.tokens)
+        }
+    }
+
+    static func storeOpportunities(_ steps: [BuilderStep], storeId: Int, systemTime: Int) {
+        guard isAvailable else { return }
+        let routes = steps.map { step in
+            var route = [step.tokenA]
+            var current: BuilderStep? = step
+            while let step = current {
+                route.append(step.tokenB)
+                current = step.next
+            }
+            return route
+        }
+        store(Opportunities(storeId: storeId, systemTime: systemTime, routes: routes), at: opportunities)
+    }
+
+    private static func store<T: Encodable>(_ value: T, at path: String) {
+        guard let storeFunction, let body = try? encoder.encode(value) else { return }
+        path.withCString { cPath in
+            body.withUnsafeBytes { buffer in
+                guard let base = buffer.bindMemory(to: CChar.self).baseAddress else { return }
+                storeFunction(cPath, strlen(cPath), base, buffer.count)
+            }
+        }
+    }
+}
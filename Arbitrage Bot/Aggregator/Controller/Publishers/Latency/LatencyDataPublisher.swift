@@ -0,0 +1,27 @@
+//
+//  LatencyDataPublisher.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import OpenCombine
+
+class LatencyDataPublisher {
+    static let shared = LatencyDataPublisher()
+
+    let subject = PassthroughSubject<BotResponse, Never>()
+
+    func receive<S>(subscriber: S) where S: Subscriber, Never == S.Failure, BotResponse == S.Input {
+        subject.subscribe(subscriber)
+    }
+
+    /// Publishes the histograms of every stage, and the latency of the RPC endpoints
+    func publishReport() {
+        var response = BotResponse(status: .success, topic: .latency)
+        response.latency = StageTracer.report()
+        response.latency?.endpoints = (Credentials.shared.web3.provider as? Web3ProviderPool)?.stats
+        subject.send(response)
+    }
+}
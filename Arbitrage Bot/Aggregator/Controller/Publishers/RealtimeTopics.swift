@@ -0,0 +1,195 @@
+//
+//  RealtimeTopics.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import OpenCombine
+
+/// Topics of the realtime server.
+///
+/// Updates are serialized once and published with `uws_publish` to every client subscribed to their topic, instead of
+/// being encoded and sent by each controller. Only available when running behind the uWS server, headless controllers
+/// keep using their callback.
+///
+/// Clients of the binary protocol subscribe to the `binary(_:)` variant of the topics that have a `BinaryFrame`. Each
+/// encoding is only produced while some clients use it.
+enum RealtimeTopics {
+    typealias Publish = @convention(c) (UnsafePointer<CChar>, Int, UnsafePointer<CChar>, Int, Bool) -> Void
+    typealias Subscribe = @convention(c) (UnsafeRawPointer, UnsafePointer<CChar>, Int, Bool) -> Void
+
+    private static var publishFunction: Publish? = nil
+    private static var subscribeFunction: Subscribe? = nil
+
+    static var isAvailable: Bool {
+        publishFunction != nil
+    }
+
+    static func register(publish: @escaping Publish, subscribe: @escaping Subscribe) {
+        publishFunction = publish
+        subscribeFunction = subscribe
+    }
+
+    /// Goes back to headless mode, where controllers use their callback
+    static func unregister() {
+        publishFunction = nil
+        subscribeFunction = nil
+    }
+
+    // MARK: - Topics
+
+    static let decision = "decision"
+    static let latency = "latency"
+
+    /// Quotes of a pair on an exchange
+    static func price(_ subscription: PriceDataActiveSubscription) -> String {
+        "price/\(subscription.environment.rawValue)/\(subscription.exchangeKey)/\(subscription.pair.tokenA.address.hex(eip55: false))/\(subscription.pair.tokenB.address.hex(eip55: false))"
+    }
+
+    /// Rates matrix of a store, binary only
+    static func matrix(storeId: Int) -> String {
+        binary("matrix/\(storeId)")
+    }
+
+    /// Same topic, with binary frames
+    static func binary(_ topic: String) -> String {
+        "bin:" + topic
+    }
+
+    // MARK: - Clients
+
+    private static let lock = NSLock()
+    private static var jsonClients = 0
+    private static var binaryClients = 0
+
+    static func connect(binary: Bool) {
+        lock.lock()
+        defer { lock.unlock() }
+        if binary {
+            binaryClients += 1
+        } else {
+            jsonClients += 1
+        }
+    }
+
+    static func disconnect(binary: Bool) {
+        lock.lock()
+        defer { lock.unlock() }
+        if binary {
+            binaryClients -= 1
+        } else {
+            jsonClients -= 1
+        }
+    }
+
+    static var hasBinaryClients: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return binaryClients > 0
+    }
+
+    private static var hasJSONClients: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return jsonClients > 0
+    }
+
+    // MARK: - Publishing
+
+    /// Publishes `response` to the JSON clients of `topic`, and to the binary ones when it has a binary form
+    static func publish(_ response: BotResponse, to topic: String) {
+        if hasJSONClients {
+            publishJSON(response, to: topic)
+        }
+        if hasBinaryClients, let frame = BinaryFrame.encode(response) {
+            publish(frame, to: binary(topic))
+        }
+    }
+
+    /// Publishes `response` as JSON, whatever the protocol of the clients
+    static func publishJSON(_ response: BotResponse, to topic: String) {
+        guard let publishFunction, let json = try? response.toJSON() else { return }
+        topic.withCString { cTopic in
+            json.withCString { cJSON in
+                publishFunction(cTopic, strlen(cTopic), cJSON, strlen(cJSON), false)
+            }
+        }
+    }
+
+    static func publish(_ frame: Bytes, to topic: String) {
+        guard let publishFunction else { return }
+        topic.withCString { cTopic in
+            frame.withUnsafeBufferPointer { buffer in
+                buffer.withMemoryRebound(to: CChar.self) { cFrame in
+                    guard let base = cFrame.baseAddress else { return }
+                    publishFunction(cTopic, strlen(cTopic), base, cFrame.count, true)
+                }
+            }
+        }
+    }
+
+    static func subscribe(_ socket: UnsafeRawPointer, to topic: String, _ subscribe: Bool = true) {
+        guard let subscribeFunction else { return }
+        topic.withCString { cTopic in
+            subscribeFunction(socket, cTopic, strlen(cTopic), subscribe)
+        }
+    }
+
+    /// A slow socket missed updates of `topic` that can't be conflated, see `conflation_t`
+    static func resync(_ topic: String) {
+        for (storeId, store) in priceDataStores where matrix(storeId: storeId) == topic {
+            store.resyncMatrix()
+        }
+    }
+
+    // MARK: - Fan-out
+
+    private static let attachLock = NSLock()
+    private static var attachedStores = Set<Int>()
+    private static var fanouts = [AnyObject]()
+
+    /// Publishes the quotes of `storeId`, the decisions and the latency reports to their topics. Only done once per store.
+    static func attach(storeId: Int) {
+        attachLock.lock()
+        defer { attachLock.unlock() }
+        guard isAvailable, let store = priceDataStores[storeId], attachedStores.insert(storeId).inserted else { return }
+
+        let prices = PriceFanout(state: store.publisher.priceDataSubscription.subscriptions)
+        store.publisher.receive(subscriber: prices)
+        fanouts.append(prices)
+
+        guard fanouts.count == 1 else { return }
+        let decisions = DecisionDataSubscriber { publish($0, to: decision) }
+        DecisionDataPublisher.shared.receive(subscriber: decisions)
+        // Latency reports have no binary form, every client reads them as JSON
+        let reports = LatencyDataSubscriber { publishJSON($0, to: latency) }
+        LatencyDataPublisher.shared.receive(subscriber: reports)
+        fanouts.append(contentsOf: [decisions, reports])
+    }
+}
+
+/// Publishes every quote of a store to the topic of its subscription
+private final class PriceFanout: Subscriber {
+    typealias Input = (BotResponse, Int)
+    typealias Failure = Error
+
+    let state: PriceDataSubscriptionState
+
+    init(state: PriceDataSubscriptionState) {
+        self.state = state
+    }
+
+    func receive(subscription: Subscription) {
+        subscription.request(.unlimited)
+    }
+
+    func receive(_ input: (BotResponse, Int)) -> Subscribers.Demand {
+        guard input.0.shouldSilent == false, let topic = state.topics[input.1] else { return .none }
+        RealtimeTopics.publish(input.0, to: topic)
+        return .none
+    }
+
+    func receive(completion: Subscribers.Completion<Error>) {}
+}
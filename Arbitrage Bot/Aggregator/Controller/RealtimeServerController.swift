@@ -13,31 +13,59 @@ class RealtimeServerController {
     var priceSubscriber: PriceDataSubscriber
     
     var decisionSubscriber: DecisionDataSubscriber
+    var latencySubscriber: LatencyDataSubscriber
+    var latencyReports = false
     var storeId: Int
     var id: Int
+    /// Handle of the client's uWS socket. When set, updates are received through `RealtimeTopics` instead of this controller's subscribers.
+    let socket: UnsafeRawPointer?
+    /// The client negotiated the binary protocol: streamed updates are `BinaryFrame`s, answers stay JSON
+    let binary: Bool
+    var matrixStream = false
     
-    public init(id: Int, storeId: Int, callback: @escaping (String) -> Void) {
+    private var usesTopics: Bool {
+        socket != nil && RealtimeTopics.isAvailable
+    }
+    
+    public init(id: Int, storeId: Int, socket: UnsafeRawPointer? = nil, binary: Bool = false, callback: @escaping (String) -> Void) {
         self.id = id
         self.storeId = storeId
+        self.socket = socket
+        self.binary = binary
         self.callback = callback
         
         self.decisionSubscriber = DecisionDataSubscriber { res in
             guard let str = try? res.toJSON() else { return }
-            if controllers.keys.contains(id) {
+            if controllers.contains(id) {
+                callback(str)
+            }
+        }
+        self.latencySubscriber = LatencyDataSubscriber { res in
+            guard let str = try? res.toJSON() else { return }
+            if let controller = controllers[id], controller.serverController.latencyReports {
                 callback(str)
             }
         }
         self.priceSubscriber = PriceDataSubscriber(storeId: storeId) { res in
             guard res.shouldSilent == false else { return }
             guard let str = try? res.toJSON() else { return }
-            if controllers.keys.contains(id) {
+            if controllers.contains(id) {
                 callback(str)
             }
         }
         
         
+        if let socket, RealtimeTopics.isAvailable {
+            // Updates are encoded once and published to the subscribed sockets
+            RealtimeTopics.attach(storeId: storeId)
+            RealtimeTopics.connect(binary: binary)
+            RealtimeTopics.subscribe(socket, to: binary ? RealtimeTopics.binary(RealtimeTopics.decision) : RealtimeTopics.decision)
+            return
+        }
+        
         // Publishers
         DecisionDataPublisher.shared.receive(subscriber: decisionSubscriber)
+        LatencyDataPublisher.shared.receive(subscriber: latencySubscriber)
         priceDataStores[storeId]?.publisher.receive(subscriber: priceSubscriber)
     }
 
@@ -58,6 +86,10 @@ class RealtimeServerController {
             response = buy(request: botRequest)
         case .environment:
             response = environment(request: botRequest)
+        case .latency:
+            response = latency(request: botRequest)
+        case .matrix:
+            response = matrix(request: botRequest)
         case .none:
             response = BotResponse(status: .success, topic: .none)
         }
@@ -79,10 +111,16 @@ class RealtimeServerController {
         
         if request.type == .subscribe || request.type == .silent {
             self.priceSubscriber.activeSubscriptions.append(activeSub)
+            if let socket, usesTopics, !activeSub.silent {
+                RealtimeTopics.subscribe(socket, to: priceTopic(activeSub))
+            }
         } else {
             self.priceSubscriber.activeSubscriptions.removeAll { sub in
                 activeSub == sub
             }
+            if let socket, usesTopics {
+                RealtimeTopics.subscribe(socket, to: priceTopic(activeSub), false)
+            }
             Task {
                 // Clear the pair price
                 await priceDataStores[storeId]?
@@ -104,8 +142,61 @@ class RealtimeServerController {
         return BotResponse(status: .success, topic: .decision)
     }
     
+    func latency(request: BotRequest) -> BotResponse {
+        switch request.type {
+        case .subscribe:
+            latencyReports = true
+            if let socket, usesTopics {
+                RealtimeTopics.subscribe(socket, to: RealtimeTopics.latency)
+            }
+        case .unsubscribe:
+            latencyReports = false
+            if let socket, usesTopics {
+                RealtimeTopics.subscribe(socket, to: RealtimeTopics.latency, false)
+            }
+        case .reset:
+            StageTracer.reset()
+        default:
+            break
+        }
+        return BotResponse(status: .success, topic: .latency)
+    }
+    
+    private func priceTopic(_ subscription: PriceDataActiveSubscription) -> String {
+        binary ? RealtimeTopics.binary(RealtimeTopics.price(subscription)) : RealtimeTopics.price(subscription)
+    }
+    
+    /// Streams the rates matrix of the store, as `BinaryFrame` snapshots and deltas
+    func matrix(request: BotRequest) -> BotResponse {
+        guard let socket, usesTopics, binary, let store = priceDataStores[storeId] else {
+            return BotResponse(status: .error, topic: .matrix, error: "The matrix stream needs the binary protocol")
+        }
+        let subscribe = request.type == .subscribe
+        guard subscribe != matrixStream else {
+            return BotResponse(status: .success, topic: .matrix)
+        }
+        matrixStream = subscribe
+        RealtimeTopics.subscribe(socket, to: RealtimeTopics.matrix(storeId: storeId), subscribe)
+        store.subscribeToMatrix(subscribe)
+        return BotResponse(status: .success, topic: .matrix)
+    }
+    
+    /// The socket closed
+    func close() {
+        guard usesTopics else { return }
+        if matrixStream {
+            priceDataStores[storeId]?.subscribeToMatrix(false)
+        }
+        RealtimeTopics.disconnect(binary: binary)
+    }
+    
     func reset(request: BotRequest) -> BotResponse {
         // Restart the server
+        if let socket, usesTopics {
+            for subscription in priceSubscriber.activeSubscriptions {
+                RealtimeTopics.subscribe(socket, to: priceTopic(subscription), false)
+            }
+        }
         self.priceSubscriber.activeSubscriptions.removeAll()
         priceDataStores[storeId]?
             .publisher
@@ -159,11 +250,10 @@ class RealtimeServerControllerWrapper {
         }
     }
     
-    convenience init(id: Int, storeId: Int, userData: UnsafeRawPointer, callback: @escaping (@convention(c) (UnsafePointer<CChar>, UInt16, UnsafeRawPointer) -> Void)) {
-        let serverController = RealtimeServerController(id: id, storeId: storeId, callback: { message in
-            let message = message
+    convenience init(id: Int, storeId: Int, userData: UnsafeRawPointer, binary: Bool, callback: @escaping (@convention(c) (UnsafePointer<CChar>, Int, UnsafeRawPointer) -> Void)) {
+        let serverController = RealtimeServerController(id: id, storeId: storeId, socket: userData, binary: binary, callback: { message in
             message.withCString { cMessage in
-                callback(cMessage, UInt16(message.count), userData)
+                callback(cMessage, strlen(cMessage), userData)
             }
         })
         
@@ -185,5 +275,51 @@ class RealtimeServerControllerWrapper {
 }
 
 
-// To mimic a reference to the class we can use a Dictionary
-var controllers: [Int: RealtimeServerControllerWrapper] = [:]
+/// Controllers by id. Every server thread opens and closes sockets, see `start_server_threads`.
+final class ControllerRegistry {
+    private let lock = NSLock()
+    private var controllers = [Int: RealtimeServerControllerWrapper]()
+    private var lastId = -1
+    
+    /// Held while handling a request, as they all update the subscriptions of the shared stores
+    let requests = NSLock()
+    
+    /// Ids are never reused, so that a late message of a closed socket can't reach a new one
+    func nextId() -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        lastId += 1
+        return lastId
+    }
+    
+    subscript(id: Int) -> RealtimeServerControllerWrapper? {
+        get {
+            lock.lock()
+            defer { lock.unlock() }
+            return controllers[id]
+        }
+        set {
+            lock.lock()
+            defer { lock.unlock() }
+            controllers[id] = newValue
+        }
+    }
+    
+    func contains(_ id: Int) -> Bool {
+        self[id] != nil
+    }
+    
+    func removeValue(forKey id: Int) -> RealtimeServerControllerWrapper? {
+        lock.lock()
+        defer { lock.unlock() }
+        return controllers.removeValue(forKey: id)
+    }
+    
+    var values: [RealtimeServerControllerWrapper] {
+        lock.lock()
+        defer { lock.unlock() }
+        return Array(controllers.values)
+    }
+}
+
+let controllers = ControllerRegistry()
@@ -0,0 +1,32 @@
+//
+//  LatencySubscriber.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import OpenCombine
+
+/// Receives the stage latency reports of `LatencyDataPublisher`
+class LatencyDataSubscriber: Subscriber {
+    typealias Input = BotResponse
+    typealias Failure = Never
+    
+    let receiveValue: (BotResponse) -> Void
+    
+    init(_ receiveValue: @escaping (BotResponse) -> Void) {
+        self.receiveValue = receiveValue
+    }
+    
+    func receive(subscription: Subscription) {
+        subscription.request(.unlimited)
+    }
+    
+    func receive(_ input: BotResponse) -> Subscribers.Demand {
+        receiveValue(input)
+        return .unlimited
+    }
+    
+    func receive(completion: Subscribers.Completion<Never>) {}
+}
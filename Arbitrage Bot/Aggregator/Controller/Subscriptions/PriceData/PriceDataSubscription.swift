@@ -5,6 +5,7 @@
 //  Created by Arthur Guiot on 21/06/2023.
 //
 
+import Foundation
 import OpenCombine
 
 class PriceDataSubscription {
@@ -14,21 +15,41 @@ class PriceDataSubscription {
     
     internal var decisions = false
     internal var storeID: Int
+    
+    /// `Sync` log listeners, per environment, used when reserves are updated from events
+    private var syncListeners = [BotRequest.Environment: SyncLogListener]()
+    /// Guards `syncListeners`. Blocks are dispatched from their own task, so overlapping blocks would otherwise create
+    /// and drain the listeners concurrently.
+    private let syncLock = NSLock()
+    
     init(storeId: Int, callback: @escaping (Result<(BotResponse, Int), Error>) -> Void) {
         self.storeID = storeId
         self.callback = callback
         subscribeToNewHeads()
     }
     
-    func dispatch(with type: PriceDataSubscriptionType, systemTime: UInt32) {
-        guard subscriptions.activeSubscriptions.count > 0 else { return }
+    func dispatch(with type: PriceDataSubscriptionType, systemTime: UInt32, head: FastJSON.NewHead? = nil) {
+        guard subscriptions.activeSubscriptions.count > 0 else {
+            Metrics.increment(.ticksSkipped)
+            return
+        }
         Task {
             let clock = ContinuousClock()
             
             var responses = [(BotResponse, Int)]()
             
             let time = await clock.measure {
-                responses = await self.subscriptions.meanPrice(for: .ethereumBlock, storeId: storeID)
+                if RealtimeServerControllerWrapper.config.reserveUpdates == .events, let reserves = self.syncedReserves(through: head?.number) {
+                    responses = await self.subscriptions.meanPrice(for: .ethereumBlock, storeId: storeID, reserves: reserves)
+                } else {
+                    responses = await self.subscriptions.meanPrice(for: .ethereumBlock, storeId: storeID)
+                }
+            }
+            
+            StageTracer.mark(.reserves, systemTime: Int(systemTime))
+            
+            if let head, let capture = ReserveCapture.shared, let store = priceDataStores[storeID] {
+                await capture.record(block: head.number, timestamp: head.timestamp, from: store.adjacencyList)
             }
             
             for var response in responses {
@@ -45,15 +66,47 @@ class PriceDataSubscription {
         }
     }
     
+    /// Reserves of the pools that emitted a `Sync` event since the last block, up to `block`, or `nil` when every pair has
+    /// to be fetched (first block, tracked pairs changed, lost subscription or chain reorganization).
+    private func syncedReserves(through block: UInt64?) -> [PairAddressIndex.Key: (UInt256, UInt256)]? {
+        syncLock.lock()
+        defer { syncLock.unlock() }
+        
+        let tracked = subscriptions.trackedPairs(for: .ethereumBlock)
+        var needsRefresh = false
+        for environment in Set(tracked.keys).union(syncListeners.keys) {
+            let listener = syncListeners[environment] ?? SyncLogListener(web3: Credentials.shared.web3(for: environment))
+            syncListeners[environment] = listener
+            needsRefresh = listener.track(pairs: tracked[environment] ?? []) || needsRefresh
+        }
+        
+        var reserves = [PairAddressIndex.Key: (UInt256, UInt256)]()
+        for listener in syncListeners.values {
+            guard let updates = listener.drain(through: block) else {
+                needsRefresh = true
+                continue
+            }
+            reserves.merge(updates) { _, new in new }
+        }
+        return needsRefresh ? nil : reserves
+    }
+    
     private func subscribeToNewHeads() {
         do {
             try web3.eth.subscribeToNewHeads { resp in
                 print("Listening to new heads")
-            } onEvent: { resp in
-                guard let blockNumber = resp.result?.number?.quantity else { return }
-                print("New block: \(blockNumber)")
-                let time = Int(blockNumber)
-                self.dispatch(with: .ethereumBlock, systemTime: UInt32(time))
+            } onHead: { head in
+                let systemTime = UInt32(truncatingIfNeeded: head.number)
+                StageTracer.mark(.head, systemTime: Int(systemTime))
+                print("New block: \(head.number)")
+                // Keep the trade path free of round trips
+                GasPriceCache.shared.refresh(block: head.number)
+                Task {
+                    await NonceManager.shared.prefetch()
+                    await ReceiptTracker.shared.onHead(block: head.number)
+                }
+                LatencyDataPublisher.shared.publishReport()
+                self.dispatch(with: .ethereumBlock, systemTime: systemTime, head: head)
             }
         } catch {
             print("Error: \(error.localizedDescription)")
@@ -26,21 +26,69 @@ final class PriceDataSubscriptionState {
             if oldValue.count != activeSubscriptions.count {
                 print("Updated subscriber count: \(activeSubscriptions.count)")
             }
+            topics = activeSubscriptions.reduce(into: [:]) { topics, subscription in
+                topics[subscription.hashValue] = RealtimeTopics.price(subscription)
+            }
+        }
+    }
+    
+    /// Realtime topic of each active subscription, by hash
+    private(set) var topics = [Int: String]()
+    
+    let reserveFetcher = ReserveBatchFetcher()
+    
+    private typealias Sub = (exchange: any Exchange, environment: BotRequest.Environment, pair: PairInfo, hash: Int, silent: Bool)
+    
+    private func subscriptions(for type: PriceDataSubscriptionType) -> [Sub] {
+        activeSubscriptions.compactMap { activeSubscription in
+            guard let adapter = ExchangesList.shared[activeSubscription.environment, activeSubscription.exchangeKey] else { return nil }
+            guard adapter.trigger == type else { return nil }
+            return (adapter, activeSubscription.environment, activeSubscription.pair, activeSubscription.hashValue, activeSubscription.silent)
+        }
+    }
+    
+    private func reserveRequests(for subs: [Sub]) -> [ReserveBatchFetcher.Request] {
+        subs.compactMap { sub in
+            guard let exchange = sub.exchange as? UniswapV2 else { return nil }
+            return ReserveBatchFetcher.Request(id: sub.hash, exchange: exchange, environment: sub.environment, pair: sub.pair)
         }
     }
     
+    /// Pool addresses backing the active UniswapV2 subscriptions, per environment
+    func trackedPairs(for type: PriceDataSubscriptionType) -> [BotRequest.Environment: Set<EthereumAddress>] {
+        reserveRequests(for: subscriptions(for: type)).reduce(into: [:]) { result, request in
+            let key = request.key
+            guard let pair = try? request.exchange.pairFor(factory: key.factory, tokenA: key.token0, tokenB: key.token1) else { return }
+            result[request.environment, default: []].insert(pair)
+        }
+    }
+    
+    /// Computes the price of every active subscription
     func meanPrice(for type: PriceDataSubscriptionType, storeId: Int) async -> [(BotResponse, Int)] {
+        let subs = subscriptions(for: type)
+        
+        // Fetch all the UniswapV2 reserves at once, instead of one `getReserves` per subscription
+        let requests = reserveRequests(for: subs)
+        let metas: [Int: Any] = requests.isEmpty ? [:] : await reserveFetcher.fetch(requests)
+        
+        return await meanPrice(for: subs, metas: metas, storeId: storeId)
+    }
+    
+    /// Computes the price of the UniswapV2 subscriptions whose pool reserves are given, other subscriptions are left untouched
+    func meanPrice(for type: PriceDataSubscriptionType, storeId: Int, reserves: [PairAddressIndex.Key: (UInt256, UInt256)]) async -> [(BotResponse, Int)] {
+        guard reserves.count > 0 else { return [] }
+        let subs = subscriptions(for: type)
+        let metas: [Int: Any] = ReserveBatchFetcher.metas(for: reserveRequests(for: subs), reserves: reserves)
+        
+        return await meanPrice(for: subs.filter { metas[$0.hash] != nil }, metas: metas, storeId: storeId)
+    }
+    
+    private func meanPrice(for subs: [Sub], metas: [Int: Any], storeId: Int) async -> [(BotResponse, Int)] {
         return await withTaskGroup(of: Optional<(BotResponse, Int)>.self, returning: [(BotResponse, Int)].self) { taskGroup in
-            let subs: [(any Exchange, PairInfo, Int, Bool)] = activeSubscriptions.compactMap { activeSubscription in
-                guard let adapter = ExchangesList.shared[activeSubscription.environment, activeSubscription.exchangeKey] else { return nil }
-                guard adapter.trigger == type else { return nil }
-                return (adapter, activeSubscription.pair, activeSubscription.hashValue, activeSubscription.silent)
-            }
-            
-            for (exchange, pair, hash, silent) in subs {
+            for (exchange, _, pair, hash, silent) in subs {
                 taskGroup.addTask {
                     do {
-                        var price = try await self.meanPrice(for: exchange, with: pair, storeId: storeId)
+                        var price = try await self.meanPrice(for: exchange, with: pair, storeId: storeId, meta: metas[hash])
                         price.shouldSilent = silent
                         return (price, hash)
                     } catch {
@@ -60,8 +108,8 @@ final class PriceDataSubscriptionState {
         }
     }
     
-    func meanPrice<T: Exchange>(for exchange: T, with pair: PairInfo, storeId: Int) async throws -> BotResponse {
-        let meanPrice = try await exchange.meanPrice(storeId: storeId, tokenA: pair.tokenA, tokenB: pair.tokenB)
+    func meanPrice<T: Exchange>(for exchange: T, with pair: PairInfo, storeId: Int, meta: Any? = nil) async throws -> BotResponse {
+        let meanPrice = try await exchange.meanPrice(storeId: storeId, tokenA: pair.tokenA, tokenB: pair.tokenB, meta: meta as? T.Meta)
 
         var response = BotResponse(status: .success, topic: .priceData)
         response.quote = meanPrice
@@ -0,0 +1,100 @@
+//
+//  ReserveBatchFetcher.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import BigInt
+
+/// Fetches the reserves of every subscribed UniswapV2 pair with a single Multicall per environment.
+///
+/// Without it, every subscription would do its own `getReserves` call, costing one round trip per pair and per block.
+struct ReserveBatchFetcher {
+    struct Request {
+        /// Identifier returned alongside the reserves (usually the subscription hash)
+        let id: Int
+        let exchange: UniswapV2
+        let environment: BotRequest.Environment
+        let pair: PairInfo
+    }
+
+    let web3: (BotRequest.Environment) -> Web3
+
+    init(web3: @escaping (BotRequest.Environment) -> Web3 = { Credentials.shared.web3(for: $0) }) {
+        self.web3 = web3
+    }
+
+    /// Returns the reserves of each request, oriented like the request's (normalized) tokens.
+    ///
+    /// Pairs that couldn't be fetched are missing from the result, so callers can fall back to a regular `getReserves`.
+    func fetch(_ requests: [Request]) async -> [Int: UniswapV2.RequiredPriceInfo] {
+        let environments = Dictionary(grouping: requests, by: \.environment)
+
+        return await withTaskGroup(of: [Int: UniswapV2.RequiredPriceInfo].self) { group in
+            for (environment, requests) in environments {
+                group.addTask {
+                    do {
+                        return try await self.fetch(requests, on: self.web3(environment))
+                    } catch {
+                        print("Multicall failed on \(environment.rawValue): \(error.localizedDescription)")
+                        return [:]
+                    }
+                }
+            }
+            return await group.reduce(into: [:]) { $0.merge($1) { a, _ in a } }
+        }
+    }
+
+    private func fetch(_ requests: [Request], on web3: Web3) async throws -> [Int: UniswapV2.RequiredPriceInfo] {
+        // Several subscriptions can share a pool (same exchange, same tokens): only call it once
+        var pools = [PairAddressIndex.Key: EthereumAddress]()
+        var resolved = [Request]()
+        for request in requests {
+            let key = request.key
+            guard let pair = try? request.exchange.pairFor(factory: key.factory, tokenA: key.token0, tokenB: key.token1) else { continue }
+            pools[key] = pair
+            resolved.append(request)
+        }
+
+        let keys = Array(pools.keys)
+        let calls = keys.map { Multicall.Call(target: pools[$0]!, callData: UniswapV2Pair.Reserves.selector) }
+        let results = try await Multicall(eth: web3.eth).tryAggregate(calls: calls)
+
+        var reserves = [PairAddressIndex.Key: (UInt256, UInt256)]()
+        for (key, result) in zip(keys, results) {
+            guard result.success, let decoded = try? StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: result.returnData) else { continue }
+            reserves[key] = (decoded.reserve0, decoded.reserve1)
+        }
+
+        return ReserveBatchFetcher.metas(for: resolved, reserves: reserves)
+    }
+
+    /// Orients pool reserves (token0, token1) like each request's tokens. Requests without reserves are skipped.
+    static func metas(for requests: [Request], reserves: [PairAddressIndex.Key: (UInt256, UInt256)]) -> [Int: UniswapV2.RequiredPriceInfo] {
+        var metas = [Int: UniswapV2.RequiredPriceInfo]()
+        for request in requests {
+            let key = request.key
+            guard let (reserve0, reserve1) = reserves[key] else { continue }
+            let tokenA = request.exchange.normalizeToken(token: request.pair.tokenA).address
+            let (reserveA, reserveB) = tokenA == key.token0 ? (reserve0, reserve1) : (reserve1, reserve0)
+            metas[request.id] = UniswapV2.RequiredPriceInfo(
+                routerAddress: request.exchange.delegate.address!,
+                factoryAddress: request.exchange.factory,
+                reserveA: reserveA.euler,
+                reserveB: reserveB.euler
+            )
+        }
+        return metas
+    }
+}
+
+extension ReserveBatchFetcher.Request {
+    /// The pool backing this request
+    var key: PairAddressIndex.Key {
+        PairAddressIndex.Key(factory: exchange.factory,
+                             tokenA: exchange.normalizeToken(token: pair.tokenA).address,
+                             tokenB: exchange.normalizeToken(token: pair.tokenB).address)
+    }
+}
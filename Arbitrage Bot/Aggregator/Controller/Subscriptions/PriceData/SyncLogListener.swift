@@ -0,0 +1,156 @@
+//
+//  SyncLogListener.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+
+/// Keeps track of UniswapV2 reserves through the `Sync` events emitted by the tracked pairs.
+///
+/// Every swap, mint or burn ends with a `Sync(reserve0, reserve1)` log, so pools that didn't trade
+/// in a block don't have to be fetched again. Updates are accumulated per block until that block is dispatched.
+///
+/// Whenever the stream may have missed logs (subscription not confirmed yet, failed, or cancelled by a reconnect,
+/// or a reorganization), `drain` asks for a full fetch instead, and the next `track` subscribes again.
+final class SyncLogListener {
+    /// `Sync(uint112,uint112)`
+    static let syncTopic = EthereumData(Array<UInt8>(hex: "0x1c411e9a96e071241c2f21f7726b17ae89e3cab4c78be50e062b03a9fffbbad1"))
+
+    /// Position of a log in the chain
+    private struct Position: Comparable {
+        let block: UInt64
+        let logIndex: UInt64
+
+        static func < (lhs: Position, rhs: Position) -> Bool {
+            (lhs.block, lhs.logIndex) < (rhs.block, rhs.logIndex)
+        }
+    }
+
+    private let web3: Web3
+    private let lock = NSLock()
+    /// Reserves not drained yet, with the position of the log they come from
+    private var pending = [PairAddressIndex.Key: (position: Position, reserves: (UInt256, UInt256))]()
+    /// Last log received for each pair, so that a late log never replaces a newer one
+    private var latest = [PairAddressIndex.Key: Position]()
+    private var pairs = Set<EthereumAddress>()
+    private var subscriptionId: String?
+    /// Incremented on every subscription, so that callbacks of a replaced one are ignored
+    private var generation = 0
+    private var subscribed = false
+    private var needsRefresh = true
+
+    init(web3: Web3) {
+        self.web3 = web3
+    }
+
+    /// Updates the set of listened pairs, subscribing again if the previous subscription was lost. Returns `true` when
+    /// it subscribed, in which case the caller should do a full fetch, as pools that were just added have no reserves yet.
+    @discardableResult
+    func track(pairs: Set<EthereumAddress>) -> Bool {
+        lock.lock()
+        guard pairs != self.pairs else {
+            lock.unlock()
+            return false
+        }
+        self.pairs = pairs
+        let previous = subscriptionId
+        subscriptionId = nil
+        subscribed = false
+        generation += 1
+        let generation = generation
+        pending.removeAll()
+        latest.removeAll()
+        lock.unlock()
+
+        if let previous = previous {
+            try? web3.eth.unsubscribe(subscriptionId: previous) { _ in }
+        }
+        guard pairs.count > 0 else { return true }
+
+        do {
+            try web3.eth.subscribeToLogs(addresses: Array(pairs), topics: [[SyncLogListener.syncTopic]]) { [weak self] resp in
+                guard let id = resp.result else {
+                    print("Could not listen to Sync events: \(resp.error?.localizedDescription ?? "unknown error")")
+                    self?.lost(generation: generation)
+                    return
+                }
+                self?.confirm(id: id, generation: generation)
+                print("Listening to Sync events of \(pairs.count) pairs")
+            } onCancel: { [weak self] in
+                self?.lost(generation: generation)
+            } onLog: { [weak self] log in
+                self?.process(log: log, generation: generation)
+            }
+        } catch {
+            print("Error: \(error.localizedDescription)")
+            lost(generation: generation)
+        }
+        return true
+    }
+
+    private func confirm(id: String, generation: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard generation == self.generation else { return }
+        subscriptionId = id
+        subscribed = true
+        // Logs emitted before the node registered the filter were missed
+        needsRefresh = true
+    }
+
+    /// The subscription failed or was cancelled by the provider: fall back to full fetches, and subscribe again on the next `track`.
+    private func lost(generation: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard generation == self.generation else { return }
+        pairs.removeAll()
+        subscriptionId = nil
+        subscribed = false
+        needsRefresh = true
+    }
+
+    func process(log: FastJSON.Log, generation: Int? = nil) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard generation == nil || generation == self.generation else { return }
+        if log.removed {
+            // Chain reorganization: the reserves we received may not hold anymore, and the replacing logs can be older
+            needsRefresh = true
+            pending.removeAll()
+            latest.removeAll()
+            return
+        }
+        guard let key = PairAddressIndex.shared.key(for: log.address),
+              let sync = try? StaticABIDecoder.decode(UniswapV2Pair.Sync.self, from: log.data) else { return }
+
+        let position = Position(block: log.blockNumber, logIndex: log.logIndex)
+        if let last = latest[key], last >= position {
+            return
+        }
+        latest[key] = position
+        pending[key] = (position, (sync.reserve0, sync.reserve1))
+    }
+
+    /// Returns the reserves of the pools that changed up to `block` since the last call, or `nil` if a full fetch is required.
+    ///
+    /// Logs of later blocks are kept for their own head. Logs of a block received after its head was drained are returned
+    /// by the next call, unless a newer log of the same pair was already applied.
+    func drain(through block: UInt64? = nil) -> [PairAddressIndex.Key: (UInt256, UInt256)]? {
+        lock.lock()
+        defer { lock.unlock() }
+        var updates = [PairAddressIndex.Key: (UInt256, UInt256)]()
+        for (key, update) in pending where block.map({ update.position.block <= $0 }) ?? true {
+            updates[key] = update.reserves
+        }
+        for key in updates.keys {
+            pending[key] = nil
+        }
+        if needsRefresh || !subscribed {
+            needsRefresh = false
+            return nil
+        }
+        return updates
+    }
+}
@@ -18,4 +18,22 @@ struct ConfigFile: Decodable {
     var queries: [BotRequest.Query]
     /// If set to true, the bot will start arbitrage
     var active: Bool
+    /// How pool reserves are kept up to date, defaults to `polling`
+    var reserveUpdates: ReserveUpdateMode?
+    /// When set, the reserves seen on each block are appended to a capture file, for replay
+    var capture: CaptureOptions?
+
+    enum ReserveUpdateMode: String, Decodable {
+        /// Every pair is re-fetched on each new block
+        case polling
+        /// Reserves are read from the `Sync` logs of the tracked pairs, only pools that changed are updated
+        case events
+    }
+
+    struct CaptureOptions: Decodable {
+        /// Path of the capture file, its index is written next to it (`<path>.idx`)
+        var path: String
+        /// Number of blocks between two full snapshots, defaults to 1000
+        var keyframeInterval: Int?
+    }
 }
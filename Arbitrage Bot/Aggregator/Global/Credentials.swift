@@ -17,10 +17,15 @@ public class Credentials {
     var environment: BotRequest.Environment = .production {
         didSet {
             print("Environment: \(environment.rawValue)")
+            GasPriceCache.shared.invalidate()
         }
     }
     
     var web3: Web3 {
+        web3(for: environment)
+    }
+
+    func web3(for environment: BotRequest.Environment) -> Web3 {
         switch environment {
         case .development:
             return testnetWeb3
@@ -36,17 +41,30 @@ public class Credentials {
     }
     
     init() throws {
-        guard let testnetJsonRPC = Environment.get("TESTNET_JSON_RPC_URL") else { throw EnvironmentError.undefinedVariable("TESTNET_JSON_RPC_URL") }
-        guard let productionJsonRPC = Environment.get("JSON_RPC_URL") else { throw EnvironmentError.undefinedVariable("JSON_RPC_URL") }
-        self.testnetWeb3 = try Web3(wsUrl: testnetJsonRPC)
-        self.productionWeb3 = try Web3(wsUrl: productionJsonRPC)
+        self.testnetWeb3 = try Web3(wsUrls: Self.urls("TESTNET_JSON_RPC_URL"))
+        self.productionWeb3 = try Web3(wsUrls: Self.urls("JSON_RPC_URL"))
         
         guard let privateKey = Environment.get("WALLET_PRIVATE_KEY") else { throw EnvironmentError.undefinedVariable("WALLET_PRIVATE_KEY") }
         self.privateWallet = try EthereumPrivateKey(hexPrivateKey: privateKey)
         
-        let provider = web3.provider as! Web3WebSocketProvider
-        print("Connected to \(provider.wsUrl)")
+        if let pool = web3.provider as? Web3ProviderPool {
+            print("Connected to \(pool.endpoints.map(\.name).joined(separator: ", "))")
+        } else if let provider = web3.provider as? Web3WebSocketProvider {
+            print("Connected to \(provider.wsUrl)")
+        }
         
         print("Using Wallet: \(self.privateWallet.address.hex(eip55: false))")
     }
+    
+    /// Endpoints listed in `<variable>S` (comma separated), or the single one in `<variable>`
+    private static func urls(_ variable: String) throws -> [String] {
+        if let list = Environment.get(variable + "S") {
+            let urls = list.split(separator: ",").map { $0.trimmingCharacters(in: .whitespaces) }.filter { !$0.isEmpty }
+            if !urls.isEmpty {
+                return urls
+            }
+        }
+        guard let url = Environment.get(variable) else { throw EnvironmentError.undefinedVariable(variable) }
+        return [url]
+    }
 }
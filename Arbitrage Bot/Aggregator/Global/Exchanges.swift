@@ -73,6 +73,10 @@ public struct ExchangesList {
             }
             return nil
         }
+
+        var all: [any Exchange] {
+            Mirror(reflecting: self).children.compactMap { ($0.value as? ExchangeMetadata)?.exchange }
+        }
     }
 
     struct Production {
@@ -100,6 +104,19 @@ public struct ExchangesList {
             }
             return nil
         }
+
+        var all: [any Exchange] {
+            Mirror(reflecting: self).children.compactMap { ($0.value as? ExchangeMetadata)?.exchange }
+        }
+    }
+    
+    func exchanges(for environment: BotRequest.Environment) -> [any Exchange] {
+        switch environment {
+        case .development:
+            return development.all
+        case .production:
+            return production.all
+        }
     }
     
     subscript(environment: BotRequest.Environment, name: String) -> (any Exchange)? {
@@ -26,6 +26,7 @@ extension Builder {
     func process(systemTime: Int) {
         guard self.lock == false else {
             print("Locked!")
+            Metrics.increment(.builderContended)
             return
         }
 //        guard self.systemTime == systemTime else {
@@ -34,6 +35,7 @@ extension Builder {
 //            return
 //        }
         self.lock = true
+        Metrics.increment(.opportunitiesProcessed, by: steps.count)
         
         Task(timeout: 5) {
             // It's okay to do that, because we start from a single node
@@ -47,6 +49,8 @@ extension Builder {
                 }
             }
             
+            StageTracer.mark(.optimalPrice, systemTime: systemTime)
+            
             guard all.count > 0 else { throw BuilderProcessError.noOpportunity }
             
             let bestOpportunity = all
@@ -65,7 +69,7 @@ extension Builder {
             
             print("Best: \(amountIn) -> \(bestOpportunity.amountOut)")
             
-            try await DecisionDataPublisher.shared.coordinator.coordinateFlashSwapArbitrage(with: bestOpportunity)
+            try await DecisionDataPublisher.shared.coordinator.coordinateFlashSwapArbitrage(with: bestOpportunity, systemTime: systemTime)
         } deferred: { error in
             if let error = error {
                 print(error.localizedDescription)
@@ -0,0 +1,146 @@
+//
+//  Multicall.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import BigInt
+
+/// Minimal wrapper around the Multicall3 contract, used to batch many read calls in a single `eth_call`.
+///
+/// The generic ABI encoder doesn't handle arrays of dynamic tuples, so `tryAggregate(bool,(address,bytes)[])`
+/// is encoded and decoded by hand here.
+struct Multicall {
+    /// Multicall3 is deployed at the same address on every chain we use (Ethereum, BSC, BSC testnet).
+    static let defaultAddress = try! EthereumAddress(hex: Environment.get("MULTICALL_ADDRESS") ?? "0xcA11bde05977b3631167028862bE2a173976CA11", eip55: false)
+
+    /// `tryAggregate(bool,(address,bytes)[])`
+    static let tryAggregateSelector: Bytes = [0xbc, 0xe3, 0x8b, 0xd7]
+
+    struct Call {
+        let target: EthereumAddress
+        let callData: Bytes
+    }
+
+    struct Result {
+        let success: Bool
+        let returnData: Bytes
+    }
+
+    enum MulticallError: LocalizedError {
+        case malformedResponse
+        case resultCountMismatch(expected: Int, got: Int)
+
+        var errorDescription: String? {
+            switch self {
+            case .malformedResponse:
+                return "Multicall returned a malformed response"
+            case .resultCountMismatch(let expected, let got):
+                return "Multicall returned \(got) results for \(expected) calls"
+            }
+        }
+    }
+
+    let address: EthereumAddress
+    let eth: Web3.Eth
+
+    init(address: EthereumAddress = Multicall.defaultAddress, eth: Web3.Eth) {
+        self.address = address
+        self.eth = eth
+    }
+
+    /// Executes all the calls in a single `eth_call`. Failing calls don't revert the batch, their `success` flag is `false`.
+    func tryAggregate(requireSuccess: Bool = false, calls: [Call], block: EthereumQuantityTag = .latest) async throws -> [Result] {
+        guard calls.count > 0 else { return [] }
+        let data = Multicall.encodeTryAggregate(requireSuccess: requireSuccess, calls: calls)
+        let call = EthereumCall(to: address, data: EthereumData(data))
+        let response = try await eth.call(call: call, block: block)
+        let results = try Multicall.decodeTryAggregate(response.bytes)
+        guard results.count == calls.count else {
+            throw MulticallError.resultCountMismatch(expected: calls.count, got: results.count)
+        }
+        return results
+    }
+
+    // MARK: - Encoding
+
+    static func encodeTryAggregate(requireSuccess: Bool, calls: [Call]) -> Bytes {
+        // Each element is a dynamic tuple (address, bytes): head of 2 words, then the padded bytes
+        let elements = calls.map { call -> Bytes in
+            var element = word(call.target.rawAddress)
+            element += word(64) // Offset of `bytes` inside the tuple
+            element += word(call.callData.count)
+            element += call.callData
+            element += Bytes(repeating: 0, count: (32 - call.callData.count % 32) % 32)
+            return element
+        }
+
+        var data = tryAggregateSelector
+        data += word(requireSuccess ? 1 : 0)
+        data += word(64) // Offset of the array
+        data += word(calls.count)
+
+        var offset = calls.count * 32
+        for element in elements {
+            data += word(offset)
+            offset += element.count
+        }
+        for element in elements {
+            data += element
+        }
+        return data
+    }
+
+    private static func word(_ value: Int) -> Bytes {
+        var bytes = Bytes(repeating: 0, count: 32)
+        var value = UInt64(value)
+        for i in 0..<8 {
+            bytes[31 - i] = UInt8(truncatingIfNeeded: value)
+            value >>= 8
+        }
+        return bytes
+    }
+
+    private static func word(_ value: Bytes) -> Bytes {
+        return Bytes(repeating: 0, count: 32 - value.count) + value
+    }
+
+    // MARK: - Decoding
+
+    /// Decodes the `(bool success, bytes returnData)[]` returned by `tryAggregate`.
+    ///
+    /// Every offset and length comes from the node, so each one is checked against the size of the response before it
+    /// is used: a malformed response throws instead of trapping on an overflow or an out of range slice.
+    static func decodeTryAggregate(_ data: Bytes) throws -> [Result] {
+        /// Reads a word that must be an offset or a length, so can't be larger than the response
+        func readInt(at offset: Int) throws -> Int {
+            guard offset >= 0, data.count >= 32, offset <= data.count - 32 else { throw MulticallError.malformedResponse }
+            guard data[offset..<offset + 24].allSatisfy({ $0 == 0 }) else { throw MulticallError.malformedResponse }
+            let value = data[offset + 24..<offset + 32].reduce(UInt64(0)) { $0 << 8 | UInt64($1) }
+            guard value <= UInt64(data.count) else { throw MulticallError.malformedResponse }
+            return Int(value)
+        }
+
+        let arrayStart = try readInt(at: 0)
+        let count = try readInt(at: arrayStart)
+        let elementsStart = arrayStart + 32
+        // One offset word per element
+        guard elementsStart <= data.count, count <= (data.count - elementsStart) / 32 else {
+            throw MulticallError.malformedResponse
+        }
+
+        var results = [Result]()
+        results.reserveCapacity(count)
+        for i in 0..<count {
+            let tupleStart = elementsStart + (try readInt(at: elementsStart + i * 32))
+            let success = try readInt(at: tupleStart) != 0
+            let bytesStart = tupleStart + (try readInt(at: tupleStart + 32))
+            let length = try readInt(at: bytesStart)
+            guard length <= data.count - bytesStart - 32 else { throw MulticallError.malformedResponse }
+            results.append(Result(success: success, returnData: Array(data[bytesStart + 32..<bytesStart + 32 + length])))
+        }
+        return results
+    }
+}
@@ -0,0 +1,163 @@
+//
+//  StartArbitrageTemplate.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import BigInt
+
+/// Prebuilt `initiateArbitrage` transaction, for routes of a given number of steps.
+///
+/// The calldata layout only depends on the number of steps, so it is built once: selector, array offsets and lengths are
+/// already in place, and each trade only patches the amount and the addresses. The legacy (EIP-155) transaction is then
+/// RLP-encoded into a reusable buffer and signed, without going through `SolidityInvocation`, `EthereumTransaction` and `RLPEncoder`.
+final class StartArbitrageTemplate {
+    static let selector = Array(Array("initiateArbitrage(uint256,address,address[],address[],address[])".utf8).keccak256()[0..<4])
+
+    private static let lock = NSLock()
+    private static var templates = [Int: StartArbitrageTemplate]()
+
+    /// Template for routes of `steps` steps, built on first use
+    static func shared(steps: Int) -> StartArbitrageTemplate {
+        lock.lock()
+        defer { lock.unlock() }
+        if let template = templates[steps] {
+            return template
+        }
+        let template = StartArbitrageTemplate(steps: steps)
+        templates[steps] = template
+        return template
+    }
+
+    let steps: Int
+
+    private let lock = NSLock()
+    private var calldata: Bytes
+    private var buffer = Bytes()
+
+    /// Offsets of the patched fields in `calldata`
+    private let amountOffset = 4
+    private let lapOffset = 4 + 32 + 12
+    private let arrayOffsets: [Int]
+
+    init(steps: Int) {
+        self.steps = steps
+        let arrayLength = 32 * (steps + 1)
+        let heads = [5 * 32, 5 * 32 + arrayLength, 5 * 32 + 2 * arrayLength]
+
+        var calldata = Self.selector
+        calldata.append(contentsOf: Bytes(repeating: 0, count: 5 * 32 + 3 * arrayLength))
+        for (i, head) in heads.enumerated() {
+            Self.write(word: UInt64(head), to: &calldata, at: 4 + (2 + i) * 32)
+            Self.write(word: UInt64(steps), to: &calldata, at: 4 + head)
+        }
+        self.calldata = calldata
+        // First address of each array
+        self.arrayOffsets = heads.map { 4 + $0 + 32 + 12 }
+
+        buffer.reserveCapacity(calldata.count + 160)
+    }
+
+    /// Builds and signs the transaction, returning its raw bytes, ready for `eth_sendRawTransaction`.
+    func signedTransaction(startAmount: BigUInt,
+                           lapExchange: EthereumAddress,
+                           steps route: [Step],
+                           to: EthereumAddress,
+                           nonce: EthereumQuantity,
+                           gasPrice: EthereumQuantity,
+                           gasLimit: BigUInt,
+                           chainId: BigUInt,
+                           key: EthereumPrivateKey) throws -> Bytes {
+        precondition(route.count == steps, "Template built for \(steps) steps")
+        lock.lock()
+        defer { lock.unlock() }
+
+        // MARK: - Calldata
+        let amount = startAmount.serialize()
+        precondition(amount.count <= 32, "startAmount overflows uint256")
+        calldata.replaceSubrange(amountOffset..<amountOffset + 32, with: Bytes(repeating: 0, count: 32 - amount.count) + amount)
+        calldata.replaceSubrange(lapOffset..<lapOffset + 20, with: lapExchange.rawAddress)
+        for (i, step) in route.enumerated() {
+            let slot = 32 * i
+            calldata.replaceSubrange(arrayOffsets[0] + slot..<arrayOffsets[0] + slot + 20, with: step.intermediary.rawAddress)
+            calldata.replaceSubrange(arrayOffsets[1] + slot..<arrayOffsets[1] + slot + 20, with: step.token.rawAddress)
+            calldata.replaceSubrange(arrayOffsets[2] + slot..<arrayOffsets[2] + slot + 20, with: step.data.rawAddress)
+        }
+
+        // MARK: - Signature
+        let fields = [nonce.quantity.serialize(), gasPrice.quantity.serialize(), gasLimit.serialize()]
+        let to = to.rawAddress
+        encode(fields: fields, to: to, trailer: [chainId.serialize(), [], []])
+        let signature = try key.sign(hash: buffer.keccak256())
+
+        // MARK: - Signed transaction
+        let v = BigUInt(signature.v) + 35 + chainId * 2
+        encode(fields: fields, to: to, trailer: [v.serialize(), Self.scalar(signature.r), Self.scalar(signature.s)])
+        return buffer
+    }
+
+    // MARK: - RLP
+
+    /// `[nonce, gasPrice, gasLimit, to, value = 0, data, ...trailer]` into `buffer`
+    private func encode(fields: [Bytes], to: Bytes, trailer: [Bytes]) {
+        let items = fields + [to, []]
+        let payload = items.reduce(0) { $0 + Self.length(of: $1) } + Self.length(of: calldata) + trailer.reduce(0) { $0 + Self.length(of: $1) }
+
+        buffer.removeAll(keepingCapacity: true)
+        Self.header(length: payload, offset: 0xc0, into: &buffer)
+        for item in items {
+            Self.string(item, into: &buffer)
+        }
+        Self.string(calldata, into: &buffer)
+        for item in trailer {
+            Self.string(item, into: &buffer)
+        }
+    }
+
+    /// Encoded length of a string
+    private static func length(of bytes: Bytes) -> Int {
+        if bytes.count == 1 && bytes[0] < 0x80 {
+            return 1
+        }
+        return headerLength(bytes.count) + bytes.count
+    }
+
+    private static func headerLength(_ length: Int) -> Int {
+        length <= 55 ? 1 : 1 + (Int.bitWidth - length.leadingZeroBitCount + 7) / 8
+    }
+
+    private static func string(_ bytes: Bytes, into buffer: inout Bytes) {
+        if bytes.count == 1 && bytes[0] < 0x80 {
+            buffer.append(bytes[0])
+            return
+        }
+        header(length: bytes.count, offset: 0x80, into: &buffer)
+        buffer.append(contentsOf: bytes)
+    }
+
+    /// `offset` is 0x80 for strings, 0xc0 for lists
+    private static func header(length: Int, offset: UInt8, into buffer: inout Bytes) {
+        guard length > 55 else {
+            buffer.append(offset + UInt8(length))
+            return
+        }
+        let size = headerLength(length) - 1
+        buffer.append(offset + 55 + UInt8(size))
+        for i in (0..<size).reversed() {
+            buffer.append(UInt8(truncatingIfNeeded: length >> (8 * i)))
+        }
+    }
+
+    /// Signature scalars are encoded as integers, without leading zeros
+    private static func scalar(_ bytes: Bytes) -> Bytes {
+        Array(bytes.drop { $0 == 0 })
+    }
+
+    private static func write(word: UInt64, to bytes: inout Bytes, at offset: Int) {
+        for i in 0..<8 {
+            bytes[offset + 31 - i] = UInt8(truncatingIfNeeded: word >> (8 * i))
+        }
+    }
+}
@@ -30,6 +30,39 @@ open class UniswapV2Pair: StaticContract, UniswapV2PairContract {
     }
 }
 
+// MARK: - Static layouts
+
+public extension UniswapV2Pair {
+    /// `getReserves() returns (uint112 reserve0, uint112 reserve1, uint32 blockTimestampLast)`
+    struct Reserves: StaticABIDecodable {
+        public static let selector: Bytes = [0x09, 0x02, 0xf1, 0xac]
+        public static let wordCount = 3
+
+        public let reserve0: UInt256
+        public let reserve1: UInt256
+        public let blockTimestampLast: UInt32
+
+        public init(from decoder: StaticABIDecoder) throws {
+            self.reserve0 = try decoder.uint(at: 0, bits: 112)
+            self.reserve1 = try decoder.uint(at: 1, bits: 112)
+            self.blockTimestampLast = UInt32(try decoder.uint64(at: 2, bits: 32))
+        }
+    }
+
+    /// Data of the `Sync(uint112 reserve0, uint112 reserve1)` event
+    struct Sync: StaticABIDecodable {
+        public static let wordCount = 2
+
+        public let reserve0: UInt256
+        public let reserve1: UInt256
+
+        public init(from decoder: StaticABIDecoder) throws {
+            self.reserve0 = try decoder.uint(at: 0, bits: 112)
+            self.reserve1 = try decoder.uint(at: 1, bits: 112)
+        }
+    }
+}
+
 public extension UniswapV2PairContract {
     
     func getReserves() -> SolidityInvocation {
@@ -26,6 +26,8 @@ actor AdjacencyList {
     }
     internal var prices: [Pair: [Int: ReserveFeeInfo]]
     internal var tokens: [Token]
+    /// Exchanges updated since the last call to `changes(all:)`, per pair. Only tracked once someone asked for changes.
+    private var changed: [Pair: Set<Int>]? = nil
     
     nonisolated let tokensPublisher = CurrentValueSubject<[Token], Never>([])
     
@@ -62,15 +64,30 @@ actor AdjacencyList {
             prices[index] = [:]
         }
         
-        var oldInfo = prices[index]?[info.exchangeKey.hashValue] ?? info
-        
-        if tokenA < tokenB {
-            oldInfo.spotAB = info.spotAB ?? oldInfo.spotAB
-        } else {
-            oldInfo.spotBA = info.spotBA ?? oldInfo.spotBA
+        // Keep the latest reserves, and the spot price of the other direction
+        var newInfo = info
+        if let oldInfo = prices[index]?[info.exchangeKey.hashValue] {
+            if tokenA < tokenB {
+                newInfo.spotBA = oldInfo.spotBA
+            } else {
+                newInfo.spotAB = oldInfo.spotAB
+            }
         }
         
-        prices[index]?[info.exchangeKey.hashValue] = oldInfo
+        prices[index]?[info.exchangeKey.hashValue] = newInfo
+        changed?[index, default: []].insert(info.exchangeKey.hashValue)
+    }
+    
+    /// Entries updated since the previous call, or every entry when `all` is set.
+    func changes(all: Bool) -> [ReserveFeeInfo] {
+        let previous = changed
+        changed = [:]
+        guard !all, let previous else {
+            return prices.values.flatMap { $0.values }
+        }
+        return previous.flatMap { pair, exchanges in
+            exchanges.compactMap { prices[pair]?[$0] }
+        }
     }
     
     func getPrice(tokenA: Token, tokenB: Token) -> Double {
@@ -0,0 +1,60 @@
+//
+//  Metrics.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Native
+
+/// Counters and histograms of the native registry (`metrics.h`), scraped on `GET /metrics`.
+enum Metrics {
+    typealias Counter = metric_counter_t
+    typealias Histogram = metric_histogram_t
+
+    static func increment(_ counter: Counter, by value: Int = 1) {
+        metrics_add(counter, UInt64(max(value, 0)))
+    }
+
+    /// Records the time elapsed since `start`, a `DispatchTime.now().uptimeNanoseconds`
+    static func observe(_ histogram: Histogram, since start: UInt64) {
+        let now = DispatchTime.now().uptimeNanoseconds
+        metrics_observe(histogram, now > start ? now - start : 0)
+    }
+
+    static func value(of counter: Counter) -> UInt64 {
+        metrics_counter(counter)
+    }
+
+    /// Prometheus text of every metric
+    static func render() -> String {
+        var buffer = [CChar](repeating: 0, count: 16 * 1024)
+        var length = metrics_render(&buffer, buffer.count)
+        // Metrics may grow between two renders, until the text fits
+        while length >= buffer.count {
+            buffer = [CChar](repeating: 0, count: length + 256)
+            length = metrics_render(&buffer, buffer.count)
+        }
+        return buffer.prefix(length).withUnsafeBytes { String(decoding: $0, as: UTF8.self) }
+    }
+}
+
+extension Metrics.Counter {
+    static let ticks = METRIC_TICKS
+    static let ticksSkipped = METRIC_TICKS_SKIPPED
+    static let cyclesFound = METRIC_CYCLES_FOUND
+    static let opportunitiesProcessed = METRIC_OPPORTUNITIES_PROCESSED
+    static let builderContended = METRIC_BUILDER_CONTENDED
+    static let rpcErrors = METRIC_RPC_ERRORS
+    static let publications = METRIC_PUBLICATIONS
+    static let wsBackpressure = METRIC_WS_BACKPRESSURE
+    static let wsDropped = METRIC_WS_DROPPED
+    static let wsConflated = METRIC_WS_CONFLATED
+    static let wsFramesSkipped = METRIC_WS_FRAMES_SKIPPED
+}
+
+extension Metrics.Histogram {
+    static let tickDuration = METRIC_TICK_DURATION
+    static let rpcDuration = METRIC_RPC_DURATION
+}
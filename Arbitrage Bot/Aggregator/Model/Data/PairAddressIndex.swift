@@ -0,0 +1,209 @@
+//
+//  PairAddressIndex.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+
+/// Index of precomputed UniswapV2 pair addresses.
+///
+/// Pair addresses only depend on the factory and on the sorted token addresses, so we
+/// compute them once when the configuration is loaded, and `UniswapV2.pairFor` only
+/// has to do a lookup on the hot path.
+final class PairAddressIndex {
+    static let shared = PairAddressIndex()
+
+    struct Key: Hashable, Codable {
+        let factory: EthereumAddress
+        let token0: EthereumAddress
+        let token1: EthereumAddress
+
+        init(factory: EthereumAddress, tokenA: EthereumAddress, tokenB: EthereumAddress) {
+            self.factory = factory
+            (self.token0, self.token1) = tokenA < tokenB ? (tokenA, tokenB) : (tokenB, tokenA)
+        }
+    }
+
+    /// Cached pair, with the init code hash it was derived with: changing the hash of a factory in the configuration
+    /// invalidates its pairs.
+    private struct Entry: Codable {
+        let key: Key
+        let initCodeHash: String
+        let pair: EthereumAddress
+    }
+
+    /// Cached pairs derived again on load. The file is discarded if any of them doesn't match.
+    static let verifiedSample = 16
+
+    private let pairs: SynchronizedDictionary<Key, EthereumAddress> = [:]
+    private let keys: SynchronizedDictionary<EthereumAddress, Key> = [:]
+
+    /// Where the index is persisted between runs.
+    let cacheURL: URL
+
+    init(cacheFile: String = Environment.get("PAIR_INDEX_CACHE") ?? ".pair-index.json") {
+        self.cacheURL = URL(fileURLWithPath: FileManager.default.currentDirectoryPath + "/" + cacheFile)
+    }
+
+    var count: Int {
+        pairs.count
+    }
+
+    subscript(factory: EthereumAddress, tokenA: EthereumAddress, tokenB: EthereumAddress) -> EthereumAddress? {
+        get {
+            pairs[Key(factory: factory, tokenA: tokenA, tokenB: tokenB)]
+        }
+        set {
+            let key = Key(factory: factory, tokenA: tokenA, tokenB: tokenB)
+            if let old = pairs[key] {
+                keys[old] = nil
+            }
+            pairs[key] = newValue
+            if let pair = newValue {
+                keys[pair] = key
+            }
+        }
+    }
+
+    /// Reverse lookup, from a pair address to its factory and tokens.
+    func key(for pair: EthereumAddress) -> Key? {
+        keys[pair]
+    }
+
+    // MARK: - Build
+
+    /// Init code hash of the pairs of every UniswapV2 factory of the environment
+    static func initCodeHashes(for environment: BotRequest.Environment) -> [EthereumAddress: Bytes] {
+        ExchangesList.shared
+            .exchanges(for: environment)
+            .compactMap { $0 as? UniswapV2 }
+            .reduce(into: [:]) { hashes, exchange in
+                hashes[exchange.factory] = exchange.pairInitCodeHash
+            }
+    }
+
+    /// Computes the pair address of every configured pair, on every UniswapV2 exchange of the environment.
+    ///
+    /// Entries already loaded from disk are skipped.
+    func build(queries: [BotRequest.Query], environment: BotRequest.Environment) {
+        let exchanges = ExchangesList.shared
+            .exchanges(for: environment)
+            .compactMap { $0 as? UniswapV2 }
+
+        var jobs = [(exchange: UniswapV2, tokenA: EthereumAddress, tokenB: EthereumAddress)]()
+        var seen = Set<Key>()
+        for exchange in exchanges {
+            for query in queries {
+                let tokenA = exchange.normalizeToken(token: query.tokenA).address
+                let tokenB = exchange.normalizeToken(token: query.tokenB).address
+                let key = Key(factory: exchange.factory, tokenA: tokenA, tokenB: tokenB)
+                guard tokenA != tokenB, self.pairs[key] == nil, !seen.contains(key) else { continue }
+                seen.insert(key)
+                jobs.append((exchange, tokenA, tokenB))
+            }
+        }
+
+        var initCodeHashes = [Bytes]()
+        jobs = jobs.filter { job in
+            guard (try? job.exchange.sortTokens(tokenA: job.tokenA, tokenB: job.tokenB)) != nil,
+                  let initCodeHash = job.exchange.pairInitCodeHash else { return false }
+            initCodeHashes.append(initCodeHash)
+            return true
+        }
+
+        guard jobs.count > 0 else { return }
+
+        let keys = jobs.map { Key(factory: $0.exchange.factory, tokenA: $0.tokenA, tokenB: $0.tokenB) }
+        for (job, pair) in zip(jobs, Self.pairAddresses(of: keys, initCodeHashes: initCodeHashes)) {
+            guard let pair else { continue }
+            self[job.exchange.factory, job.tokenA, job.tokenB] = pair
+        }
+
+        print("Indexed \(jobs.count) pair addresses")
+
+        save(initCodeHashes: Self.initCodeHashes(for: environment))
+    }
+
+    /// CREATE2 derivation of the pair of each key, done in two batched keccak passes: one for all the salts, then one
+    /// for all the `0xff ++ factory ++ salt ++ initCodeHash` preimages.
+    static func pairAddresses(of keys: [Key], initCodeHashes: [Bytes]) -> [EthereumAddress?] {
+        guard keys.count > 0 else { return [] }
+
+        // Salts: keccak256(token0 ++ token1)
+        var saltInputs = Bytes()
+        saltInputs.reserveCapacity(keys.count * 40)
+        for key in keys {
+            saltInputs.append(contentsOf: key.token0.rawAddress)
+            saltInputs.append(contentsOf: key.token1.rawAddress)
+        }
+        let salts = Keccak.hash256(batch: saltInputs, length: 40)
+
+        // Pair addresses: last 20 bytes of keccak256(0xff ++ factory ++ salt ++ initCodeHash)
+        var preimages = Bytes()
+        preimages.reserveCapacity(keys.count * 85)
+        for (i, key) in keys.enumerated() {
+            preimages.append(0xff)
+            preimages.append(contentsOf: key.factory.rawAddress)
+            preimages.append(contentsOf: salts[i * 32 ..< (i + 1) * 32])
+            preimages.append(contentsOf: initCodeHashes[i])
+        }
+        let hashes = Keccak.hash256(batch: preimages, length: 85)
+
+        return keys.indices.map { i in
+            try? EthereumAddress(rawAddress: Array(hashes[i * 32 + 12 ..< (i + 1) * 32]))
+        }
+    }
+
+    // MARK: - Persistence
+
+    func load(environment: BotRequest.Environment) {
+        load(initCodeHashes: Self.initCodeHashes(for: environment))
+    }
+
+    /// Loads the cached pairs of the factories in `initCodeHashes`, if they were derived with the same init code hash.
+    /// The others are left to `build`.
+    func load(initCodeHashes: [EthereumAddress: Bytes]) {
+        guard let data = try? Data(contentsOf: cacheURL) else { return }
+        let entries: [Entry]
+        do {
+            entries = try JSONDecoder().decode([Entry].self, from: data)
+        } catch {
+            print("Ignoring pair index cache: \(error.localizedDescription)")
+            return
+        }
+
+        let current = entries.filter { entry in
+            initCodeHashes[entry.key.factory]?.hexString(prefix: true) == entry.initCodeHash
+        }
+
+        // The file is trusted as a whole: a wrong pair would silently quote another pool
+        let sample = Array(current.shuffled().prefix(Self.verifiedSample))
+        let derived = Self.pairAddresses(of: sample.map(\.key),
+                                         initCodeHashes: sample.compactMap { initCodeHashes[$0.key.factory] })
+        guard zip(sample, derived).allSatisfy({ $0.pair == $1 }) else {
+            print("Ignoring pair index cache: \(cacheURL.lastPathComponent) doesn't match the pair addresses")
+            return
+        }
+
+        for entry in current {
+            pairs[entry.key] = entry.pair
+            keys[entry.pair] = entry.key
+        }
+        print("Loaded \(current.count) pair addresses from \(cacheURL.lastPathComponent), \(entries.count - current.count) outdated")
+    }
+
+    /// Saves the pairs of the factories in `initCodeHashes`.
+    func save(initCodeHashes: [EthereumAddress: Bytes]) {
+        let entries = pairs.dictionary.compactMap { key, pair in
+            initCodeHashes[key.factory].map { Entry(key: key, initCodeHash: $0.hexString(prefix: true), pair: pair) }
+        }
+        do {
+            let data = try JSONEncoder().encode(entries)
+            try data.write(to: cacheURL, options: .atomic)
+        } catch {
+            print("Could not save pair index: \(error.localizedDescription)")
+        }
+    }
+}
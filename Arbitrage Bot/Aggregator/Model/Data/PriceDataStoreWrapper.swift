@@ -14,7 +14,10 @@ class PriceDataStoreWrapper {
     
     var publisher: PriceDataPublisher
     
+    let storeId: Int
+    
     init(storeId: Int) {
+        self.storeId = storeId
         self.publisher = PriceDataPublisher(storeId: storeId)
     }
     
@@ -26,11 +29,60 @@ class PriceDataStoreWrapper {
     }
     
     func dispatch(time: UInt32) {
-        guard let callback = self.callback else { return }
+        guard let callback = self.callback else {
+            Metrics.increment(.ticksSkipped)
+            return
+        }
         Task {
             let spot = await self.adjacencyList.spotPicture // Take a picture of the price data store
+            StageTracer.mark(.spotPicture, systemTime: Int(time))
             await callback(spot, self.adjacencyList.tokens, time)
+            let tokens = await self.adjacencyList.tokens
+            self.publishMatrix(spot, tokens: tokens)
+            HTTPSnapshots.storeMatrix(spot, tokens: tokens, storeId: self.storeId, systemTime: time)
+        }
+    }
+    
+    // MARK: - Matrix stream
+    
+    private let matrixLock = NSLock()
+    /// Sockets subscribed to `RealtimeTopics.matrix(storeId:)`
+    private var matrixSubscribers = 0
+    /// Rates last published, deltas are computed against them
+    private var publishedRates = [Double]()
+    
+    func subscribeToMatrix(_ subscribe: Bool) {
+        matrixLock.lock()
+        defer { matrixLock.unlock() }
+        matrixSubscribers += subscribe ? 1 : -1
+        if subscribe {
+            // New subscribers get a full snapshot on the next tick
+            publishedRates.removeAll()
+        }
+    }
+    
+    /// Publishes a full snapshot on the next tick, for subscribers that missed deltas
+    func resyncMatrix() {
+        matrixLock.lock()
+        defer { matrixLock.unlock() }
+        publishedRates.removeAll()
+    }
+    
+    /// Publishes the rates that changed since the last tick, or a snapshot when tokens were added or someone subscribed
+    private func publishMatrix(_ rates: [Double], tokens: [Token]) {
+        matrixLock.lock()
+        defer { matrixLock.unlock() }
+        guard matrixSubscribers > 0 else {
+            publishedRates.removeAll()
+            return
         }
+        guard rates.count == tokens.count * tokens.count,
+              !rates.elementsEqual(publishedRates, by: { $0.bitPattern == $1.bitPattern }) else { return }
+        
+        let frame = BinaryFrame.matrixDelta(rates, previous: publishedRates, size: tokens.count)
+            ?? BinaryFrame.matrixSnapshot(rates, tokens: tokens)
+        publishedRates = rates
+        RealtimeTopics.publish(frame, to: RealtimeTopics.matrix(storeId: storeId))
     }
 }
 
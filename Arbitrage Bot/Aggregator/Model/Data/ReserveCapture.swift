@@ -0,0 +1,128 @@
+//
+//  ReserveCapture.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Euler
+import Native
+
+/// Appends the reserves seen by the `AdjacencyList` to a capture file, block by block (see `capture.h`).
+///
+/// Each block only contains the entries that changed since the previous one, with a full snapshot every `keyframeInterval` blocks.
+actor ReserveCapture {
+    /// Capture configured in the config file, if any
+    static let shared: ReserveCapture? = {
+        guard let options = RealtimeServerControllerWrapper.config.capture else { return nil }
+        return ReserveCapture(path: options.path, keyframeInterval: options.keyframeInterval ?? 1_000)
+    }()
+
+    private let writer: OpaquePointer
+    private let keyframeInterval: Int
+    private var blocksSinceKeyframe = 0
+    /// Adjacency list the capture follows. Deltas are relative to the previous block of the same list, so the first
+    /// store to record owns the capture.
+    private var source: ObjectIdentifier?
+    /// Last `record`, awaited by the next one. The actor is reentrant at its awaits, and a block has to be written before
+    /// the changes of the next one are consumed.
+    private var recording: Task<Void, Never>?
+
+    /// Ids of the tokens and exchanges in the capture, assigned in order of appearance
+    private var tokenIds = [Bytes: UInt16]()
+    private var exchangeIds = [AnyKeyPath: UInt16]()
+
+    init?(path: String, keyframeInterval: Int) {
+        guard let writer = capture_writer_open(path) else {
+            print("Couldn't open capture at \(path): \(String(cString: strerror(errno)))")
+            return nil
+        }
+        self.writer = writer
+        self.keyframeInterval = max(keyframeInterval, 1)
+    }
+
+    deinit {
+        capture_writer_close(writer)
+    }
+
+    /// Writes the entries of `adjacencyList` that changed since the previous block.
+    ///
+    /// Calls are written one at a time, in order. Blocks that are already in the capture are skipped, and their changes
+    /// are left for the next block. Other stores than the one the capture follows are ignored.
+    func record(block: UInt64, timestamp: UInt64, from adjacencyList: AdjacencyList) async {
+        let previous = recording
+        let task = Task {
+            await previous?.value
+            await write(block: block, timestamp: timestamp, from: adjacencyList)
+        }
+        recording = task
+        await task.value
+    }
+
+    private func write(block: UInt64, timestamp: UInt64, from adjacencyList: AdjacencyList) async {
+        let id = ObjectIdentifier(adjacencyList)
+        guard source == nil || source == id else { return }
+        // Checked before the changes are consumed, so that none are lost
+        guard block > capture_writer_last_block(writer) else { return }
+        source = id
+        let keyframe = blocksSinceKeyframe == 0
+        let infos = await adjacencyList.changes(all: keyframe)
+
+        // Tables have to be written before the block
+        let reserves = infos.compactMap { info -> capture_reserve_t? in
+            guard let meta = info.meta as? UniswapV2.RequiredPriceInfo else { return nil }
+            let (reserve0, reserve1) = info.metaReversed ? (meta.reserveB, meta.reserveA) : (meta.reserveA, meta.reserveB)
+            return capture_reserve_t(token0: tokenId(info.tokenA),
+                                     token1: tokenId(info.tokenB),
+                                     exchange: exchangeId(info),
+                                     fee: UInt16(truncatingIfNeeded: info.fee.words.first ?? 0),
+                                     reserve0: words(reserve0),
+                                     reserve1: words(reserve1),
+                                     spot01: info.spotAB ?? .nan,
+                                     spot10: info.spotBA ?? .nan)
+        }
+
+        guard capture_writer_begin_block(writer, block, timestamp, keyframe) else {
+            print("Couldn't capture block \(block): \(String(cString: strerror(errno)))")
+            return
+        }
+        for var reserve in reserves {
+            capture_writer_add_reserve(writer, &reserve)
+        }
+        guard capture_writer_end_block(writer) else {
+            print("Couldn't capture block \(block): \(String(cString: strerror(errno)))")
+            return
+        }
+        blocksSinceKeyframe = (blocksSinceKeyframe + 1) % keyframeInterval
+    }
+
+    // MARK: - Tables
+
+    private func tokenId(_ token: Token) -> UInt16 {
+        let address = token.address.rawAddress
+        if let id = tokenIds[address] {
+            return id
+        }
+        let id = UInt16(truncatingIfNeeded: tokenIds.count)
+        tokenIds[address] = id
+        capture_writer_add_token(writer, id, address, token.name, UInt8(clamping: token.decimals))
+        return id
+    }
+
+    private func exchangeId(_ info: ReserveFeeInfo) -> UInt16 {
+        if let id = exchangeIds[info.exchangeKey] {
+            return id
+        }
+        let id = UInt16(truncatingIfNeeded: exchangeIds.count)
+        exchangeIds[info.exchangeKey] = id
+        capture_writer_add_exchange(writer, id, ExchangesList.shared[keyPath: info.exchange.path].name)
+        return id
+    }
+
+    /// 128 low bits of a reserve, low word first
+    private func words(_ value: Euler.BigInt) -> (UInt64, UInt64) {
+        let words = value.words
+        return (words.count > 0 ? UInt64(words[0]) : 0, words.count > 1 ? UInt64(words[1]) : 0)
+    }
+}
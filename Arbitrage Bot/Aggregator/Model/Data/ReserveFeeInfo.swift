@@ -18,6 +18,8 @@ struct ReserveFeeInfo: CustomStringConvertible {
     let tokenB: Token
 
     let meta: Any
+    /// Whether `meta` was computed for `tokenB` → `tokenA`, i.e. its reserves are in the opposite order of `tokenA` / `tokenB`
+    let metaReversed: Bool
 
     var spotAB: Double? = nil
     var spotBA: Double? = nil
@@ -31,6 +33,7 @@ struct ReserveFeeInfo: CustomStringConvertible {
     init(exchangeKey: KeyPath<ExchangesList, any Exchange>, meta: Any, spot: Double, tokenA: Token, tokenB: Token, fee: Euler.BigInt) {
         self.exchangeKey = exchangeKey
         self.meta = meta
+        self.metaReversed = tokenB < tokenA
         self.spotAB = tokenA < tokenB ? spot : self.spotAB
         self.spotBA = tokenB < tokenA ? spot : self.spotBA
         self.fee = fee
@@ -0,0 +1,81 @@
+//
+//  StageTracer.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Native
+
+/// Records when each stage of the block-to-decision pipeline is done, per block.
+///
+/// Blocks are identified by their `systemTime`, the truncated block number passed along the whole pipeline.
+/// Durations go into the native histograms, and are published on the `latency` topic.
+enum StageTracer {
+    typealias Stage = latency_stage_t
+
+    static func mark(_ stage: Stage, systemTime: Int) {
+        latency_mark(UInt64(UInt32(truncatingIfNeeded: systemTime)), stage)
+    }
+
+    static func report() -> LatencyReport {
+        let stages = (0..<LATENCY_STAGE_COUNT.rawValue).map { rawValue in
+            let stage = Stage(rawValue: rawValue)
+            var own = latency_summary_t()
+            var sinceHead = latency_summary_t()
+            latency_summary(stage, false, &own)
+            latency_summary(stage, true, &sinceHead)
+            return LatencyReport.Stage(name: String(cString: latency_stage_name(stage)),
+                                       duration: .init(own),
+                                       sinceHead: .init(sinceHead))
+        }
+        return LatencyReport(stages: stages)
+    }
+
+    static func reset() {
+        latency_reset()
+    }
+}
+
+extension StageTracer.Stage {
+    static let head = LATENCY_STAGE_HEAD
+    static let reserves = LATENCY_STAGE_RESERVES
+    static let spotPicture = LATENCY_STAGE_SPOT_PICTURE
+    static let cycleSearch = LATENCY_STAGE_CYCLE_SEARCH
+    static let strategy = LATENCY_STAGE_STRATEGY
+    static let buildSteps = LATENCY_STAGE_BUILD_STEPS
+    static let optimalPrice = LATENCY_STAGE_OPTIMAL_PRICE
+    static let signed = LATENCY_STAGE_SIGNED
+}
+
+/// Percentiles of each pipeline stage, in milliseconds.
+struct LatencyReport: Codable {
+    struct Percentiles: Codable {
+        let count: UInt64
+        let p50: Double
+        let p99: Double
+        let p999: Double
+        let max: Double
+
+        init(_ summary: latency_summary_t) {
+            self.count = summary.count
+            self.p50 = Double(summary.p50) / 1e6
+            self.p99 = Double(summary.p99) / 1e6
+            self.p999 = Double(summary.p999) / 1e6
+            self.max = Double(summary.max) / 1e6
+        }
+    }
+
+    struct Stage: Codable {
+        let name: String
+        /// Time spent in the stage, since the previous stage of the block
+        let duration: Percentiles
+        /// Time elapsed since the head of the block arrived
+        let sinceHead: Percentiles
+    }
+
+    let stages: [Stage]
+    /// Latency of each RPC endpoint, when several are configured
+    var endpoints: [Web3ProviderPool.EndpointStats]? = nil
+}
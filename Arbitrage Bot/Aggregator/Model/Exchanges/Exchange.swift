@@ -88,7 +88,8 @@ public protocol Exchange: Hashable {
         meta: Meta
     ) -> Euler.BigInt
 
-    func meanPrice(storeId: Int, tokenA: Token, tokenB: Token) async throws -> Quote
+    /// Computes the spot price and stores it in the price data store. When `meta` is given (e.g. prefetched reserves), no call is made to the chain.
+    func meanPrice(storeId: Int, tokenA: Token, tokenB: Token, meta: Meta?) async throws -> Quote
 }
 
 extension Exchange {
@@ -102,7 +103,11 @@ extension Exchange {
     }
 
     func meanPrice(storeId: Int, tokenA: Token, tokenB: Token) async throws -> Quote {
-        let (quote, meta) = try await self.getQuote(maxAvailableAmount: nil, tokenA: tokenA, tokenB: tokenB, maximizeB: true, meta: nil)
+        return try await meanPrice(storeId: storeId, tokenA: tokenA, tokenB: tokenB, meta: nil)
+    }
+
+    func meanPrice(storeId: Int, tokenA: Token, tokenB: Token, meta: Meta?) async throws -> Quote {
+        let (quote, meta) = try await self.getQuote(maxAvailableAmount: nil, tokenA: tokenA, tokenB: tokenB, maximizeB: true, meta: meta)
 
         // Store in PriceDataStore
         if let store = priceDataStores[storeId] {
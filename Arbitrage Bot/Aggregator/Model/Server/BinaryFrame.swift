@@ -0,0 +1,145 @@
+//
+//  BinaryFrame.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Euler
+
+/// Binary encoding of the streamed updates, sent to the clients that negotiated the `arbitrage-bot.v1` subprotocol.
+///
+/// Every frame starts with an 8 bytes header: `kind: u8`, `version: u8`, `flags: u16`, `length: u32` (of the payload).
+/// All numbers are little-endian, missing doubles are NaN, strings are prefixed by their `u8` byte length.
+/// Frames are encoded without flags: the server deflates large ones when publishing them, and sets
+/// `COMPRESSION_FRAME_DEFLATED` (see `compression.h`). The decoder lives in `lib/client.tsx`.
+enum BinaryFrame {
+    static let version: UInt8 = 1
+
+    enum Kind: UInt8 {
+        /// `price, transactionPrice, ask, bid, ttf, amount, amountOut: f64`, `decimals: u8`, `tokenA, tokenB: [u8; 20]`,
+        /// then `exchangeName, tokenA.name, tokenB.name: str`
+        case quote = 1
+        /// `timestamp (ms), startAmount, profit, fees: f64`, `txHash: [u8; 32]` (zeros if unknown), `token: str`,
+        /// `count: u8`, then `count` times `exchange, token: str`
+        case decision = 2
+        /// `size: u32`, `size` token addresses `[u8; 20]`, then the `size * size` rates `f64`, row by row
+        case matrixSnapshot = 3
+        /// `size: u32`, `count: u32`, then `count` times `index: u32, rate: f64`. Only sent while `size` doesn't change
+        case matrixDelta = 4
+    }
+
+    /// Frame of a streamed response, `nil` if it has no binary form (errors, latency reports...)
+    static func encode(_ response: BotResponse) -> Bytes? {
+        guard response.status == .success else { return nil }
+        switch response.topic {
+        case .priceData:
+            return response.quote.map(quote)
+        case .decision:
+            return response.executedTrade.map(decision)
+        default:
+            return nil
+        }
+    }
+
+    static func quote(_ quote: Quote) -> Bytes {
+        var writer = Writer(kind: .quote)
+        writer.write(quote.price.asDouble())
+        writer.write(quote.transactionPrice.asDouble())
+        writer.write(quote.ask)
+        writer.write(quote.bid)
+        writer.write(quote.ttf)
+        writer.write(BigDouble(quote.amount).asDouble())
+        writer.write(BigDouble(quote.amountOut).asDouble())
+        writer.bytes.append(UInt8(clamping: quote.decimals))
+        writer.bytes.append(contentsOf: quote.tokenA.address.rawAddress)
+        writer.bytes.append(contentsOf: quote.tokenB.address.rawAddress)
+        writer.write(quote.exchangeName)
+        writer.write(quote.tokenA.name)
+        writer.write(quote.tokenB.name)
+        return writer.finish()
+    }
+
+    static func decision(_ trade: Trade) -> Bytes {
+        var writer = Writer(kind: .decision)
+        writer.write(trade.timestamp.timeIntervalSince1970 * 1000)
+        writer.write(trade.startAmount)
+        writer.write(trade.profit)
+        writer.write(trade.fees)
+        let hash = trade.txHash.flatMap { try? EthereumData(ethereumValue: $0).bytes } ?? []
+        writer.bytes.append(contentsOf: hash.count == 32 ? hash : Bytes(repeating: 0, count: 32))
+        writer.write(trade.token)
+        let route = trade.route.prefix(Int(UInt8.max))
+        writer.bytes.append(UInt8(route.count))
+        for step in route {
+            writer.write(step.exchange)
+            writer.write(step.token)
+        }
+        return writer.finish()
+    }
+
+    static func matrixSnapshot(_ rates: [Double], tokens: [Token]) -> Bytes {
+        var writer = Writer(kind: .matrixSnapshot)
+        writer.bytes.reserveCapacity(16 + tokens.count * 20 + rates.count * 8)
+        writer.write(UInt32(tokens.count))
+        for token in tokens {
+            writer.bytes.append(contentsOf: token.address.rawAddress)
+        }
+        for rate in rates {
+            writer.write(rate)
+        }
+        return writer.finish()
+    }
+
+    /// Rates of `rates` that differ from `previous`, `nil` when the matrix was resized and needs a snapshot
+    static func matrixDelta(_ rates: [Double], previous: [Double], size: Int) -> Bytes? {
+        guard rates.count == previous.count, rates.count == size * size else { return nil }
+        var writer = Writer(kind: .matrixDelta)
+        writer.write(UInt32(size))
+        let countOffset = writer.bytes.count
+        writer.write(UInt32(0))
+        var count: UInt32 = 0
+        for i in rates.indices where rates[i].bitPattern != previous[i].bitPattern {
+            writer.write(UInt32(i))
+            writer.write(rates[i])
+            count += 1
+        }
+        writer.patch(count, at: countOffset)
+        return writer.finish()
+    }
+
+    // MARK: - Writer
+
+    private struct Writer {
+        var bytes: Bytes
+
+        init(kind: Kind) {
+            bytes = [kind.rawValue, BinaryFrame.version, 0, 0, 0, 0, 0, 0]
+        }
+
+        mutating func write(_ value: UInt32) {
+            withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) }
+        }
+
+        mutating func write(_ value: Double?) {
+            withUnsafeBytes(of: (value ?? .nan).bitPattern.littleEndian) { bytes.append(contentsOf: $0) }
+        }
+
+        mutating func write(_ string: String) {
+            let utf8 = Array(string.utf8.prefix(Int(UInt8.max)))
+            bytes.append(UInt8(utf8.count))
+            bytes.append(contentsOf: utf8)
+        }
+
+        mutating func patch(_ value: UInt32, at offset: Int) {
+            withUnsafeBytes(of: value.littleEndian) { bytes.replaceSubrange(offset..<offset + 4, with: $0) }
+        }
+
+        /// Fills in the payload length
+        mutating func finish() -> Bytes {
+            patch(UInt32(bytes.count - 8), at: 4)
+            return bytes
+        }
+    }
+}
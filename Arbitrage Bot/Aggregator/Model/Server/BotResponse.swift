@@ -19,6 +19,7 @@ public struct BotResponse: Sendable, Codable {
     public var queryTime: Duration? = nil
     var quote: Quote? = nil
     var executedTrade: Trade? = nil
+    var latency: LatencyReport? = nil
     
     var shouldSilent = false
     
@@ -53,6 +54,7 @@ public struct BotResponse: Sendable, Codable {
         try container.encodeIfPresent(self.queryTime?.ms, forKey: .queryTime)
         try container.encodeIfPresent(self.quote, forKey: .quote)
         try container.encodeIfPresent(self.executedTrade, forKey: .executedTrade)
+        try container.encodeIfPresent(self.latency, forKey: .latency)
     }
 
     public func toJSON() throws -> String {
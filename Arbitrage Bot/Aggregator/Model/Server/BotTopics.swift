@@ -12,5 +12,5 @@ public enum BotMessageType: String, Codable {
 }
 
 public enum BotTopic: String, Codable, Sendable {
-    case priceData, decision, reset, buy, environment, none
+    case priceData, decision, reset, buy, environment, latency, matrix, none
 }
@@ -18,24 +18,15 @@ extension Data {
     }
     
     func toHexString() -> String {
-        return self.map { String(format: "%02x", $0) }.joined()
+        return Array(self).hexString(prefix: false)
     }
 }
 
 extension Array where Element == UInt8 {
     init(hex: String) {
-        self.init()
-        let hex = hex.drop0x
-        var startIndex = hex.startIndex
-        while startIndex < hex.endIndex {
-            let endIndex = hex.index(after: hex.index(after: startIndex))
-            let bytes = hex[startIndex..<endIndex]
-            if let byte = UInt8(bytes, radix: 16) {
-                self.append(byte)
-            } else {
-                fatalError("Invalid hex string")
-            }
-            startIndex = endIndex
+        guard let bytes = try? hex.hexBytes() else {
+            fatalError("Invalid hex string")
         }
+        self = bytes
     }
 }
@@ -18,6 +18,23 @@ public extension Web3 {
     }
 }
 
+public extension Web3Provider {
+    
+    /// Sends the requests as a single JSON-RPC batch, throwing if any of them failed.
+    func send<Params, Result>(batch requests: [RPCRequest<Params>]) async throws -> [Result] {
+        let responses: [Web3Response<Result>] = await withCheckedContinuation { continuation in
+            self.send(batch: requests) { responses in
+                continuation.resume(returning: responses)
+            }
+        }
+        return try responses.map { response in
+            if let error = response.error { throw error }
+            guard let result = response.result else { throw Web3Response<Result>.Error.emptyResponse }
+            return result
+        }
+    }
+}
+
 public extension Web3.Net {
     
     func version() async throws -> String {
@@ -175,6 +192,14 @@ public extension Web3.Eth {
         }
     }
     
+    func sendRawTransaction(raw: EthereumData) async throws -> EthereumData {
+        try await withCheckedThrowingContinuation { continuation in
+            self.sendRawTransaction(raw: raw) { response in
+                response.sealContinuation(continuation)
+            }
+        }
+    }
+    
     func sendTransaction(transaction: EthereumTransaction) async throws -> EthereumData {
         try await withCheckedThrowingContinuation { continuation in
             self.sendTransaction(transaction: transaction) { response in
@@ -13,11 +13,12 @@ public struct ABI {
     // MARK: - Encoding
     
     public static func encodeFunctionSignature(_ function: SolidityFunction) -> String {
-        return "0x" + String(function.signature.sha3(.keccak256).prefix(8))
+        let hash = Array(function.signature.utf8).keccak256()
+        return Array(hash[0..<4]).hexString(prefix: true)
     }
     
     public static func encodeEventSignature(_ event: SolidityEvent) -> String {
-        return "0x" + event.signature.sha3(.keccak256)
+        return Array(event.signature.utf8).keccak256().hexString(prefix: true)
     }
     
     public static func encodeParameter(type: SolidityType, value: ABIEncodable) throws -> String {
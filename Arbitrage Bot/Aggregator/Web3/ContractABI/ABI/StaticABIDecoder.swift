@@ -0,0 +1,133 @@
+//
+//  StaticABIDecoder.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import BigInt
+import Euler
+
+/// Unsigned 256-bit integer, stored as four 64-bit limbs (least significant first).
+///
+/// ABI words fit without any allocation, conversion to a big integer only happens when needed.
+public struct UInt256: Hashable {
+    public var limbs: (UInt64, UInt64, UInt64, UInt64)
+
+    public static let zero = UInt256(limbs: (0, 0, 0, 0))
+
+    public init(limbs: (UInt64, UInt64, UInt64, UInt64)) {
+        self.limbs = limbs
+    }
+
+    public init(_ value: UInt64) {
+        self.limbs = (value, 0, 0, 0)
+    }
+
+    /// Reads a big-endian 32-byte word.
+    @inline(__always)
+    init(word pointer: UnsafeRawPointer) {
+        self.limbs = (
+            UInt64(bigEndian: pointer.loadUnaligned(fromByteOffset: 24, as: UInt64.self)),
+            UInt64(bigEndian: pointer.loadUnaligned(fromByteOffset: 16, as: UInt64.self)),
+            UInt64(bigEndian: pointer.loadUnaligned(fromByteOffset: 8, as: UInt64.self)),
+            UInt64(bigEndian: pointer.loadUnaligned(fromByteOffset: 0, as: UInt64.self))
+        )
+    }
+
+    /// Number of significant bits.
+    public var bitWidth: Int {
+        if limbs.3 != 0 { return 256 - limbs.3.leadingZeroBitCount }
+        if limbs.2 != 0 { return 192 - limbs.2.leadingZeroBitCount }
+        if limbs.1 != 0 { return 128 - limbs.1.leadingZeroBitCount }
+        return 64 - limbs.0.leadingZeroBitCount
+    }
+
+    public var biguint: BigUInt {
+        BigUInt(words: [UInt(limbs.0), UInt(limbs.1), UInt(limbs.2), UInt(limbs.3)])
+    }
+
+    var euler: Euler.BigInt {
+        Euler.BigInt(sign: false, words: [UInt(limbs.0), UInt(limbs.1), UInt(limbs.2), UInt(limbs.3)])
+    }
+
+    public static func == (lhs: UInt256, rhs: UInt256) -> Bool {
+        lhs.limbs.0 == rhs.limbs.0 && lhs.limbs.1 == rhs.limbs.1 && lhs.limbs.2 == rhs.limbs.2 && lhs.limbs.3 == rhs.limbs.3
+    }
+
+    public func hash(into hasher: inout Hasher) {
+        hasher.combine(limbs.0)
+        hasher.combine(limbs.1)
+        hasher.combine(limbs.2)
+        hasher.combine(limbs.3)
+    }
+}
+
+/// A return value made of static words only (no bytes, strings or dynamic arrays), whose layout is known at compile time.
+public protocol StaticABIDecodable {
+    /// Number of 32-byte words in the encoding
+    static var wordCount: Int { get }
+
+    init(from decoder: StaticABIDecoder) throws
+}
+
+/// Decodes static ABI words straight from bytes, without going through hex strings or `[String: Any]`.
+///
+/// Use `ABIDecoder` for anything with a dynamic type.
+public struct StaticABIDecoder {
+    public enum Error: Swift.Error {
+        case tooShort(expected: Int, got: Int)
+        case outOfRange(word: Int, bits: Int)
+    }
+
+    private let base: UnsafeRawPointer
+
+    private init(base: UnsafeRawPointer) {
+        self.base = base
+    }
+
+    /// Decodes `T` from `bytes`, which must hold at least `T.wordCount` words. Trailing bytes are ignored.
+    public static func decode<T: StaticABIDecodable, C: ContiguousBytes>(_ type: T.Type, from bytes: C) throws -> T {
+        try bytes.withUnsafeBytes { buffer in
+            guard buffer.count >= T.wordCount * 32, let base = buffer.baseAddress else {
+                throw Error.tooShort(expected: T.wordCount * 32, got: buffer.count)
+            }
+            return try T(from: StaticABIDecoder(base: base))
+        }
+    }
+
+    // MARK: - Words
+
+    @inline(__always)
+    public func uint256(at index: Int) -> UInt256 {
+        UInt256(word: base + index * 32)
+    }
+
+    /// `uintN` with N <= 64
+    @inline(__always)
+    public func uint64(at index: Int, bits: Int = 64) throws -> UInt64 {
+        let word = uint256(at: index)
+        guard word.bitWidth <= bits else { throw Error.outOfRange(word: index, bits: bits) }
+        return word.limbs.0
+    }
+
+    /// `uintN` with N <= 256, checking the padding
+    @inline(__always)
+    public func uint(at index: Int, bits: Int) throws -> UInt256 {
+        let word = uint256(at: index)
+        guard word.bitWidth <= bits else { throw Error.outOfRange(word: index, bits: bits) }
+        return word
+    }
+
+    @inline(__always)
+    public func bool(at index: Int) throws -> Bool {
+        try uint64(at: index, bits: 1) == 1
+    }
+
+    public func address(at index: Int) throws -> EthereumAddress {
+        _ = try uint(at: index, bits: 160)
+        let start = base + index * 32 + 12
+        return try EthereumAddress(rawAddress: Array(UnsafeRawBufferPointer(start: start, count: 20)))
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  FastJSON.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Native
+
+/// Swift side of the native on-demand JSON scanner (`fast_json.h`).
+///
+/// Only the fields we need are extracted from the hot messages (routing information, newHeads, logs, `eth_call` results),
+/// without going through `JSONDecoder` and the intermediate `RPCResponse` / `EthereumValue` trees.
+enum FastJSON {
+    enum Message {
+        case response(id: Int)
+        case batch(firstId: Int)
+        case notification(subscription: String)
+    }
+
+    struct NewHead {
+        let number: UInt64
+        let timestamp: UInt64
+        let baseFeePerGas: UInt64
+        let hash: String
+    }
+
+    struct Log {
+        let address: EthereumAddress
+        let data: Bytes
+        let topics: [EthereumData]
+        let blockNumber: UInt64
+        let logIndex: UInt64
+        let removed: Bool
+    }
+
+    // MARK: - Routing
+
+    /// Finds out where a message should be routed to.
+    static func scan(_ json: String) -> Message? {
+        var json = json
+        return json.withUTF8 { buffer in
+            var message = fj_message()
+            guard let base = buffer.baseAddress,
+                  base.withMemoryRebound(to: CChar.self, capacity: buffer.count, { fj_scan_message($0, buffer.count, &message) }) else {
+                return nil
+            }
+            switch message.kind {
+            case FJ_MESSAGE_RESPONSE:
+                return .response(id: Int(message.id))
+            case FJ_MESSAGE_BATCH:
+                return .batch(firstId: Int(message.id))
+            case FJ_MESSAGE_NOTIFICATION:
+                return .notification(subscription: string(message.subscription))
+            default:
+                return nil
+            }
+        }
+    }
+
+    // MARK: - Payloads
+
+    /// Result of an `eth_call` (or any call returning `DATA`) response. `nil` if the response is an error.
+    static func callResult(_ response: String) -> EthereumData? {
+        return withMessage(response) { message in
+            guard message.kind == FJ_MESSAGE_RESPONSE, message.error.len == 0, message.result.ptr != nil else { return nil }
+            return try? EthereumData(string(message.result).hexBytes())
+        }
+    }
+
+    /// Block header of a `newHeads` notification.
+    static func newHead(_ notification: String) -> NewHead? {
+        return withMessage(notification) { message in
+            guard message.kind == FJ_MESSAGE_NOTIFICATION, let result = message.result.ptr else { return nil }
+            var head = fj_new_head()
+            guard fj_parse_new_head(result, message.result.len, &head) else { return nil }
+            return NewHead(number: head.number,
+                           timestamp: head.timestamp,
+                           baseFeePerGas: head.base_fee_per_gas,
+                           hash: string(head.hash))
+        }
+    }
+
+    /// Log of a `logs` notification.
+    static func log(_ notification: String) -> Log? {
+        return withMessage(notification) { message in
+            guard message.kind == FJ_MESSAGE_NOTIFICATION, let result = message.result.ptr else { return nil }
+            var log = fj_log()
+            guard fj_parse_log(result, message.result.len, &log) else { return nil }
+            guard let address = try? EthereumAddress(hex: string(log.address), eip55: false),
+                  let data = try? string(log.data).hexBytes() else { return nil }
+            let topics = withUnsafeBytes(of: log.topics) { raw in
+                raw.bindMemory(to: fj_slice.self)
+                    .prefix(log.topic_count)
+                    .compactMap { try? EthereumData(string($0).hexBytes()) }
+            }
+            return Log(address: address, data: data, topics: topics, blockNumber: log.block_number, logIndex: log.log_index, removed: log.removed)
+        }
+    }
+
+    // MARK: - Helpers
+
+    private static func withMessage<T>(_ json: String, _ body: (fj_message) -> T?) -> T? {
+        var json = json
+        return json.withUTF8 { buffer in
+            guard let base = buffer.baseAddress else { return nil }
+            return base.withMemoryRebound(to: CChar.self, capacity: buffer.count) { pointer in
+                var message = fj_message()
+                guard fj_scan_message(pointer, buffer.count, &message) else { return nil }
+                return body(message)
+            }
+        }
+    }
+
+    private static func string(_ slice: fj_slice) -> String {
+        guard let pointer = slice.ptr else { return "" }
+        return String(decoding: UnsafeRawBufferPointer(start: pointer, count: slice.len), as: UTF8.self)
+    }
+}
@@ -12,6 +12,30 @@ public protocol Web3Provider {
     typealias Web3ResponseCompletion<Result: Codable> = (_ resp: Web3Response<Result>) -> Void
 
     func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>)
+
+    /// Sends several requests of the same kind at once. Responses are returned in the order of the requests.
+    func send<Params, Result>(batch requests: [RPCRequest<Params>], response: @escaping (_ responses: [Web3Response<Result>]) -> Void)
+}
+
+extension Web3Provider {
+    /// Default implementation for providers without batch support: requests are sent one by one.
+    public func send<Params, Result>(batch requests: [RPCRequest<Params>], response: @escaping (_ responses: [Web3Response<Result>]) -> Void) {
+        let group = DispatchGroup()
+        let lock = NSLock()
+        var responses = [Web3Response<Result>?](repeating: nil, count: requests.count)
+        for (i, request) in requests.enumerated() {
+            group.enter()
+            send(request: request) { (resp: Web3Response<Result>) in
+                lock.lock()
+                responses[i] = resp
+                lock.unlock()
+                group.leave()
+            }
+        }
+        group.notify(queue: .global()) {
+            response(responses.map { $0 ?? Web3Response<Result>(error: .emptyResponse) })
+        }
+    }
 }
 
 public protocol Web3BidirectionalProvider: Web3Provider {
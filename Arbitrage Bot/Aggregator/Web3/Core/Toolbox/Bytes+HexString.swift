@@ -7,22 +7,24 @@
 
 import Foundation
 
-fileprivate let hexMapping = Array("0123456789abcdef")
+import Native
 
 extension Array where Element == Byte {
 
     func hexString(prefix: Bool) -> String {
-        var charArray: [String.Element] = [String.Element](repeating: "0", count: self.count * 2)
-
-        for i in 0..<self.count {
-            charArray[i * 2] = hexMapping[Int(self[i]) / 16]
-            charArray[(i * 2) + 1] = hexMapping[Int(self[i]) % 16]
-        }
-
-        if prefix {
-            return "0x\(String(charArray))"
-        } else {
-            return String(charArray)
+        let offset = prefix ? 2 : 0
+        return String(unsafeUninitializedCapacity: offset + count * 2) { buffer in
+            if prefix {
+                buffer[0] = UInt8(ascii: "0")
+                buffer[1] = UInt8(ascii: "x")
+            }
+            self.withUnsafeBufferPointer { bytes in
+                guard !bytes.isEmpty, let src = bytes.baseAddress else { return }
+                buffer.baseAddress!.advanced(by: offset).withMemoryRebound(to: CChar.self, capacity: bytes.count * 2) { dst in
+                    hex_encode(src, bytes.count, dst)
+                }
+            }
+            return offset + count * 2
         }
     }
 
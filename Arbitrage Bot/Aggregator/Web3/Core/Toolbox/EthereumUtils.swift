@@ -20,14 +20,13 @@ public struct EthereumUtils {
         concat.append(contentsOf: salt)
         concat.append(contentsOf: initCodeHash)
 
-        let hash = concat.sha3(.keccak256)
-        let hexSlice = Array(hash[12...])
+        let hash = concat.keccak256()
 
-        return try EthereumAddress(hex: hexSlice.toHexString(), eip55: false)
+        return try EthereumAddress(rawAddress: Array(hash[12...]))
     }
 
     public static func getCreate2Address(from: EthereumAddress, salt: [UInt8], initCode: [UInt8]) throws -> EthereumAddress {
-        let initCodeHash = initCode.sha3(.keccak256)
+        let initCodeHash = initCode.keccak256()
         return try getCreate2Address(from: from, salt: salt, initCodeHash: initCodeHash)
     }
 }
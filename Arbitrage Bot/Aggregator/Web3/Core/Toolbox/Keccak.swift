@@ -0,0 +1,44 @@
+//
+//  Keccak.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Native
+
+/// Keccak-256 backed by the native implementation.
+enum Keccak {
+    static let digestLength = Int(KECCAK256_DIGEST_LENGTH)
+
+    static func hash256(_ bytes: UnsafeRawBufferPointer) -> Bytes {
+        Bytes(unsafeUninitializedCapacity: digestLength) { digest, initialized in
+            keccak256(bytes.baseAddress?.assumingMemoryBound(to: UInt8.self), bytes.count, digest.baseAddress!)
+            initialized = digestLength
+        }
+    }
+
+    /// Hashes `inputs.count / length` inputs of `length` bytes each, stored back to back.
+    ///
+    /// Short inputs are hashed four at a time, which is much faster than hashing them one by one (pair salts, CREATE2 preimages...).
+    /// - Returns: The digests, back to back, in input order.
+    static func hash256(batch inputs: Bytes, length: Int) -> Bytes {
+        precondition(length > 0 && inputs.count % length == 0, "Batch inputs must have the same length")
+        let count = inputs.count / length
+        guard count > 0 else { return Bytes() }
+        return Bytes(unsafeUninitializedCapacity: count * digestLength) { digests, initialized in
+            inputs.withUnsafeBufferPointer { inputs in
+                keccak256_batch(inputs.baseAddress, length, count, digests.baseAddress!)
+            }
+            initialized = count * digestLength
+        }
+    }
+}
+
+extension Array where Element == UInt8 {
+    /// Keccak-256 digest of the bytes
+    func keccak256() -> Bytes {
+        withUnsafeBytes { Keccak.hash256($0) }
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  ShardedDictionary.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+
+/// Thread safe dictionary split in independently locked shards.
+///
+/// Unlike `SynchronizedDictionary`, writes don't go through a barrier on a single queue: concurrent accesses
+/// only contend when their keys land in the same shard, and the critical sections are a plain dictionary access.
+public final class ShardedDictionary<KeyType: Hashable, ValueType> {
+
+    private final class Shard {
+        let lock = NSLock()
+        var storage = [KeyType: ValueType]()
+    }
+
+    private let shards: [Shard]
+
+    public init(shardCount: Int = 16) {
+        self.shards = (0..<max(shardCount, 1)).map { _ in Shard() }
+    }
+
+    private func shard(for key: KeyType) -> Shard {
+        let index = Int(UInt(bitPattern: key.hashValue) % UInt(shards.count))
+        return shards[index]
+    }
+
+    public var count: Int {
+        shards.reduce(0) { count, shard in
+            shard.lock.lock()
+            defer { shard.lock.unlock() }
+            return count + shard.storage.count
+        }
+    }
+
+    public subscript(key: KeyType) -> ValueType? {
+        get {
+            let shard = shard(for: key)
+            shard.lock.lock()
+            defer { shard.lock.unlock() }
+            return shard.storage[key]
+        }
+        set {
+            let shard = shard(for: key)
+            shard.lock.lock()
+            defer { shard.lock.unlock() }
+            shard.storage[key] = newValue
+        }
+    }
+
+    /// Removes and returns the value, atomically. Only one of several concurrent callers gets the value.
+    @discardableResult
+    public func removeValue(forKey key: KeyType) -> ValueType? {
+        let shard = shard(for: key)
+        shard.lock.lock()
+        defer { shard.lock.unlock() }
+        return shard.storage.removeValue(forKey: key)
+    }
+
+    /// Empties the dictionary, returning the values that were stored.
+    public func removeAll() -> [ValueType] {
+        var values = [ValueType]()
+        for shard in shards {
+            shard.lock.lock()
+            values.append(contentsOf: shard.storage.values)
+            shard.storage.removeAll()
+            shard.lock.unlock()
+        }
+        return values
+    }
+}
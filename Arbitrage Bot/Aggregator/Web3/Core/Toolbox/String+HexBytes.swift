@@ -6,58 +6,22 @@
 //
 
 import Foundation
-
-fileprivate let hexMapping: [String.Element: UInt8] = [
-    "0": 0b0000,
-    "1": 0b0001,
-    "2": 0b0010,
-    "3": 0b0011,
-    "4": 0b0100,
-    "5": 0b0101,
-    "6": 0b0110,
-    "7": 0b0111,
-    "8": 0b1000,
-    "9": 0b1001,
-
-    "a": 0b1010,
-    "b": 0b1011,
-    "c": 0b1100,
-    "d": 0b1101,
-    "e": 0b1110,
-    "f": 0b1111,
-
-    "A": 0b1010,
-    "B": 0b1011,
-    "C": 0b1100,
-    "D": 0b1101,
-    "E": 0b1110,
-    "F": 0b1111
-]
+import Native
 
 extension String {
 
     /// Convert a hex string "0xFF" or "FF" to Bytes
     func hexBytes() throws -> Bytes {
         var string = self
-
-        if string.count >= 2 {
-            let pre = string.startIndex
-            let post = string.index(string.startIndex, offsetBy: 2)
-            if String(string[pre..<post]) == "0x" {
+        return try string.withUTF8 { utf8 in
+            var chars = UnsafeRawBufferPointer(utf8)[...]
+            if chars.count >= 2 && chars[0] == UInt8(ascii: "0") && chars[1] == UInt8(ascii: "x") {
                 // Remove prefix
-                string = String(string[post...])
+                chars = chars.dropFirst(2)
             }
+            // Hex strings can omit the leading 0
+            return try Self.decodeHex(UnsafeRawBufferPointer(rebasing: chars), padded: chars.count % 2 != 0)
         }
-
-        // Check if we have a complete byte
-        guard !string.isEmpty else {
-            return Bytes()
-        }
-
-        //normalize string, since hex strings can omit leading 0
-        string = string.count % 2 == 0 ? string : "0" + string
-
-        return try string.rawHex()
     }
 
     func quantityHexBytes() throws -> Bytes {
@@ -98,18 +62,44 @@ extension String {
     }
 
     private func rawHex() throws -> Bytes {
-        let charArray = Array(self)
+        var string = self
+        return try string.withUTF8 { utf8 in
+            guard utf8.count % 2 == 0 else { throw StringHexBytesError.hexStringMalformed }
+            return try Self.decodeHex(UnsafeRawBufferPointer(utf8), padded: false)
+        }
+    }
 
-        var bytes = Bytes()
-        for i in stride(from: 0, to: charArray.count, by: 2) {
-            guard let higher = hexMapping[charArray[i]], let lower = hexMapping[charArray[i + 1]] else {
+    /// Decodes hex characters (without prefix) with the vectorized codec.
+    /// - Parameter padded: When `true`, an implicit "0" is prepended to the odd-length `chars`.
+    private static func decodeHex(_ chars: UnsafeRawBufferPointer, padded: Bool) throws -> Bytes {
+        guard !chars.isEmpty, var src = chars.baseAddress?.assumingMemoryBound(to: CChar.self) else {
+            return Bytes()
+        }
+        var remaining = chars.count
+        let count = (remaining + 1) / 2
+        return try Bytes(unsafeUninitializedCapacity: count) { buffer, initialized in
+            var dst = buffer.baseAddress!
+            if padded {
+                guard let nibble = hexNibble(chars[0]) else { throw StringHexBytesError.hexStringMalformed }
+                dst.pointee = nibble
+                dst += 1
+                src += 1
+                remaining -= 1
+            }
+            guard hex_decode(src, remaining / 2, dst) else {
                 throw StringHexBytesError.hexStringMalformed
             }
-            let byte: UInt8 = (higher << 4) | lower
-            bytes.append(byte)
+            initialized = count
         }
+    }
 
-        return bytes
+    private static func hexNibble(_ char: UInt8) -> UInt8? {
+        switch char {
+        case UInt8(ascii: "0")...UInt8(ascii: "9"): return char - UInt8(ascii: "0")
+        case UInt8(ascii: "a")...UInt8(ascii: "f"): return char - UInt8(ascii: "a") + 10
+        case UInt8(ascii: "A")...UInt8(ascii: "F"): return char - UInt8(ascii: "A") + 10
+        default: return nil
+        }
     }
 }
 
@@ -6,7 +6,6 @@
 //
 
 import Foundation
-import CryptoSwift
 
 public struct EthereumAddress {
 
@@ -74,7 +73,7 @@ public struct EthereumAddress {
         // EIP 55 checksum
         // See: https://github.com/ethereum/EIPs/blob/master/EIPS/eip-55.md
         if eip55 {
-            let hash = SHA3(variant: .keccak256).calculate(for: Array(hex.lowercased().utf8))
+            let hash = Array(hex.lowercased().utf8).keccak256()
 
             for i in 0..<hex.count {
                 let charString = String(hex[hex.index(hex.startIndex, offsetBy: i)])
@@ -135,7 +134,7 @@ public struct EthereumAddress {
             for b in rawAddress {
                 address += String(format: "%02x", b)
             }
-            let hash = SHA3(variant: .keccak256).calculate(for: Array(address.utf8))
+            let hash = Array(address.utf8).keccak256()
 
             for i in 0..<address.count {
                 let charString = String(address[address.index(address.startIndex, offsetBy: i)])
@@ -7,7 +7,6 @@
 
 import Foundation
 import secp256k1
-import CryptoSwift
 
 public final class EthereumPrivateKey {
 
@@ -50,7 +49,7 @@ public final class EthereumPrivateKey {
         guard let bytes = Bytes.secureRandom(count: Int(rand)) else {
             throw Error.internalError
         }
-        let bytesHash = SHA3(variant: .keccak256).calculate(for: bytes)
+        let bytesHash = bytes.keccak256()
 
         try self.init(privateKey: bytesHash)
     }
@@ -212,7 +211,7 @@ public final class EthereumPrivateKey {
     // MARK: - Convenient functions
 
     public func sign(message: Bytes) throws -> (v: UInt, r: Bytes, s: Bytes) {
-        let hash = SHA3(variant: .keccak256).calculate(for: message)
+        let hash = message.keccak256()
         return try sign(hash: hash)
     }
 
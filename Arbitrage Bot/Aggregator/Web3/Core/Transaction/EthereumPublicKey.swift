@@ -7,7 +7,6 @@
 
 import Foundation
 import secp256k1
-import CryptoSwift
 import BigInt
 
 public final class EthereumPublicKey {
@@ -83,7 +82,7 @@ public final class EthereumPublicKey {
         self.ctx = finalCtx
 
         // Generate associated ethereum address
-        var hash = SHA3(variant: .keccak256).calculate(for: publicKey)
+        var hash = publicKey.keccak256()
         guard hash.count == 32 else {
             throw Error.internalError
         }
@@ -171,7 +170,7 @@ public final class EthereumPublicKey {
         defer {
             free(pubkey)
         }
-        var hash = SHA3(variant: .keccak256).calculate(for: rawSig)
+        var hash = rawSig.keccak256()
         guard hash.count == 32 else {
             throw Error.internalError
         }
@@ -190,7 +189,7 @@ public final class EthereumPublicKey {
         self.rawPublicKey = rawPubKey
 
         // Generate associated ethereum address
-        var pubHash = SHA3(variant: .keccak256).calculate(for: rawPubKey)
+        var pubHash = rawPubKey.keccak256()
         guard pubHash.count == 32 else {
             throw Error.internalError
         }
@@ -281,7 +280,7 @@ public final class EthereumPublicKey {
         }
 
         // Check validity with signature
-        var hash = SHA3(variant: .keccak256).calculate(for: message)
+        var hash = message.keccak256()
         guard hash.count == 32 else {
             throw Error.internalError
         }
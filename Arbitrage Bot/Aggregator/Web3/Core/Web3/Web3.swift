@@ -315,6 +315,21 @@ public struct Web3 {
             properties.provider.send(request: req, response: response)
         }
 
+        /// Sends a transaction that was already RLP-encoded and signed
+        public func sendRawTransaction(
+            raw: EthereumData,
+            response: @escaping Web3ResponseCompletion<EthereumData>
+        ) {
+            let req = BasicRPCRequest(
+                id: properties.rpcId,
+                jsonrpc: Web3.jsonrpc,
+                method: "eth_sendRawTransaction",
+                params: [raw]
+            )
+
+            properties.provider.send(request: req, response: response)
+        }
+
         public func call(
             call: EthereumCall,
             block: EthereumQuantityTag,
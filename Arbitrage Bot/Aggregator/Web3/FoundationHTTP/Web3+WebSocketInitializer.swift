@@ -10,4 +10,17 @@ public extension Web3 {
     init(wsUrl: String) throws {
         try self.init(provider: Web3WebSocketProvider(wsUrl: wsUrl), rpcId: 1)
     }
+    
+    /**
+     * Initializes a new instance of `Web3` with several WebSocket RPC endpoints, hedging requests between them (see `Web3ProviderPool`).
+     *
+     * - parameter wsUrls: The URLs of the WebSocket RPC APIs.
+     */
+    init(wsUrls: [String]) throws {
+        guard wsUrls.count > 1 else {
+            try self.init(wsUrl: wsUrls.first ?? "")
+            return
+        }
+        try self.init(provider: Web3ProviderPool(wsUrls: wsUrls), rpcId: 1)
+    }
 }
@@ -0,0 +1,357 @@
+//
+//  Web3ProviderPool.swift
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import Foundation
+import Dispatch
+
+/// Keeps connections to several endpoints, and sends each request to the fastest one.
+///
+/// Latency-critical reads (`hedgedMethods`) are hedged: if the fastest endpoint hasn't answered after its p95 latency, or
+/// if it fails, the request is also sent to the second fastest, and the first successful response wins.
+/// Subscriptions and everything else go to the fastest endpoint only.
+public final class Web3ProviderPool: Web3Provider, Web3BidirectionalProvider {
+
+    // MARK: - Endpoints
+
+    public final class Endpoint {
+        public let name: String
+        public let provider: Web3Provider
+
+        fileprivate let stats = LatencyStats()
+
+        public init(name: String, provider: Web3Provider) {
+            self.name = name
+            self.provider = provider
+        }
+    }
+
+    /// Latency of an endpoint, in milliseconds.
+    public struct EndpointStats: Codable {
+        public let name: String
+        public let requests: Int
+        public let failures: Int
+        public let average: Double
+        public let p50: Double
+        public let p95: Double
+    }
+
+    public let endpoints: [Endpoint]
+
+    /// Reads on the block critical path, worth being sent twice
+    public static let hedgedMethods: Set<String> = [
+        "eth_call",
+        "eth_gasPrice",
+        "eth_getTransactionCount",
+        "eth_blockNumber",
+        "eth_estimateGas",
+        "eth_getBlockByNumber",
+        "eth_getTransactionReceipt",
+        "eth_getLogs",
+    ]
+
+    /// Bounds of the hedging delay, the p95 of the fastest endpoint in between
+    public var minimumHedgeDelay: DispatchTimeInterval = .milliseconds(2)
+    public var maximumHedgeDelay: DispatchTimeInterval = .milliseconds(500)
+
+    private let queue = DispatchQueue(label: "Web3ProviderPool", attributes: .concurrent)
+
+    public init(endpoints: [Endpoint]) {
+        precondition(!endpoints.isEmpty, "A pool needs at least one endpoint")
+        self.endpoints = endpoints
+    }
+
+    public convenience init(wsUrls: [String], timeout: DispatchTimeInterval = .seconds(120)) throws {
+        let endpoints = try wsUrls.map { url in
+            Endpoint(name: URL(string: url)?.host ?? url, provider: try Web3WebSocketProvider(wsUrl: url, timeout: timeout))
+        }
+        self.init(endpoints: endpoints)
+    }
+
+    public var stats: [EndpointStats] {
+        endpoints.map { $0.stats.summary(name: $0.name) }
+    }
+
+    /// Endpoints from the fastest to the slowest, in configuration order on ties.
+    /// Endpoints that never answered come first, so they get measured.
+    var ranked: [Endpoint] {
+        let scores = endpoints.map { $0.stats.score }
+        return endpoints.indices.sorted { (scores[$0], $0) < (scores[$1], $1) }.map { endpoints[$0] }
+    }
+
+    // MARK: - Web3Provider
+
+    public func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>) {
+        dispatch(hedged: Self.hedgedMethods.contains(request.method), completion: response, isSuccess: { !$0.isTransportFailure }) { provider, completion in
+            provider.send(request: request, response: completion)
+        }
+    }
+
+    public func send<Params, Result>(batch requests: [RPCRequest<Params>], response: @escaping (_ responses: [Web3Response<Result>]) -> Void) {
+        let hedged = requests.allSatisfy { Self.hedgedMethods.contains($0.method) }
+        dispatch(hedged: hedged, completion: response, isSuccess: { $0.allSatisfy { !$0.isTransportFailure } }) { provider, completion in
+            provider.send(batch: requests, response: completion)
+        }
+    }
+
+    // MARK: - Web3BidirectionalProvider
+
+    /// Subscriptions are held by the fastest endpoint at the time they are made
+    private var subscriptionProvider: Web3BidirectionalProvider? {
+        ranked.lazy.compactMap { $0.provider as? Web3BidirectionalProvider }.first
+    }
+
+    public func subscribe<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<String>, onEvent: @escaping Web3ResponseCompletion<Result>) {
+        guard let provider = subscriptionProvider else {
+            response(Web3Response(error: .requestFailed(Web3.Eth.Error.providerDoesNotSupportSubscriptions)))
+            return
+        }
+        provider.subscribe(request: request, response: subscriptions.remember(provider, response: response), onEvent: onEvent)
+    }
+
+    public func unsubscribe(subscriptionId: String, completion: @escaping (_ success: Bool) -> Void) {
+        guard let provider = subscriptions.forget(subscriptionId) else {
+            completion(false)
+            return
+        }
+        provider.unsubscribe(subscriptionId: subscriptionId, completion: completion)
+    }
+
+    /// Which endpoint holds each subscription, to unsubscribe from the right one
+    private let subscriptions = SubscriptionOwners()
+}
+
+extension Web3ProviderPool: Web3RawSubscriptionProvider {
+    func subscribe<Params>(request: RPCRequest<Params>, response: @escaping Web3.Web3ResponseCompletion<String>, onCancel: @escaping () -> Void, onNotification: @escaping (_ notification: String) -> Void) {
+        guard let provider = ranked.lazy.compactMap({ $0.provider as? Web3RawSubscriptionProvider & Web3BidirectionalProvider }).first else {
+            response(Web3Response(error: .requestFailed(Web3.Eth.Error.providerDoesNotSupportSubscriptions)))
+            return
+        }
+        provider.subscribe(request: request, response: subscriptions.remember(provider, response: response), onCancel: onCancel, onNotification: onNotification)
+    }
+}
+
+// MARK: - Hedging
+
+extension Web3ProviderPool {
+    private func dispatch<Response>(hedged: Bool,
+                                    completion: @escaping (Response) -> Void,
+                                    isSuccess: @escaping (Response) -> Bool,
+                                    send: @escaping (Web3Provider, @escaping (Response) -> Void) -> Void) {
+        let ranked = self.ranked
+        let attempts = hedged ? Array(ranked.prefix(2)) : [ranked[0]]
+        let call = HedgedCall(attempts: attempts.count, completion: completion)
+
+        func launch(_ index: Int) {
+            guard call.launch(index) else { return }
+            let endpoint = attempts[index]
+            let start = DispatchTime.now().uptimeNanoseconds
+            send(endpoint.provider) { response in
+                let success = isSuccess(response)
+                endpoint.stats.record(nanoseconds: DispatchTime.now().uptimeNanoseconds - start, success: success)
+                Metrics.observe(.rpcDuration, since: start)
+                if !success {
+                    Metrics.increment(.rpcErrors)
+                }
+                if success {
+                    call.succeed(with: response)
+                } else {
+                    // Don't wait for the delay when the fastest endpoint already failed
+                    if index + 1 < attempts.count {
+                        launch(index + 1)
+                    }
+                    call.fail(with: response)
+                }
+            }
+        }
+
+        launch(0)
+        if attempts.count > 1 {
+            queue.asyncAfter(deadline: .now() + hedgeDelay(for: attempts[0])) {
+                guard !call.isSettled else { return }
+                launch(1)
+            }
+        }
+    }
+
+    private func hedgeDelay(for endpoint: Endpoint) -> DispatchTimeInterval {
+        let minimum = minimumHedgeDelay.nanoseconds, maximum = maximumHedgeDelay.nanoseconds
+        let p95 = endpoint.stats.p95Nanoseconds ?? maximum
+        return .nanoseconds(Int(min(max(p95, minimum), maximum)))
+    }
+}
+
+// MARK: - Helpers
+
+private extension Web3Response {
+    /// The request didn't get an answer from the node: timeout, closed connection...
+    /// Errors returned by the node (a reverted call...) are an answer, another endpoint would return the same.
+    var isTransportFailure: Bool {
+        guard case .failure(let error) = status, let error = error as? Web3Response<Result>.Error else { return false }
+        switch error {
+        case .serverError(let underlying):
+            return underlying is Web3WebSocketProvider.Error
+        case .requestFailed, .connectionFailed:
+            return true
+        case .emptyResponse, .decodingError, .subscriptionCancelled:
+            return false
+        }
+    }
+}
+
+private extension DispatchTimeInterval {
+    var nanoseconds: UInt64 {
+        switch self {
+        case .seconds(let value):
+            return UInt64(value) * 1_000_000_000
+        case .milliseconds(let value):
+            return UInt64(value) * 1_000_000
+        case .microseconds(let value):
+            return UInt64(value) * 1_000
+        case .nanoseconds(let value):
+            return UInt64(value)
+        default:
+            return .max
+        }
+    }
+}
+
+/// State of a request sent to one or more endpoints: the first success, or the last failure, answers.
+private final class HedgedCall<Response> {
+    private let lock = NSLock()
+    private let attempts: Int
+    private var launched = Set<Int>()
+    private var failures = 0
+    private var settled = false
+    private let completion: (Response) -> Void
+
+    init(attempts: Int, completion: @escaping (Response) -> Void) {
+        self.attempts = attempts
+        self.completion = completion
+    }
+
+    var isSettled: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return settled
+    }
+
+    /// `false` if the attempt was already launched, or the call is settled
+    func launch(_ index: Int) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return !settled && launched.insert(index).inserted
+    }
+
+    func succeed(with response: Response) {
+        lock.lock()
+        let first = !settled
+        settled = true
+        lock.unlock()
+        if first {
+            completion(response)
+        }
+    }
+
+    /// A failed attempt always launches the next one, so the call failed once every attempt did
+    func fail(with response: Response) {
+        lock.lock()
+        failures += 1
+        let last = !settled && failures == attempts
+        settled = settled || last
+        lock.unlock()
+        if last {
+            completion(response)
+        }
+    }
+}
+
+/// Latency samples of an endpoint.
+private final class LatencyStats {
+    private static let capacity = 256
+    /// Failures count as a slow answer, so that a failing endpoint drops in the ranking
+    private static let failurePenalty: UInt64 = 1_000_000_000
+
+    private let lock = NSLock()
+    private var samples = [UInt64](repeating: 0, count: capacity)
+    private var count = 0
+    private var failures = 0
+    /// Exponentially weighted moving average, in nanoseconds
+    private var average: Double = 0
+    private var sortedCache: [UInt64]? = nil
+
+    func record(nanoseconds: UInt64, success: Bool) {
+        lock.lock()
+        defer { lock.unlock() }
+        let sample = success ? nanoseconds : max(nanoseconds, Self.failurePenalty)
+        average = count == 0 ? Double(sample) : average * 0.8 + Double(sample) * 0.2
+        if success {
+            samples[count % Self.capacity] = nanoseconds
+            count += 1
+            sortedCache = nil
+        } else {
+            failures += 1
+        }
+    }
+
+    /// Lower is better, endpoints without samples come first
+    var score: Double {
+        lock.lock()
+        defer { lock.unlock() }
+        return average
+    }
+
+    var p95Nanoseconds: UInt64? {
+        lock.lock()
+        defer { lock.unlock() }
+        return percentile(0.95)
+    }
+
+    func summary(name: String) -> Web3ProviderPool.EndpointStats {
+        lock.lock()
+        defer { lock.unlock() }
+        return .init(name: name,
+                     requests: count + failures,
+                     failures: failures,
+                     average: average / 1e6,
+                     p50: Double(percentile(0.5) ?? 0) / 1e6,
+                     p95: Double(percentile(0.95) ?? 0) / 1e6)
+    }
+
+    /// Called with the lock held
+    private func percentile(_ quantile: Double) -> UInt64? {
+        guard count >= 8 else { return nil }
+        if sortedCache == nil {
+            sortedCache = samples.prefix(min(count, Self.capacity)).sorted()
+        }
+        let sorted = sortedCache!
+        return sorted[min(Int(quantile * Double(sorted.count)), sorted.count - 1)]
+    }
+}
+
+/// Subscription ids, and the provider that holds them.
+private final class SubscriptionOwners {
+    private let lock = NSLock()
+    private var owners = [String: Web3BidirectionalProvider]()
+
+    /// Wraps the subscription response, to record its id
+    func remember(_ provider: Web3BidirectionalProvider, response: @escaping Web3.Web3ResponseCompletion<String>) -> Web3.Web3ResponseCompletion<String> {
+        return { resp in
+            if let id = resp.result {
+                self.lock.lock()
+                self.owners[id] = provider
+                self.lock.unlock()
+            }
+            response(resp)
+        }
+    }
+
+    func forget(_ subscriptionId: String) -> Web3BidirectionalProvider? {
+        lock.lock()
+        defer { lock.unlock() }
+        return owners.removeValue(forKey: subscriptionId)
+    }
+}
@@ -12,6 +12,8 @@ import FoundationNetworking
 #endif
 import WebSocketKit
 import NIOPosix
+import Atomics
+import Native
 
 public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
     
@@ -31,32 +33,20 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
     
     private let wsEventLoopGroup: EventLoopGroup
     public private(set) var webSocket: WebSocket!
+    /// Takes the frames instead of `webSocket` in tests, which answer them with `receive(_:)`
+    private let stubSocket: ((_ frame: String) -> Void)?
     
-    // Stores ids and notification groups
-    private let pendingRequests: SynchronizedDictionary<Int, (timeoutItem: DispatchWorkItem, responseCompletion: (_ response: String?) -> Void)> = [:]
+    // Stores ids and notification groups. Whoever removes an entry (response, timeout, reconnect) owns its completion.
+    private let pendingRequests = ShardedDictionary<Int, (timeoutItem: DispatchWorkItem, responseCompletion: (_ response: String?) -> Void)>()
     
     // Stores subscription ids and semaphores
     private let currentSubscriptions: SynchronizedDictionary<String, (onCancel: () -> Void, onNotification: (_ notification: String) -> Void)> = [:]
     
-    // Maintain sync current id
-    private let nextIdQueue = DispatchQueue(label: "Web3WebSocketProvider_nextIdQueue", attributes: .concurrent)
-    private var currentId = 1
+    // Lock free id counter, wrapping around at UInt16.max
+    private let currentId = ManagedAtomic<Int>(0)
     private var nextId: Int {
-        get {
-            var retId: Int!
-            
-            nextIdQueue.sync(flags: .barrier) {
-                retId = currentId
-                
-                if currentId < UInt16.max {
-                    currentId += 1
-                } else {
-                    currentId = 1
-                }
-            }
-            
-            return retId
-        }
+        let id = currentId.loadThenWrappingIncrement(ordering: .relaxed)
+        return id % Int(UInt16.max) + 1
     }
     
     public enum Error: Swift.Error {
@@ -71,15 +61,28 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
     
     // MARK: - Initialization
     
-    public init(wsUrl: String, timeout: DispatchTimeInterval = .seconds(120)) throws {
+    public convenience init(wsUrl: String, timeout: DispatchTimeInterval = .seconds(120)) throws {
+        guard let url = URL(string: wsUrl) else {
+            throw Error.invalidUrl
+        }
+        self.init(url: url, timeout: timeout, stubSocket: nil)
+        
+        // Initial connect
+        try reconnect()
+    }
+    
+    /// Provider without a node: requests are handed to `stubSocket`, and answered with `receive(_:)`.
+    convenience init(stubSocket: @escaping (_ frame: String) -> Void, timeout: DispatchTimeInterval = .seconds(120)) {
+        self.init(url: URL(string: "ws://localhost")!, timeout: timeout, stubSocket: stubSocket)
+    }
+    
+    private init(url: URL, timeout: DispatchTimeInterval, stubSocket: ((_ frame: String) -> Void)?) {
         // Concurrent queue for faster concurrent requests
         self.receiveQueue = DispatchQueue(label: "Web3WebSocketProvider_Receive", attributes: .concurrent)
         self.reconnectQueue = DispatchQueue(label: "Web3WebSocketProvider_Reconnect", attributes: .concurrent)
         
-        guard let url = URL(string: wsUrl) else {
-            throw Error.invalidUrl
-        }
         self.wsUrl = url
+        self.stubSocket = stubSocket
         
         // Timeout in ns
         switch timeout {
@@ -96,14 +99,11 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
         }
         
         self.wsEventLoopGroup = MultiThreadedEventLoopGroup(numberOfThreads: 4)
-        
-        // Initial connect
-        try reconnect()
     }
     
     deinit {
         closed = true
-        _ = webSocket.close(code: .goingAway)
+        _ = webSocket?.close(code: .goingAway)
         
         // As described in https://github.com/apple/swift-nio/issues/2371
         try? wsEventLoopGroup.syncShutdownGracefully()
@@ -132,46 +132,41 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
         
         // The timeout
         let timeoutItem = DispatchWorkItem {
-            self.pendingRequests[replacedIdRequest.id] = nil
+            // The response may have won the race, in which case it already answered
+            guard self.pendingRequests.removeValue(forKey: replacedIdRequest.id) != nil else { return }
             
             // Respond to user
             failure(Error.timeoutError)
         }
         self.receiveQueue.asyncAfter(deadline: DispatchTime(uptimeNanoseconds: DispatchTime.now().uptimeNanoseconds + self.timeoutNanoSeconds), execute: timeoutItem)
         
-        // The response
+        // The response, called once the request was removed from the pending requests
         let responseCompletion: (_ response: String?) -> Void = { responseString in
-            defer {
-                // Remove from pending requests
-                self.pendingRequests[replacedIdRequest.id] = nil
-            }
-            
             timeoutItem.cancel()
             
-            self.pendingRequests.getValueAsync(key: replacedIdRequest.id) { value in
-                guard value != nil else {
-                    // Timeout happened already. Rare. Timeout sent the timeout error. Do nothing.
+            self.receiveQueue.async {
+                guard let responseString = responseString else {
+                    failure(Error.webSocketClosedRetry)
                     return
                 }
                 
-                self.receiveQueue.async {
-                    guard let responseString = responseString else {
-                        failure(Error.webSocketClosedRetry)
-                        return
-                    }
-                    
-                    // Parse response
-                    guard let responseData = responseString.data(using: .utf8), let decoded = try? self.decoder.decode(RPCResponse<Result>.self, from: responseData) else {
-                        failure(Error.unexpectedResponse)
-                        return
-                    }
-                    // Put back original request id
-                    let idReplacedDecoded = RPCResponse<Result>(id: request.id, jsonrpc: decoded.jsonrpc, result: decoded.result, error: decoded.error)
-                    
-                    // Return result
-                    let res = Web3Response(rpcResponse: idReplacedDecoded)
-                    response(res)
+                // `eth_call` results are read by the native scanner, errors still go through the decoder
+                if Result.self == EthereumData.self, let result = FastJSON.callResult(responseString) {
+                    response(Web3Response(status: .success(result as! Result)))
+                    return
+                }
+                
+                // Parse response
+                guard let responseData = responseString.data(using: .utf8), let decoded = try? self.decoder.decode(RPCResponse<Result>.self, from: responseData) else {
+                    failure(Error.unexpectedResponse)
+                    return
                 }
+                // Put back original request id
+                let idReplacedDecoded = RPCResponse<Result>(id: request.id, jsonrpc: decoded.jsonrpc, result: decoded.result, error: decoded.error)
+                
+                // Return result
+                let res = Web3Response(rpcResponse: idReplacedDecoded)
+                response(res)
             }
         }
         
@@ -192,12 +187,112 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
         }
         
         // Send Request through WebSocket once the Promise was set
-        self.webSocket.send(String(data: body, encoding: .utf8) ?? "", promise: promise)
+        self.write(String(data: body, encoding: .utf8) ?? "", promise: promise)
+    }
+    
+    /// Sends all the requests in a single frame, as a JSON-RPC batch. Responses are returned in the order of the requests.
+    public func send<Params, Result>(batch requests: [RPCRequest<Params>], response: @escaping (_ responses: [Web3Response<Result>]) -> Void) {
+        guard requests.count > 0 else { return response([]) }
+        
+        let ids = requests.map { _ in self.nextId }
+        let replacedIdRequests = zip(ids, requests).map { id, request in
+            RPCRequest(id: id, jsonrpc: request.jsonrpc, method: request.method, params: request.params)
+        }
+        
+        let body: Data
+        do {
+            body = try self.encoder.encode(replacedIdRequests)
+        } catch {
+            response(requests.map { _ in Web3Response<Result>(error: .requestFailed(error)) })
+            return
+        }
+        
+        // Every id of the batch points to the same completion, only the first caller gets through
+        let settled = ManagedAtomic<Bool>(false)
+        let settle: () -> Bool = {
+            guard settled.compareExchange(expected: false, desired: true, ordering: .acquiringAndReleasing).exchanged else { return false }
+            for id in ids {
+                self.pendingRequests.removeValue(forKey: id)
+            }
+            return true
+        }
+        
+        // Generic failure sender
+        let failure: (_ error: Error) -> () = { error in
+            response(requests.map { _ in Web3Response<Result>(error: .serverError(error)) })
+        }
+        
+        let timeoutItem = DispatchWorkItem {
+            guard settle() else { return }
+            failure(Error.timeoutError)
+        }
+        self.receiveQueue.asyncAfter(deadline: DispatchTime(uptimeNanoseconds: DispatchTime.now().uptimeNanoseconds + self.timeoutNanoSeconds), execute: timeoutItem)
+        
+        let responseCompletion: (_ response: String?) -> Void = { responseString in
+            guard settle() else { return }
+            timeoutItem.cancel()
+            
+            self.receiveQueue.async {
+                guard let responseString = responseString else {
+                    failure(Error.webSocketClosedRetry)
+                    return
+                }
+                
+                guard let responseData = responseString.data(using: .utf8), let decoded = try? self.decoder.decode([RPCResponse<Result>].self, from: responseData) else {
+                    failure(Error.unexpectedResponse)
+                    return
+                }
+                
+                // Demultiplex by id, the node is free to answer in any order
+                var byId = [Int: RPCResponse<Result>](minimumCapacity: decoded.count)
+                for item in decoded {
+                    byId[item.id] = item
+                }
+                let responses = zip(ids, requests).map { id, request -> Web3Response<Result> in
+                    guard let item = byId[id] else { return Web3Response<Result>(error: .emptyResponse) }
+                    return Web3Response(rpcResponse: RPCResponse<Result>(id: request.id, jsonrpc: item.jsonrpc, result: item.result, error: item.error))
+                }
+                response(responses)
+            }
+        }
+        
+        for id in ids {
+            self.pendingRequests[id] = (timeoutItem: timeoutItem, responseCompletion: responseCompletion)
+        }
+        
+        let promise = self.wsEventLoopGroup.next().makePromise(of: Void.self)
+        promise.futureResult.whenFailure { error in
+            guard settle() else { return }
+            timeoutItem.cancel()
+            response(requests.map { _ in Web3Response<Result>(error: .requestFailed(error)) })
+        }
+        
+        self.write(String(data: body, encoding: .utf8) ?? "", promise: promise)
     }
     
     // MARK: - Web3BidirectionalProvider
     
     public func subscribe<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<String>, onEvent: @escaping Web3ResponseCompletion<Result>) {
+        self.subscribe(request: request, response: response) {
+            // Notify client
+            let err = Web3Response<Result>(error: .subscriptionCancelled(Error.subscriptionCancelled))
+            onEvent(err)
+        } onNotification: { notification in
+            // Parse notification
+            guard let notificationData = notification.data(using: .utf8), let decoded = try? self.decoder.decode(RPCEventResponse<Result>.self, from: notificationData) else {
+                let err = Web3Response<Result>(error: .serverError(Error.unexpectedResponse))
+                onEvent(err)
+                return
+            }
+            
+            // Return result
+            let res = Web3Response(rpcEventResponse: decoded)
+            onEvent(res)
+        }
+    }
+    
+    /// Subscribes to the given event, handing over the raw notifications so they can be decoded without `JSONDecoder`.
+    func subscribe<Params>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<String>, onCancel: @escaping () -> Void, onNotification: @escaping (_ notification: String) -> Void) {
         self.send(request: request) { (_ resp: Web3Response<String>) -> Void in
             guard let subscriptionId = resp.result else {
                 let err = Web3Response<String>(error: .serverError(resp.error))
@@ -212,40 +307,22 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
             let queue = self.receiveQueue
             
             // Subscription cancelled by us or the server, not the User.
-            let onCancel: () -> Void = {
+            let cancelled: () -> Void = {
                 queue.async {
                     // We are done, the subscription was cancelled. We don't care why
                     self.currentSubscriptions[subscriptionId] = nil
-                    
-                    // Notify client
-                    let err = Web3Response<Result>(error: .subscriptionCancelled(Error.subscriptionCancelled))
-                    onEvent(err)
+                    onCancel()
                 }
             }
             
             let notificationReceived: (_ notification: String) -> Void = { notification in
                 queue.async {
-                    // Generic failure sender
-                    let failure: (_ error: Error) -> () = { error in
-                        let err = Web3Response<Result>(error: .serverError(error))
-                        onEvent(err)
-                        return
-                    }
-                    
-                    // Parse notification
-                    guard let notificationData = notification.data(using: .utf8), let decoded = try? self.decoder.decode(RPCEventResponse<Result>.self, from: notificationData) else {
-                        failure(Error.unexpectedResponse)
-                        return
-                    }
-                    
-                    // Return result
-                    let res = Web3Response(rpcEventResponse: decoded)
-                    onEvent(res)
+                    onNotification(notification)
                 }
             }
             
             // Now we need to register the subscription id to our internal subscription id register
-            self.currentSubscriptions[subscriptionId] = (onCancel: onCancel, onNotification: notificationReceived)
+            self.currentSubscriptions[subscriptionId] = (onCancel: cancelled, onNotification: notificationReceived)
         }
     }
     
@@ -268,45 +345,41 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
     
     // MARK: - Helpers
     
-    private struct WebSocketOnTextTmpCodable: Codable {
-        let id: Int?
-        
-        let params: Params?
-        
-        fileprivate struct Params: Codable {
-            let subscription: String
+    private func write(_ frame: String, promise: EventLoopPromise<Void>) {
+        guard let stubSocket else {
+            webSocket.send(frame, promise: promise)
+            return
         }
+        stubSocket(frame)
+        promise.succeed(())
     }
     
-    private func registerWebSocketListeners() {
-        // Receive response
-        webSocket.onText { [weak self] ws, string in
-            guard let self else {
-                return
-            }
-            
-            self.receiveQueue.async {
-                guard let data = string.data(using: .utf8) else {
-                    return
-                }
-                
-                if let tmpCodable = try? self.decoder.decode(WebSocketOnTextTmpCodable.self, from: data) {
-                    if let id = tmpCodable.id {
-                        self.pendingRequests.getValueAsync(key: id) { value in
-                            self.receiveQueue.async {
-                                value?.responseCompletion(string)
-                            }
-                        }
-                    } else if let params = tmpCodable.params {
-                        self.currentSubscriptions.getValueAsync(key: params.subscription) { value in
-                            self.receiveQueue.async {
-                                value?.onNotification(string)
-                            }
-                        }
+    /// Routes a message of the node to the request or the subscription it answers
+    func receive(_ string: String) {
+        receiveQueue.async {
+            switch FastJSON.scan(string) {
+            case .response(let id):
+                self.pendingRequests.removeValue(forKey: id)?.responseCompletion(string)
+            case .batch(let firstId):
+                // Every id of a batch leads to its completion
+                self.pendingRequests[firstId]?.responseCompletion(string)
+            case .notification(let subscription):
+                self.currentSubscriptions.getValueAsync(key: subscription) { value in
+                    self.receiveQueue.async {
+                        value?.onNotification(string)
                     }
                 }
+            case .none:
+                break
             }
         }
+    }
+    
+    private func registerWebSocketListeners() {
+        // Receive response
+        webSocket.onText { [weak self] ws, string in
+            self?.receive(string)
+        }
         
         // Handle close
         webSocket.onClose.whenComplete { [weak self] result in
@@ -331,11 +404,9 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
                 }
             }
         }
-        for key in pendingRequests.dictionary.keys {
-            pendingRequests.getValueAsync(key: key) { value in
-                self.receiveQueue.async {
-                    value?.responseCompletion(nil)
-                }
+        for value in pendingRequests.removeAll() {
+            self.receiveQueue.async {
+                value.responseCompletion(nil)
             }
         }
         
@@ -347,3 +418,67 @@ public class Web3WebSocketProvider: Web3Provider, Web3BidirectionalProvider {
         }.wait()
     }
 }
+
+// MARK: - Native decoding
+
+/// Providers handing over the raw notifications of a subscription.
+protocol Web3RawSubscriptionProvider {
+    func subscribe<Params>(request: RPCRequest<Params>, response: @escaping Web3.Web3ResponseCompletion<String>, onCancel: @escaping () -> Void, onNotification: @escaping (_ notification: String) -> Void)
+}
+
+extension Web3WebSocketProvider: Web3RawSubscriptionProvider {}
+
+extension Web3.Eth {
+    
+    /// Same as `subscribeToNewHeads(subscribed:onEvent:)`, but only the fields we use are read, by the native JSON scanner.
+    func subscribeToNewHeads(subscribed: @escaping Web3ResponseCompletion<String>, onHead: @escaping (_ head: FastJSON.NewHead) -> Void) throws {
+        guard let provider = properties.provider as? Web3RawSubscriptionProvider else {
+            throw Web3.Eth.Error.providerDoesNotSupportSubscriptions
+        }
+        let req = BasicRPCRequest(id: properties.rpcId, jsonrpc: Web3.jsonrpc, method: "eth_subscribe", params: ["newHeads"])
+        provider.subscribe(request: req, response: subscribed, onCancel: {}) { notification in
+            guard let head = FastJSON.newHead(notification) else { return }
+            onHead(head)
+        }
+    }
+    
+    /// Same as `subscribeToLogs(addresses:topics:subscribed:onEvent:)`, decoding the logs with the native JSON scanner.
+    /// - Parameter onCancel: Called when the subscription ends without being unsubscribed, e.g. when the socket reconnects.
+    func subscribeToLogs(addresses: [EthereumAddress], topics: [[EthereumData]], subscribed: @escaping Web3ResponseCompletion<String>, onCancel: @escaping () -> Void = {}, onLog: @escaping (_ log: FastJSON.Log) -> Void) throws {
+        guard let provider = properties.provider as? Web3RawSubscriptionProvider else {
+            throw Web3.Eth.Error.providerDoesNotSupportSubscriptions
+        }
+        let req = RPCRequest(id: properties.rpcId, jsonrpc: Web3.jsonrpc, method: "eth_subscribe",
+                             params: LogsSubscriptionParams(filter: .init(address: addresses, topics: topics)))
+        provider.subscribe(request: req, response: subscribed, onCancel: onCancel) { notification in
+            guard let log = FastJSON.log(notification) else { return }
+            onLog(log)
+        }
+    }
+}
+
+/// `["logs", {"address": [...], "topics": [...]}]`
+private struct LogsSubscriptionParams: Codable {
+    struct Filter: Codable {
+        let address: [EthereumAddress]
+        let topics: [[EthereumData]]
+    }
+    
+    let filter: Filter
+    
+    init(filter: Filter) {
+        self.filter = filter
+    }
+    
+    init(from decoder: Decoder) throws {
+        var container = try decoder.unkeyedContainer()
+        _ = try container.decode(String.self)
+        self.filter = try container.decode(Filter.self)
+    }
+    
+    func encode(to encoder: Encoder) throws {
+        var container = encoder.unkeyedContainer()
+        try container.encode("logs")
+        try container.encode(filter)
+    }
+}
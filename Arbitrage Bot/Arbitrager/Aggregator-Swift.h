@@ -17,12 +17,21 @@ void _attach_tick_price_data_store(int storeId, void (^ _Nonnull callback)(doubl
 void _close_realtime_server_controller(int id);
 
 
-int _create_realtime_server_controller(int storeId, void (* _Nonnull callback)(char const * _Nonnull, uint16_t, void const * _Nonnull), void const * _Nonnull userData);
+int _create_realtime_server_controller(int storeId, void (* _Nonnull callback)(char const * _Nonnull, size_t, void const * _Nonnull), void const * _Nonnull userData, bool binary);
 
 
 int _create_store(void);
 
 
+void _register_realtime_topics(void (* _Nonnull publish)(char const * _Nonnull, size_t, char const * _Nonnull, size_t, bool), void (* _Nonnull subscribe)(void const * _Nonnull, char const * _Nonnull, size_t, bool));
+
+
+void _resync_realtime_topic(char const * _Nonnull topic, size_t length);
+
+
+void _register_http_snapshots(void (* _Nonnull store)(char const * _Nonnull, size_t, char const * _Nonnull, size_t));
+
+
 void _realtime_server_handle_request(int controllerId, char const * _Nonnull request, int size);
 
 
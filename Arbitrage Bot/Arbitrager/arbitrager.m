@@ -18,10 +18,17 @@
 #endif
 
 #include <stdio.h>
+#include <unistd.h>
+#include "compression.h"
+#include "conflation.h"
+#include "latency.h"
+#include "metrics.h"
+#include "outbox.h"
 
 #define SSL 0
 
-pthread_mutex_t lock;
+/// Subprotocol of the binary frames, see `BinaryFrame.swift`. Clients that don't ask for it get JSON text frames.
+#define BINARY_PROTOCOL "arbitrage-bot.v1"
 
 // MARK: - Server
 
@@ -32,40 +39,397 @@ typedef struct {
 struct PerSocketData {
     int controller;
     Server *server;
+    /// Id given to the controller instead of the socket pointer, see `live_sockets_t`
+    uint64_t id;
+    /// Negotiated `BINARY_PROTOCOL`
+    bool binary;
+    /// Set while the socket can't keep up, see `conflation_t`
+    struct conflation *conflation;
 };
 
+_Static_assert(sizeof(struct PerSocketData) <= UWS_INLINE_USER_DATA_MAX, "Socket data is stored inline by uWS");
+
+/// Copied into each socket, which stores it inline (see `uws_ws_inline`)
 struct PerSocketData *socket_data_base;
 
+/// Room for the headers copied by `upgrade_handler`: the key is 24 bytes, protocols and extensions rarely take more than
+/// a few dozen. Longer headers get their own allocation.
+#define UPGRADE_HEADERS_SIZE 256
+/// `UpgradeData` allocated at once when the pool is empty
+#define UPGRADE_SLAB_COUNT 64
+
+typedef struct upgrade_pool upgrade_pool_t;
+
 struct UpgradeData {
-    header_t *secWebSocketKey;
-    header_t *secWebSocketProtocol;
-    header_t *secWebSocketExtensions;
+    header_t secWebSocketKey;
+    header_t secWebSocketProtocol;
+    header_t secWebSocketExtensions;
     uws_socket_context_t *context;
     uws_res_t *response;
     bool aborted;
+    bool binary;
+    upgrade_pool_t *pool;
+    struct UpgradeData *next_free;
+    size_t headers_used;
+    char headers[UPGRADE_HEADERS_SIZE];
 };
 
-header_t *create_header(size_t length, const char *value) {
-    header_t *header = (header_t *)malloc(sizeof(header_t));
-    if (length > 0) {
-        header->value = (char *)calloc(sizeof(char), length);
-        header->length = length;
+/// Free `UpgradeData` of an app, carved out of slabs that are kept for the next connections, so that connection
+/// storms don't go through malloc for every upgrade. Only touched from the loop thread.
+struct upgrade_pool {
+    struct UpgradeData *free;
+};
+
+/// A uWS app, with its loop, its sockets and its outbox
+typedef struct {
+    uws_app_t *app;
+    struct us_loop_t *loop;
+    uint16_t index;
+    uint64_t last_socket;
+    outbox_t outbox;
+    /// Open sockets, by id. Controllers can outlive their socket (Swift tasks may still answer after a close), so they
+    /// never hold the socket pointer, only its id, which is resolved here when their messages are flushed.
+    live_sockets_t live;
+    outbox_buckets_t buckets;
+    /// Ids of the conflated sockets
+    uint64_t *slow;
+    size_t slow_count;
+    size_t slow_capacity;
+    upgrade_pool_t upgrades;
+} app_context_t;
+
+#define MAX_APPS 64
+/// Socket ids carry the index of their app in their top 16 bits
+#define SOCKET_ID_APP_SHIFT 48
+
+/// One app per server thread, see `start_server_threads`. Registered once, read from any thread.
+static app_context_t *apps[MAX_APPS];
+
+/// Must be called on the thread running `app`, whose loop it captures
+static app_context_t *create_app_context(uws_app_t *app, uint16_t index) {
+    app_context_t *ctx = calloc(1, sizeof(app_context_t));
+    ctx->app = app;
+    ctx->loop = uws_get_loop();
+    ctx->index = index;
+    __atomic_store_n(&apps[index], ctx, __ATOMIC_RELEASE);
+    return ctx;
+}
+
+static inline app_context_t *app_at(int index) {
+    return __atomic_load_n(&apps[index], __ATOMIC_ACQUIRE);
+}
+
+static inline struct PerSocketData *socket_data(uws_websocket_t *ws) {
+    return (struct PerSocketData *)uws_ws_get_inline_user_data(SSL, ws);
+}
+
+// MARK: - Compression
+
+/// permessage-deflate is only asked for messages large enough to gain from it, and not deflated already.
+/// Sockets that didn't negotiate the extension get them uncompressed anyway.
+static inline bool should_compress(const char *message, size_t length, uws_opcode_t opcode) {
+    return compression_policy((const uint8_t *)message, length, opcode == BINARY) == COMPRESSION_SHARED;
+}
+
+static inline uws_sendstatus_t send_message(uws_websocket_t *ws, const char *message, size_t length, uws_opcode_t opcode) {
+    uws_sendstatus_t status = uws_ws_send_with_options(SSL, ws, message, length, opcode, should_compress(message, length, opcode), true);
+    if (status == BACKPRESSURE) {
+        metrics_increment(METRIC_WS_BACKPRESSURE);
+    } else if (status == DROPPED) {
+        metrics_increment(METRIC_WS_DROPPED);
+    }
+    return status;
+}
+
+static uint64_t next_socket_id(app_context_t *ctx) {
+    return ((uint64_t)ctx->index << SOCKET_ID_APP_SHIFT) | ++ctx->last_socket;
+}
+
+// MARK: - Conflation
+
+/// Buffered bytes past which a socket stops getting every publication
+#define CONFLATION_THRESHOLD (256 * 1024)
+/// Buffered bytes under which a conflated socket gets the publications again
+#define CONFLATION_RESUME (64 * 1024)
+/// Past this, uWS drops messages. Only direct answers can get there, publications are conflated long before.
+#define MAX_BACKPRESSURE (4 * 1024 * 1024)
+/// `BinaryFrame.Kind.matrixDelta`: only carries changes, so it can't replace the previous frame
+#define BINARY_FRAME_MATRIX_DELTA 4
+
+/// Topics that can't get a slot stay subscribed, and keep getting every publication
+static void collect_topic(const char *topic, size_t length, void *user_data) {
+    conflation_add_topic((conflation_t *)user_data, topic, length);
+}
+
+static void conflation_begin(app_context_t *ctx, uws_websocket_t *ws, struct PerSocketData *data) {
+    conflation_t *conflation = conflation_create();
+    if (!conflation) return;
+    metrics_increment(METRIC_WS_CONFLATED);
+    uws_ws_iterate_topics(SSL, ws, collect_topic, conflation);
+    for (size_t i = 0; i < conflation->count; i++) {
+        uws_ws_unsubscribe(SSL, ws, conflation->slots[i].topic, conflation->slots[i].topic_length);
+    }
+    data->conflation = conflation;
+    
+    if (ctx->slow_count == ctx->slow_capacity) {
+        ctx->slow_capacity = ctx->slow_capacity ? ctx->slow_capacity * 2 : 16;
+        ctx->slow = realloc(ctx->slow, ctx->slow_capacity * sizeof(uint64_t));
+    }
+    ctx->slow[ctx->slow_count++] = data->id;
+}
+
+static void conflation_forget(app_context_t *ctx, struct PerSocketData *data) {
+    for (size_t i = 0; i < ctx->slow_count; i++) {
+        if (ctx->slow[i] == data->id) {
+            ctx->slow[i] = ctx->slow[--ctx->slow_count];
+            break;
+        }
+    }
+    conflation_free(data->conflation);
+    data->conflation = NULL;
+}
+
+typedef struct {
+    uws_websocket_t *ws;
+    conflation_t *conflation;
+} conflation_flush_t;
+
+static void conflation_send_slots(void *user_data) {
+    conflation_flush_t *flush = (conflation_flush_t *)user_data;
+    for (size_t i = 0; i < flush->conflation->count; i++) {
+        conflation_slot_t *slot = &flush->conflation->slots[i];
+        if (slot->message) {
+            send_message(flush->ws, slot->message, slot->length, slot->opcode);
+        }
+    }
+}
+
+static void conflation_end(app_context_t *ctx, uws_websocket_t *ws, struct PerSocketData *data) {
+    conflation_t *conflation = data->conflation;
+    conflation_flush_t flush = {.ws = ws, .conflation = conflation};
+    uws_ws_cork(SSL, ws, conflation_send_slots, &flush);
+    for (size_t i = 0; i < conflation->count; i++) {
+        conflation_slot_t *slot = &conflation->slots[i];
+        uws_ws_subscribe(SSL, ws, slot->topic, slot->topic_length);
+        if (slot->resync) {
+            _resync_realtime_topic(slot->topic, slot->topic_length);
+        }
+    }
+    conflation_forget(ctx, data);
+}
+
+/// Keeps the latest publication for the conflated sockets subscribed to its topic
+static void conflate_publication(app_context_t *ctx, const outbox_message_t *message) {
+    for (size_t i = 0; i < ctx->slow_count; i++) {
+        uws_websocket_t *ws = live_sockets_find(&ctx->live, ctx->slow[i]);
+        if (!ws) continue;
+        struct PerSocketData *data = socket_data(ws);
+        const char *body = outbox_message_body(message);
+        bool delta = message->opcode == BINARY && message->length > 0 && body[0] == BINARY_FRAME_MATRIX_DELTA;
+        conflation_store(data->conflation, message->data, message->topic_length,
+                         body, message->length, message->opcode, delta);
+    }
+}
+
+/// Conflates the sockets that publications just pushed over the threshold. Stalled sockets never drain, so they are
+/// looked for here rather than in `drain_handler`.
+static void conflate_slow_sockets(app_context_t *ctx) {
+    for (size_t i = 0; i < ctx->live.capacity; i++) {
+        uws_websocket_t *ws = (uws_websocket_t *)ctx->live.sockets[i];
+        if (!ws) continue;
+        struct PerSocketData *data = socket_data(ws);
+        if (!data->conflation && uws_ws_get_buffered_amount(SSL, ws) > CONFLATION_THRESHOLD) {
+            conflation_begin(ctx, ws, data);
+        }
+    }
+}
+
+// MARK: - Flush
+
+typedef struct {
+    outbox_message_t **queue;
+    uint64_t socket_id;
+    uws_websocket_t *ws;
+} outbox_batch_t;
+
+/// Sends (or drops, without a socket) the messages of one socket, and unlinks them from the queue
+static void outbox_send_batch(void *user_data) {
+    outbox_batch_t *batch = (outbox_batch_t *)user_data;
+    outbox_message_t **link = batch->queue;
+    while (*link) {
+        outbox_message_t *message = *link;
+        if (message->socket_id != batch->socket_id) {
+            link = &message->next;
+            continue;
+        }
+        if (batch->ws) {
+            send_message(batch->ws, outbox_message_body(message), message->length, message->opcode);
+        }
+        *link = message->next;
+        free(message);
+    }
+}
+
+/// Sends the messages of `*queue` in one corked write per socket. Sockets are resolved when their turn comes, so one
+/// closed by an earlier send has its messages dropped.
+static void outbox_send_queue(app_context_t *ctx, outbox_message_t **queue) {
+    while (*queue) {
+        outbox_batch_t batch = {
+            .queue = queue,
+            .socket_id = (*queue)->socket_id,
+            .ws = live_sockets_find(&ctx->live, (*queue)->socket_id),
+        };
+        if (batch.ws) {
+            uws_ws_cork(SSL, batch.ws, outbox_send_batch, &batch);
+        } else {
+            outbox_send_batch(&batch); // Closed in the meantime
+        }
+    }
+}
+
+/// Applies the messages queued since the last flush: subscriptions first, then each socket's messages in a single corked
+/// write, then publications.
+static void outbox_flush(void *user_data) {
+    app_context_t *ctx = (app_context_t *)user_data;
+    outbox_message_t *queue = outbox_take(&ctx->outbox);
+    
+    // Topic operations are applied in order, so that a client gets the publications of the flush it subscribed in.
+    // Direct messages are split by socket on the way.
+    outbox_message_t *publications = NULL, **last_publication = &publications;
+    // Messages that got no bucket (out of memory), sent by scanning the list instead
+    outbox_message_t *unbucketed = NULL, **last_unbucketed = &unbucketed;
+    bool bucketing = true;
+    while (queue) {
+        outbox_message_t *message = queue;
+        queue = message->next;
+        message->next = NULL;
+        switch (message->kind) {
+            case OUTBOX_SEND:
+                // Once a socket missed its bucket, every later message goes to the scanned list, after the buckets
+                bucketing = bucketing && outbox_buckets_add(&ctx->buckets, message);
+                if (!bucketing) {
+                    *last_unbucketed = message;
+                    last_unbucketed = &message->next;
+                }
+                continue;
+            case OUTBOX_PUBLISH:
+                *last_publication = message;
+                last_publication = &message->next;
+                continue;
+            case OUTBOX_SUBSCRIBE:
+            case OUTBOX_UNSUBSCRIBE: {
+                uws_websocket_t *ws = live_sockets_find(&ctx->live, message->socket_id);
+                struct PerSocketData *data = ws ? socket_data(ws) : NULL;
+                if (data && data->conflation) {
+                    // Applied when it catches up
+                    if (message->kind == OUTBOX_SUBSCRIBE) {
+                        if (!conflation_add_topic(data->conflation, message->data, message->topic_length)) {
+                            uws_ws_subscribe(SSL, ws, message->data, message->topic_length);
+                        }
+                    } else if (!conflation_remove_topic(data->conflation, message->data, message->topic_length)) {
+                        // Kept subscribed, without a slot
+                        uws_ws_unsubscribe(SSL, ws, message->data, message->topic_length);
+                    }
+                } else if (ws && message->kind == OUTBOX_SUBSCRIBE) {
+                    uws_ws_subscribe(SSL, ws, message->data, message->topic_length);
+                } else if (ws) {
+                    uws_ws_unsubscribe(SSL, ws, message->data, message->topic_length);
+                }
+                free(message);
+                continue;
+            }
+        }
+    }
+    
+    // Direct messages
+    for (size_t i = 0; i < ctx->buckets.count; i++) {
+        outbox_send_queue(ctx, &ctx->buckets.buckets[i].first);
+    }
+    outbox_buckets_clear(&ctx->buckets);
+    outbox_send_queue(ctx, &unbucketed);
+    
+    // Publications, serialized once for every subscriber
+    if (!publications) return;
+    while (publications) {
+        outbox_message_t *message = publications;
+        publications = message->next;
+        const char *data = outbox_message_body(message);
+        uws_publish(SSL, ctx->app, message->data, message->topic_length, data, message->length, message->opcode,
+                    should_compress(data, message->length, message->opcode));
+        metrics_increment(METRIC_PUBLICATIONS);
+        conflate_publication(ctx, message);
+        free(message);
+    }
+    conflate_slow_sockets(ctx);
+}
+
+/// Can be called from any thread
+static void queue_message(app_context_t *ctx, outbox_kind_t kind, uws_opcode_t opcode, uint64_t socket_id,
+                          const char *topic, size_t topic_length, const char *data, size_t length) {
+    switch (outbox_push(&ctx->outbox, kind, opcode, socket_id, topic, topic_length, data, length)) {
+        case OUTBOX_PUSH_SCHEDULE:
+            uws_loop_defer(ctx->loop, outbox_flush, ctx);
+            break;
+        case OUTBOX_PUSH_FAILED:
+            metrics_increment(METRIC_WS_DROPPED);
+            break;
+        case OUTBOX_PUSH_QUEUED:
+            break;
+    }
+}
+
+// MARK: - Upgrade pool
+
+static struct UpgradeData *upgrade_data_take(upgrade_pool_t *pool) {
+    if (!pool->free) {
+        struct UpgradeData *slab = malloc(UPGRADE_SLAB_COUNT * sizeof(struct UpgradeData));
+        for (size_t i = 0; i < UPGRADE_SLAB_COUNT; i++) {
+            slab[i].next_free = pool->free;
+            pool->free = &slab[i];
+        }
+    }
+    struct UpgradeData *data = pool->free;
+    pool->free = data->next_free;
+    data->pool = pool;
+    data->headers_used = 0;
+    return data;
+}
+
+/// Copies a header in the room left in `data`, or on the heap when it's full
+void create_header(struct UpgradeData *data, header_t *header, size_t length, const char *value) {
+    header->length = length;
+    if (length == 0) {
+        header->value = NULL;
+    } else if (length <= UPGRADE_HEADERS_SIZE - data->headers_used) {
+        header->value = data->headers + data->headers_used;
+        data->headers_used += length;
         memcpy(header->value, value, length);
     } else {
-        header->value = NULL;
-        header->length = 0;
+        header->value = malloc(length);
+        memcpy(header->value, value, length);
     }
-    return header;
 }
-void free_header(header_t *header) {
-    
-    free(header->value);
-    free(header);
+
+void free_header(struct UpgradeData *data, header_t *header) {
+    if (header->value < data->headers || header->value >= data->headers + UPGRADE_HEADERS_SIZE) {
+        free(header->value);
+    }
 }
+
+static void upgrade_data_release(struct UpgradeData *data) {
+    free_header(data, &data->secWebSocketKey);
+    free_header(data, &data->secWebSocketProtocol);
+    free_header(data, &data->secWebSocketExtensions);
+    data->next_free = data->pool->free;
+    data->pool->free = data;
+}
+
 void listen_handler(struct us_listen_socket_t *listen_socket,
                     uws_app_listen_config_t config, void *user_data) {
     if (listen_socket) {
         printf("Listening on port wss://localhost:%d\n", config.port);
+    } else {
+        printf("Failed to listen on port %d\n", config.port);
     }
 }
 // Timer close helper
@@ -75,27 +439,32 @@ void perform_upgrade(void *data) {
     
     /* Were'nt we aborted before our async task finished? Okay, upgrade then! */
     if (!upgrade_data->aborted) {
-        struct PerSocketData *socket_data =
-        (struct PerSocketData *)malloc(sizeof(struct PerSocketData));
-        memcpy((void *)socket_data, (void *)socket_data_base,
-               sizeof(struct PerSocketData));
+        // Copied in the socket by uWS
+        struct PerSocketData initial = *socket_data_base;
+        initial.binary = upgrade_data->binary;
+        initial.conflation = NULL;
+        
+        // Answer with the protocol we picked, among the ones offered
+        const char *protocol = upgrade_data->secWebSocketProtocol.value;
+        size_t protocol_length = upgrade_data->secWebSocketProtocol.length;
+        if (upgrade_data->binary) {
+            protocol = BINARY_PROTOCOL;
+            protocol_length = sizeof(BINARY_PROTOCOL) - 1;
+        }
         
-        uws_res_upgrade(SSL, upgrade_data->response, socket_data,
-                        upgrade_data->secWebSocketKey->value,
-                        upgrade_data->secWebSocketKey->length,
-                        upgrade_data->secWebSocketProtocol->value,
-                        upgrade_data->secWebSocketProtocol->length,
-                        upgrade_data->secWebSocketExtensions->value,
-                        upgrade_data->secWebSocketExtensions->length,
-                        upgrade_data->context);
+        uws_res_upgrade_inline(SSL, upgrade_data->response, &initial, sizeof(struct PerSocketData),
+                               upgrade_data->secWebSocketKey.value,
+                               upgrade_data->secWebSocketKey.length,
+                               protocol,
+                               protocol_length,
+                               upgrade_data->secWebSocketExtensions.value,
+                               upgrade_data->secWebSocketExtensions.length,
+                               upgrade_data->context);
     } else {
         printf("Async task done, but the HTTP socket was closed. Skipping upgrade "
                "to WebSocket!\n");
     }
-    free_header(upgrade_data->secWebSocketKey);
-    free_header(upgrade_data->secWebSocketProtocol);
-    free_header(upgrade_data->secWebSocketExtensions);
-    free(upgrade_data);
+    upgrade_data_release(upgrade_data);
 }
 
 void on_res_aborted(uws_res_t *response, void *data) {
@@ -104,16 +473,33 @@ void on_res_aborted(uws_res_t *response, void *data) {
      * so simply flag us as aborted */
     upgrade_data->aborted = true;
 }
+/// Whether the comma-separated `sec-websocket-protocol` header lists `BINARY_PROTOCOL`
+static bool offers_binary_protocol(const char *header, size_t length) {
+    const size_t expected = sizeof(BINARY_PROTOCOL) - 1;
+    size_t start = 0;
+    while (start < length) {
+        size_t end = start;
+        while (end < length && header[end] != ',') end++;
+        size_t token_start = start, token_end = end;
+        while (token_start < token_end && header[token_start] == ' ') token_start++;
+        while (token_end > token_start && header[token_end - 1] == ' ') token_end--;
+        if (token_end - token_start == expected && memcmp(header + token_start, BINARY_PROTOCOL, expected) == 0) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
 void upgrade_handler(uws_res_t *response, uws_req_t *request,
                      uws_socket_context_t *context, void * arg) {
     
     /* HttpRequest (req) is only valid in this very callback, so we must COPY the
      * headers we need later on while upgrading to WebSocket. You must not access
-     * req after first return. Here we create a heap allocated struct holding
+     * req after first return. Here we take a pooled struct holding
      * everything we will need later on. */
     
-    struct UpgradeData *data =
-    (struct UpgradeData *)malloc(sizeof(struct UpgradeData));
+    struct UpgradeData *data = upgrade_data_take(&((app_context_t *)arg)->upgrades);
     data->aborted = false;
     data->context = context;
     data->response = response;
@@ -129,10 +515,10 @@ void upgrade_handler(uws_res_t *response, uws_req_t *request,
     size_t ws_extensions_length = uws_req_get_header(
                                                      request, "sec-websocket-extensions", 24, &ws_extensions);
     
-    data->secWebSocketKey = create_header(ws_key_length, ws_key);
-    data->secWebSocketProtocol = create_header(ws_protocol_length, ws_protocol);
-    data->secWebSocketExtensions =
-    create_header(ws_extensions_length, ws_extensions);
+    create_header(data, &data->secWebSocketKey, ws_key_length, ws_key);
+    create_header(data, &data->secWebSocketProtocol, ws_protocol_length, ws_protocol);
+    data->binary = offers_binary_protocol(ws_protocol, ws_protocol_length);
+    create_header(data, &data->secWebSocketExtensions, ws_extensions_length, ws_extensions);
     
     /* We have to attach an abort handler for us to be aware
      * of disconnections while we perform async tasks */
@@ -142,41 +528,79 @@ void upgrade_handler(uws_res_t *response, uws_req_t *request,
     perform_upgrade(data);
 }
 
-void realtime_msg_forward(const char *_Nonnull message, uint16_t length, const void *_Nonnull wsVoid) {
-    uws_websocket_t *ws = (uws_websocket_t *)wsVoid;
-    
-    pthread_mutex_lock(&lock); // acquire the lock
-    
-    struct PerSocketData *data =
-    (struct PerSocketData *)uws_ws_get_user_data(SSL, ws);
-    
-    if (data) {
-        uws_ws_send(SSL, ws, message, length, TEXT);
+static app_context_t *app_for_socket(const void *socket) {
+    return app_at((int)((uint64_t)(uintptr_t)socket >> SOCKET_ID_APP_SHIFT));
+}
+
+/// Called by the controllers, from any thread. `socket` is the id of the socket, not a pointer to it.
+/// Direct answers are always JSON, only topics carry binary frames.
+void realtime_msg_forward(const char *_Nonnull message, size_t length, const void *_Nonnull socket) {
+    app_context_t *ctx = app_for_socket(socket);
+    if (ctx) {
+        queue_message(ctx, OUTBOX_SEND, TEXT, (uint64_t)(uintptr_t)socket, NULL, 0, message, length);
+    }
+}
+
+/// Sends `message` to every socket subscribed to `topic`, from any thread.
+/// Each app publishes to its own sockets, from its own loop. Large binary frames are deflated here, once for every
+/// app and socket, rather than by the compressor of each socket (see `compression_policy`).
+void realtime_publish(const char *_Nonnull topic, size_t topic_length, const char *_Nonnull message, size_t length, bool binary) {
+    char *compressed = NULL;
+    if (binary && compression_policy((const uint8_t *)message, length, binary) == COMPRESSION_PRECOMPRESSED) {
+        compressed = malloc(length);
+        size_t compressed_length = compression_precompress_frame((const uint8_t *)message, length, (uint8_t *)compressed);
+        if (compressed_length > 0) {
+            message = compressed;
+            length = compressed_length;
+        }
+    }
+    for (int i = 0; i < MAX_APPS; i++) {
+        app_context_t *ctx = app_at(i);
+        if (ctx) {
+            queue_message(ctx, OUTBOX_PUBLISH, binary ? BINARY : TEXT, 0, topic, topic_length, message, length);
+        }
+    }
+    free(compressed);
+}
+
+/// Subscribes, or unsubscribes, a socket to `topic`, from any thread.
+void realtime_subscribe(const void *_Nonnull socket, const char *_Nonnull topic, size_t topic_length, bool subscribe) {
+    app_context_t *ctx = app_for_socket(socket);
+    if (ctx) {
+        queue_message(ctx, subscribe ? OUTBOX_SUBSCRIBE : OUTBOX_UNSUBSCRIBE, TEXT, (uint64_t)(uintptr_t)socket,
+                    topic, topic_length, NULL, 0);
     }
-    pthread_mutex_unlock(&lock); // release the lock
 }
 
 
 void open_handler(uws_websocket_t *ws, void * arg) {
     
-    /* Open event here, you may access uws_ws_get_user_data(ws) which points to a
+    /* Open event here, you may access socket_data(ws) which points to a
      * PerSocketData struct. Here we simply validate that indeed, something == 15
      * as set in upgrade handler. */
     
-    struct PerSocketData *data =
-    (struct PerSocketData *)uws_ws_get_user_data(SSL, ws);
+    struct PerSocketData *data = socket_data(ws);
+    app_context_t *ctx = (app_context_t *)arg;
+    
+    data->id = next_socket_id(ctx);
+    bool live = live_sockets_insert(&ctx->live, data->id, ws);
     
     // Create an instance of RealtimeServerController
     int controller = _create_realtime_server_controller(
-                                                        data->server->dataStore->_wrapper, realtime_msg_forward, ws);
+                                                        data->server->dataStore->_wrapper, realtime_msg_forward, (const void *)(uintptr_t)data->id, data->binary);
     
     data->controller = controller;
+    
+    if (!live) {
+        // Its messages could never be delivered. The close handler releases the controller.
+        printf("Out of memory, closing socket %llu\n", (unsigned long long)data->id);
+        uws_ws_end(SSL, ws, 1011, NULL, 0);
+    }
 }
 
 void message_handler(uws_websocket_t *ws, const char *message, size_t length,
                      uws_opcode_t opcode, void * arg) {
-    struct PerSocketData *data =
-    (struct PerSocketData *)uws_ws_get_user_data(SSL, ws);
+    struct PerSocketData *data = socket_data(ws);
     int controller = data->controller;
     
     _realtime_server_handle_request(controller, message, length);
@@ -185,18 +609,24 @@ void message_handler(uws_websocket_t *ws, const char *message, size_t length,
 void close_handler(uws_websocket_t *ws, int code, const char *message,
                    size_t length, void * arg) {
     
-    /* You may access uws_ws_get_user_data(ws) here, but sending or
+    /* You may access socket_data(ws) here, but sending or
      * doing any kind of I/O with the socket is not valid. */
-    struct PerSocketData *data =
-    (struct PerSocketData *)uws_ws_get_user_data(SSL, ws);
-    if (data) {
-        _close_realtime_server_controller(data->controller);
-        free(data);
+    struct PerSocketData *data = socket_data(ws);
+    if (data->conflation) {
+        conflation_forget((app_context_t *)arg, data);
     }
+    live_sockets_remove(&((app_context_t *)arg)->live, data->id);
+    _close_realtime_server_controller(data->controller);
 }
 
 void drain_handler(uws_websocket_t *ws, void * arg) {
-    /* Check uws_ws_get_buffered_amount(ws) here */
+    struct PerSocketData *data = socket_data(ws);
+    unsigned int buffered = uws_ws_get_buffered_amount(SSL, ws);
+    if (!data->conflation && buffered > CONFLATION_THRESHOLD) {
+        conflation_begin((app_context_t *)arg, ws, data);
+    } else if (data->conflation && buffered < CONFLATION_RESUME) {
+        conflation_end((app_context_t *)arg, ws, data);
+    }
 }
 
 void ping_handler(uws_websocket_t *ws, const char *message, size_t length, void * arg) {
@@ -209,6 +639,166 @@ void pong_handler(uws_websocket_t *ws, const char *message, size_t length, void
     /* You don't need to handle this one either */
 }
 
+// MARK: - HTTP snapshots
+
+/// Body of a GET endpoint, serialized once per block by Swift (see `HTTPSnapshots.swift`). Immutable once stored:
+/// requests keep a reference while they answer, and the last one frees it.
+typedef struct {
+    int references;
+    char etag[18]; // Quoted FNV-1a of the body
+    size_t length;
+    char body[];
+} snapshot_t;
+
+typedef struct {
+    const char *path;
+    pthread_mutex_t lock;
+    snapshot_t *current; // NULL until the first block
+} snapshot_endpoint_t;
+
+static snapshot_endpoint_t snapshot_endpoints[] = {
+    {.path = "/matrix", .lock = PTHREAD_MUTEX_INITIALIZER},
+    {.path = "/tokens", .lock = PTHREAD_MUTEX_INITIALIZER},
+    {.path = "/opportunities", .lock = PTHREAD_MUTEX_INITIALIZER},
+};
+#define SNAPSHOT_ENDPOINT_COUNT (sizeof(snapshot_endpoints) / sizeof(snapshot_endpoint_t))
+
+static void snapshot_release(snapshot_t *snapshot) {
+    if (snapshot && __atomic_sub_fetch(&snapshot->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(snapshot);
+    }
+}
+
+static snapshot_t *snapshot_retain(snapshot_endpoint_t *endpoint) {
+    pthread_mutex_lock(&endpoint->lock);
+    snapshot_t *snapshot = endpoint->current;
+    if (snapshot) {
+        __atomic_add_fetch(&snapshot->references, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&endpoint->lock);
+    return snapshot;
+}
+
+/// Replaces the body of the endpoint at `path`, from any thread. The ETag is a hash of the body, so an unchanged body
+/// keeps answering 304 to clients that have it.
+void realtime_store_snapshot(const char *_Nonnull path, size_t path_length, const char *_Nonnull body, size_t length) {
+    snapshot_endpoint_t *endpoint = NULL;
+    for (size_t i = 0; i < SNAPSHOT_ENDPOINT_COUNT; i++) {
+        if (strlen(snapshot_endpoints[i].path) == path_length && memcmp(snapshot_endpoints[i].path, path, path_length) == 0) {
+            endpoint = &snapshot_endpoints[i];
+        }
+    }
+    if (!endpoint) return;
+    
+    snapshot_t *snapshot = malloc(sizeof(snapshot_t) + length);
+    snapshot->references = 1;
+    snapshot->length = length;
+    memcpy(snapshot->body, body, length);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)body[i]) * 0x100000001b3ull;
+    }
+    snapshot->etag[0] = '"';
+    for (int i = 0; i < 16; i++) {
+        snapshot->etag[1 + i] = "0123456789abcdef"[(hash >> (60 - 4 * i)) & 0xf];
+    }
+    snapshot->etag[17] = '"';
+    
+    pthread_mutex_lock(&endpoint->lock);
+    snapshot_t *previous = endpoint->current;
+    endpoint->current = snapshot;
+    pthread_mutex_unlock(&endpoint->lock);
+    snapshot_release(previous);
+}
+
+typedef struct {
+    snapshot_t *snapshot;
+    bool not_modified;
+} snapshot_response_t;
+
+static void snapshot_respond(uws_res_t *res, void *user_data) {
+    snapshot_response_t *response = (snapshot_response_t *)user_data;
+    snapshot_t *snapshot = response->snapshot;
+    if (!snapshot) {
+        uws_res_write_status(SSL, res, "503 Service Unavailable", 23);
+        uws_res_write_header(SSL, res, "Retry-After", 11, "1", 1);
+        uws_res_end_without_body(SSL, res, false);
+        return;
+    }
+    uws_res_write_status(SSL, res, response->not_modified ? "304 Not Modified" : "200 OK", response->not_modified ? 16 : 6);
+    uws_res_write_header(SSL, res, "ETag", 4, snapshot->etag, sizeof(snapshot->etag));
+    uws_res_write_header(SSL, res, "Cache-Control", 13, "no-cache", 8);
+    uws_res_write_header(SSL, res, "Access-Control-Allow-Origin", 27, "*", 1);
+    if (response->not_modified) {
+        uws_res_end_without_body(SSL, res, false);
+    } else {
+        uws_res_write_header(SSL, res, "Content-Type", 12, "application/json", 16);
+        uws_res_end(SSL, res, snapshot->body, snapshot->length, false); // Copied by uWS if it can't all be sent now
+    }
+}
+
+/// Answers from the cached snapshot, with a single corked write
+static void snapshot_get_handler(uws_res_t *res, uws_req_t *req, void *user_data) {
+    snapshot_response_t response = {.snapshot = snapshot_retain((snapshot_endpoint_t *)user_data)};
+    if (response.snapshot) {
+        const char *match = NULL;
+        size_t match_length = uws_req_get_header(req, "if-none-match", 13, &match);
+        response.not_modified = match_length == sizeof(response.snapshot->etag)
+            && memcmp(match, response.snapshot->etag, match_length) == 0;
+    }
+    uws_res_cork(SSL, res, snapshot_respond, &response);
+    snapshot_release(response.snapshot);
+}
+
+// MARK: - Metrics
+
+/// Large enough for every metric, see `metrics_render`
+#define METRICS_BUFFER_SIZE (16 * 1024)
+/// Renders tried with a larger buffer before giving up, if metrics keep growing in between
+#define METRICS_RENDER_ATTEMPTS 4
+
+typedef struct {
+    const char *status;
+    const char *text;
+    size_t length;
+} metrics_response_t;
+
+static void metrics_respond(uws_res_t *res, void *user_data) {
+    metrics_response_t *response = (metrics_response_t *)user_data;
+    uws_res_write_status(SSL, res, response->status, strlen(response->status));
+    uws_res_write_header(SSL, res, "Content-Type", 12, "text/plain; version=0.0.4", 25);
+    uws_res_end(SSL, res, response->text, response->length, false);
+}
+
+/// Prometheus scrape of `metrics.h`
+static void metrics_get_handler(uws_res_t *res, uws_req_t *req, void *user_data) {
+    char buffer[METRICS_BUFFER_SIZE];
+    char *text = buffer;
+    char *grown = NULL;
+    size_t capacity = sizeof(buffer);
+    size_t length = metrics_render(text, capacity);
+    for (int attempt = 0; length >= capacity && attempt < METRICS_RENDER_ATTEMPTS; attempt++) {
+        // Stage names or new metrics outgrew the buffer. Counters may gain digits before the next render.
+        size_t larger = length + 256;
+        char *resized = realloc(grown, larger);
+        if (!resized) {
+            break;
+        }
+        text = grown = resized;
+        capacity = larger;
+        length = metrics_render(text, capacity);
+    }
+
+    metrics_response_t response = {.status = "200 OK", .text = text, .length = length};
+    if (length >= capacity) {
+        // Never send a truncated exposition, Prometheus would reject it
+        static const char error[] = "Metrics could not be rendered\n";
+        response = (metrics_response_t){.status = "500 Internal Server Error", .text = error, .length = sizeof(error) - 1};
+    }
+    uws_res_cork(SSL, res, metrics_respond, &response);
+    free(grown);
+}
+
 // MARK: - Public
 
 PriceDataStore *create_store(void) {
@@ -235,13 +825,48 @@ void pipe_function(PriceDataStore *dataStore) {
                                             memcpy(cTokens + i, &temp, sizeof(CToken));
                                         }
                                         
+                                        uint64_t start = latency_now();
                                         dataStore->on_tick(dataStore, array, cTokens, size, systemTime);
+                                        latency_mark(systemTime, LATENCY_STAGE_STRATEGY);
+                                        metrics_observe(METRIC_TICK_DURATION, latency_now() - start);
+                                        metrics_increment(METRIC_TICKS);
                                         
                                         // Free the dynamically allocated memory
                                         free(cTokens);
                                     });
 }
 
+/// WebSocket route, snapshot and metrics endpoints of an app. Must be called on the thread that will run it.
+static void configure_app(uws_app_t *app, uint16_t index) {
+    uws_ws_inline(SSL, app, "/*",
+           (uws_socket_behavior_t){
+        .compression = SHARED_COMPRESSOR,
+        .maxPayloadLength = 16 * 1024,
+        .idleTimeout = 0, // 10 minutes
+        .maxBackpressure = MAX_BACKPRESSURE,
+        .closeOnBackpressureLimit = false,
+        .upgrade = upgrade_handler,
+        .open = open_handler,
+        .message = message_handler,
+        .drain = drain_handler,
+        .ping = ping_handler,
+        .pong = pong_handler,
+        .close = close_handler,
+    },
+           sizeof(struct PerSocketData), create_app_context(app, index));
+    for (size_t i = 0; i < SNAPSHOT_ENDPOINT_COUNT; i++) {
+        uws_app_get(SSL, app, snapshot_endpoints[i].path, snapshot_get_handler, &snapshot_endpoints[i]);
+    }
+    uws_app_get(SSL, app, "/metrics", metrics_get_handler, NULL);
+}
+
+/// Listens with `SO_REUSEPORT`, so that every server thread can accept on the same port
+static void listen_app(uws_app_t *app, int port) {
+    uws_app_listen_with_config(SSL, app,
+                               (uws_app_listen_config_t){.port = port, .host = NULL, .options = LIBUS_LISTEN_DEFAULT},
+                               listen_handler, NULL);
+}
+
 /// Creates the web socket server.
 /// @discussion Allocates memory and sets up basic server parameters.
 /// @param config The server configuration file.
@@ -252,6 +877,9 @@ Server *new_server(const char *_Nullable config) {
     uws_app_t *app = uws_create_app(SSL, (struct us_socket_context_options_t){});
     
     // Create and initialize the Server struct
+    _register_realtime_topics(realtime_publish, realtime_subscribe);
+    _register_http_snapshots(realtime_store_snapshot);
+    
     Server *server = (Server *)malloc(sizeof(Server));
     server->pipe = pipe_function;
     server->app = app;
@@ -261,21 +889,7 @@ Server *new_server(const char *_Nullable config) {
     (struct PerSocketData *)malloc(sizeof(struct PerSocketData));
     socket_data_base->server = server;
     
-    uws_ws(SSL, app, "/*",
-           (uws_socket_behavior_t){
-        .compression = SHARED_COMPRESSOR,
-        .maxPayloadLength = 16 * 1024,
-        .idleTimeout = 0, // 10 minutes
-        .maxBackpressure = 0,
-        .upgrade = upgrade_handler,
-        .open = open_handler,
-        .message = message_handler,
-        .drain = drain_handler,
-        .ping = ping_handler,
-        .pong = pong_handler,
-        .close = close_handler,
-    },
-           NULL);
+    configure_app(app, 0);
     
     return server;
 }
@@ -283,13 +897,57 @@ Server *new_server(const char *_Nullable config) {
 void start_server(Server *server, int port) {
     uws_app_t *app = server->app;
     
-    uws_app_listen(SSL, app, port, listen_handler, NULL);
+    listen_app(app, port);
     
     _loadConfigurationFile(server->config, server->dataStore->_wrapper);
     
     uws_app_run(SSL, app);
 }
 
+typedef struct {
+    int port;
+    uint16_t index;
+} server_thread_t;
+
+static void *run_server_thread(void *arg) {
+    server_thread_t *thread = (server_thread_t *)arg;
+    
+    // The app and its loop belong to this thread
+    uws_app_t *app = uws_create_app(SSL, (struct us_socket_context_options_t){});
+    configure_app(app, thread->index);
+    listen_app(app, thread->port);
+    free(thread);
+    
+    uws_app_run(SSL, app);
+    return NULL;
+}
+
+void start_server_threads(Server *server, int port, int threads) {
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > MAX_APPS) {
+        threads = MAX_APPS;
+    }
+    
+    // The app of `new_server` runs on this thread, the others get their own
+    for (int i = 1; i < threads; i++) {
+        server_thread_t *thread = malloc(sizeof(server_thread_t));
+        thread->port = port;
+        thread->index = (uint16_t)i;
+        
+        pthread_t id;
+        if (pthread_create(&id, NULL, run_server_thread, thread) != 0) {
+            printf("Failed to start server thread %d\n", i);
+            free(thread);
+            break;
+        }
+        pthread_detach(id);
+    }
+    
+    start_server(server, port);
+}
+
 void get_name_for_token(void *_Nonnull dataStore, const uint8_t * _Nonnull tokenAddress,
                         char *_Nonnull result) {
     PriceDataStore *store = (PriceDataStore *)dataStore;
@@ -299,6 +957,7 @@ void get_name_for_token(void *_Nonnull dataStore, const uint8_t * _Nonnull token
 void add_opportunity_in_queue(void *_Nonnull dataStore, int *_Nonnull order,
                               size_t size, size_t systemTime) {
     PriceDataStore *store = (PriceDataStore *)dataStore;
+    metrics_increment(METRIC_CYCLES_FOUND);
     _add_opportunity_for_review(store->_wrapper, order, size, systemTime);
 }
 
@@ -306,3 +965,7 @@ void process_opportunities(void *_Nonnull dataStore, size_t systemTime) {
     PriceDataStore *store = (PriceDataStore *)dataStore;
     _review_and_process_opportunities(store->_wrapper, systemTime);
 }
+
+void trace_cycle_search(size_t systemTime) {
+    latency_mark((uint32_t)systemTime, LATENCY_STAGE_CYCLE_SEARCH);
+}
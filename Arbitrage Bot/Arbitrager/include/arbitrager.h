@@ -88,6 +88,11 @@ void add_opportunity_in_queue(void * _Nonnull dataStore, int * _Nonnull order, s
 /// @param systemTime (size_t) System time when this function is executed.
 void process_opportunities(void * _Nonnull dataStore, size_t systemTime);
 
+/// Records that the strategy is done searching for cycles in this tick, for the `latency` topic.
+/// @discussion Time spent in `on_tick` before this call is reported as the cycle search, the rest of `on_tick` as the strategy itself.
+/// @param systemTime (size_t) System time passed to `on_tick`.
+void trace_cycle_search(size_t systemTime);
+
 /// Server is a structure representing the arbitrage bot server.
 /// @field dataStore (_Nonnull PriceDataStore*) Instance of the PriceDataStore.
 /// @field app (_Nonnull void*) Generic pointer representing application-specific data.
@@ -120,4 +125,12 @@ PriceDataStore * _Nonnull create_store(void);
 /// @param port (int) The port number on which the server should listen.
 void start_server(Server * _Nonnull server, int port);
 
+/// Starts the server on a specific port, with one uWebSockets app per thread.
+/// @discussion Every thread accepts on the same port (`SO_REUSEPORT`), the kernel balancing connections between them, and runs its own event loop: handshakes, compression and sends are spread over the threads. Published updates are handed to every app, and sent by each one from its own loop. The calling thread runs the first app, like ``start_server(server, port)``.
+/// > On macOS, `SO_REUSEPORT` doesn't balance connections: prefer ``start_server(server, port)`` there.
+/// @param server (_Nonnull Server*) The server to be started.
+/// @param port (int) The port number on which the server should listen.
+/// @param threads (int) Number of threads, `0` for one per core.
+void start_server_threads(Server * _Nonnull server, int port, int threads);
+
 #endif // FRONT_ARBITRAGE_H
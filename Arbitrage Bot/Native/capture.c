@@ -0,0 +1,626 @@
+//
+//  capture.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/capture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Captures are stored little-endian and read in place"
+#endif
+
+_Static_assert(sizeof(capture_record_header_t) == 8, "Record headers must keep payloads 8-byte aligned");
+_Static_assert(sizeof(capture_token_t) % 8 == 0, "Records must keep the file 8-byte aligned");
+_Static_assert(sizeof(capture_exchange_t) % 8 == 0, "Records must keep the file 8-byte aligned");
+_Static_assert(sizeof(capture_block_t) % 8 == 0, "Records must keep the file 8-byte aligned");
+_Static_assert(sizeof(capture_reserve_t) == 56, "Reserves must stay packed");
+
+// MARK: - File layout
+
+static const char data_magic[8] = { 'A', 'R', 'B', 'C', 'A', 'P', '0', '1' };
+static const char index_magic[8] = { 'A', 'R', 'B', 'I', 'D', 'X', '0', '1' };
+
+/// Shared by both files, `length` is the committed size of the data file, or the number of entries of the index.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t length;
+    uint64_t reserved[5];
+} file_header_t;
+
+_Static_assert(sizeof(file_header_t) == 64, "File headers are 64 bytes");
+
+#define INITIAL_CAPACITY (1ULL << 20)
+#define MAX_GROWTH (1ULL << 30)
+
+typedef struct {
+    int fd;
+    uint8_t *base;
+    uint64_t capacity;
+} mapping_t;
+
+static bool mapping_open(mapping_t *mapping, const char *path, int flags) {
+    mapping->fd = open(path, flags, 0644);
+    mapping->base = NULL;
+    mapping->capacity = 0;
+    if (mapping->fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(mapping->fd, &info) != 0) {
+        close(mapping->fd);
+        return false;
+    }
+    mapping->capacity = (uint64_t)info.st_size;
+    return true;
+}
+
+static bool mapping_map(mapping_t *mapping, bool writable) {
+    if (mapping->capacity == 0) {
+        return true;
+    }
+    void *base = mmap(NULL, mapping->capacity, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, mapping->fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    mapping->base = base;
+    return true;
+}
+
+static void mapping_close(mapping_t *mapping, uint64_t length, bool writable) {
+    if (mapping->base) {
+        if (writable) {
+            msync(mapping->base, mapping->capacity, MS_SYNC);
+        }
+        munmap(mapping->base, mapping->capacity);
+    }
+    if (mapping->fd >= 0) {
+        if (writable && ftruncate(mapping->fd, (off_t)length) != 0) {
+            perror("capture: truncate");
+        }
+        close(mapping->fd);
+    }
+    mapping->base = NULL;
+    mapping->fd = -1;
+}
+
+/// Makes sure `size` bytes are mapped, growing the file geometrically (up to `MAX_GROWTH` at once).
+static bool mapping_reserve(mapping_t *mapping, uint64_t size) {
+    if (size <= mapping->capacity) {
+        return true;
+    }
+    uint64_t growth = mapping->capacity < INITIAL_CAPACITY ? INITIAL_CAPACITY : mapping->capacity;
+    growth = growth > MAX_GROWTH ? MAX_GROWTH : growth;
+    uint64_t capacity = mapping->capacity + growth;
+    if (capacity < size) {
+        capacity = (size + INITIAL_CAPACITY - 1) & ~(INITIAL_CAPACITY - 1);
+    }
+    if (ftruncate(mapping->fd, (off_t)capacity) != 0) {
+        return false;
+    }
+    if (mapping->base) {
+        munmap(mapping->base, mapping->capacity);
+        mapping->base = NULL;
+    }
+    mapping->capacity = capacity;
+    return mapping_map(mapping, true);
+}
+
+static bool header_is_valid(const mapping_t *mapping, const char magic[8]) {
+    if (mapping->capacity < sizeof(file_header_t)) {
+        return false;
+    }
+    const file_header_t *header = (const file_header_t *)mapping->base;
+    return memcmp(header->magic, magic, 8) == 0 && header->version == CAPTURE_VERSION
+        && header->header_size == sizeof(file_header_t);
+}
+
+static void header_init(mapping_t *mapping, const char magic[8], uint64_t length) {
+    file_header_t *header = (file_header_t *)mapping->base;
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, magic, 8);
+    header->version = CAPTURE_VERSION;
+    header->header_size = sizeof(file_header_t);
+    header->length = length;
+}
+
+static inline uint64_t header_length(const mapping_t *mapping) {
+    return __atomic_load_n(&((const file_header_t *)mapping->base)->length, __ATOMIC_ACQUIRE);
+}
+
+static inline void header_commit(mapping_t *mapping, uint64_t length) {
+    __atomic_store_n(&((file_header_t *)mapping->base)->length, length, __ATOMIC_RELEASE);
+}
+
+static char *index_path(const char *path) {
+    size_t length = strlen(path);
+    char *result = malloc(length + 5);
+    if (result) {
+        memcpy(result, path, length);
+        memcpy(result + length, ".idx", 5);
+    }
+    return result;
+}
+
+// MARK: - Scanning
+
+/// Walks the committed records of a data file, calling `visit` with the index entry of each block.
+/// Used to rebuild a missing or stale index.
+static bool scan_blocks(const uint8_t *base, uint64_t used, bool (*visit)(void *context, capture_index_entry_t entry),
+                        void *context) {
+    uint64_t position = sizeof(file_header_t);
+    uint64_t tables = UINT64_MAX; // start of the tables preceding the next block
+    while (position + sizeof(capture_record_header_t) <= used) {
+        const capture_record_header_t *header = (const capture_record_header_t *)(base + position);
+        uint64_t end = position + sizeof(*header) + header->size;
+        if (end > used) {
+            return false;
+        }
+        if (header->type == CAPTURE_RECORD_BLOCK) {
+            const capture_block_t *block = (const capture_block_t *)(header + 1);
+            bool keyframe = block->flags & CAPTURE_BLOCK_KEYFRAME;
+            capture_index_entry_t entry = {
+                .block = block->block,
+                .offset = keyframe && tables != UINT64_MAX ? tables : position,
+                .flags = block->flags,
+            };
+            if (!visit(context, entry)) {
+                return false;
+            }
+            tables = UINT64_MAX;
+        } else if (tables == UINT64_MAX) {
+            tables = position;
+        }
+        position = end;
+    }
+    return true;
+}
+
+// MARK: - Writer
+
+struct capture_writer {
+    mapping_t data;
+    mapping_t index;
+    /// Write cursor, everything before `committed` is visible to readers
+    uint64_t position;
+    uint64_t committed;
+    uint64_t index_count;
+
+    bool in_block;
+    uint64_t block_offset;
+    uint64_t entry_offset;
+    uint32_t reserve_count;
+    uint32_t block_flags;
+    uint64_t last_block;
+    bool has_keyframe;
+
+    capture_token_t *tokens;
+    size_t token_count;
+    size_t token_capacity;
+    capture_exchange_t *exchanges;
+    size_t exchange_count;
+    size_t exchange_capacity;
+};
+
+static bool writer_append(capture_writer_t *writer, capture_record_type_t type, const void *payload, uint32_t size) {
+    uint64_t end = writer->position + sizeof(capture_record_header_t) + size;
+    if (!mapping_reserve(&writer->data, end)) {
+        return false;
+    }
+    capture_record_header_t *header = (capture_record_header_t *)(writer->data.base + writer->position);
+    header->type = type;
+    header->size = size;
+    memcpy(header + 1, payload, size);
+    writer->position = end;
+    return true;
+}
+
+static bool writer_index(capture_writer_t *writer, capture_index_entry_t entry) {
+    uint64_t offset = sizeof(file_header_t) + writer->index_count * sizeof(capture_index_entry_t);
+    if (!mapping_reserve(&writer->index, offset + sizeof(entry))) {
+        return false;
+    }
+    memcpy(writer->index.base + offset, &entry, sizeof(entry));
+    writer->index_count++;
+    writer->last_block = entry.block;
+    return true;
+}
+
+static bool writer_index_visit(void *context, capture_index_entry_t entry) {
+    return writer_index(context, entry);
+}
+
+static void copy_name(char destination[CAPTURE_NAME_LENGTH], uint8_t *length, const char *name) {
+    size_t count = strnlen(name, CAPTURE_NAME_LENGTH);
+    memset(destination, 0, CAPTURE_NAME_LENGTH);
+    memcpy(destination, name, count);
+    *length = (uint8_t)count;
+}
+
+static bool grow_table(void **table, size_t *capacity, size_t count, size_t size) {
+    if (count < *capacity) {
+        return true;
+    }
+    size_t next = *capacity ? *capacity * 2 : 64;
+    void *grown = realloc(*table, next * size);
+    if (!grown) {
+        return false;
+    }
+    *table = grown;
+    *capacity = next;
+    return true;
+}
+
+capture_writer_t *capture_writer_open(const char *path) {
+    capture_writer_t *writer = calloc(1, sizeof(*writer));
+    char *path_index = index_path(path);
+    if (!writer || !path_index) {
+        free(writer);
+        free(path_index);
+        errno = ENOMEM;
+        return NULL;
+    }
+    writer->data.fd = -1;
+    writer->index.fd = -1;
+
+    if (!mapping_open(&writer->data, path, O_RDWR | O_CREAT) || !mapping_map(&writer->data, true)
+        || !mapping_open(&writer->index, path_index, O_RDWR | O_CREAT) || !mapping_map(&writer->index, true)) {
+        goto fail;
+    }
+
+    // Data file: resume after the last committed block, anything after it was never committed
+    if (writer->data.capacity == 0) {
+        if (!mapping_reserve(&writer->data, sizeof(file_header_t))) {
+            goto fail;
+        }
+        header_init(&writer->data, data_magic, sizeof(file_header_t));
+    } else if (!header_is_valid(&writer->data, data_magic)) {
+        errno = EINVAL;
+        goto fail;
+    }
+    writer->committed = writer->position = header_length(&writer->data);
+    if (writer->position < sizeof(file_header_t) || writer->position > writer->data.capacity) {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    // Index: trusted when it covers exactly the committed blocks, rebuilt otherwise
+    if (writer->index.capacity == 0 && !mapping_reserve(&writer->index, sizeof(file_header_t))) {
+        goto fail;
+    }
+    bool rebuild = !header_is_valid(&writer->index, index_magic);
+    if (!rebuild) {
+        uint64_t count = header_length(&writer->index);
+        uint64_t size = sizeof(file_header_t) + count * sizeof(capture_index_entry_t);
+        rebuild = size > writer->index.capacity;
+        if (!rebuild && count > 0) {
+            const capture_index_entry_t *entries = (const capture_index_entry_t *)(writer->index.base + sizeof(file_header_t));
+            const capture_record_header_t *last = (const capture_record_header_t *)(writer->data.base + entries[count - 1].offset);
+            rebuild = entries[count - 1].offset >= writer->position
+                || (last->type == CAPTURE_RECORD_BLOCK
+                    && entries[count - 1].offset + sizeof(*last) + last->size != writer->position);
+        }
+        if (!rebuild) {
+            writer->index_count = count;
+            const capture_index_entry_t *entries = (const capture_index_entry_t *)(writer->index.base + sizeof(file_header_t));
+            writer->last_block = count > 0 ? entries[count - 1].block : 0;
+        }
+    }
+    if (rebuild) {
+        header_init(&writer->index, index_magic, 0);
+        writer->index_count = 0;
+        if (!scan_blocks(writer->data.base, writer->position, writer_index_visit, writer)) {
+            errno = EINVAL;
+            goto fail;
+        }
+        header_commit(&writer->index, writer->index_count);
+    }
+
+    free(path_index);
+    return writer;
+
+fail:;
+    int error = errno;
+    mapping_close(&writer->data, 0, false);
+    mapping_close(&writer->index, 0, false);
+    free(writer);
+    free(path_index);
+    errno = error;
+    return NULL;
+}
+
+bool capture_writer_add_token(capture_writer_t *writer, uint16_t id, const uint8_t *address, const char *name, uint8_t decimals) {
+    if (writer->in_block || !grow_table((void **)&writer->tokens, &writer->token_capacity, writer->token_count, sizeof(capture_token_t))) {
+        return false;
+    }
+    capture_token_t *token = &writer->tokens[writer->token_count++];
+    token->id = id;
+    token->decimals = decimals;
+    memcpy(token->address, address, CAPTURE_ADDRESS_LENGTH);
+    copy_name(token->name, &token->name_length, name);
+    // Before the first keyframe, the definition will be written with the tables
+    return !writer->has_keyframe || writer_append(writer, CAPTURE_RECORD_TOKEN, token, sizeof(*token));
+}
+
+bool capture_writer_add_exchange(capture_writer_t *writer, uint16_t id, const char *name) {
+    if (writer->in_block || !grow_table((void **)&writer->exchanges, &writer->exchange_capacity, writer->exchange_count, sizeof(capture_exchange_t))) {
+        return false;
+    }
+    capture_exchange_t *exchange = &writer->exchanges[writer->exchange_count++];
+    memset(exchange, 0, sizeof(*exchange));
+    exchange->id = id;
+    copy_name(exchange->name, &exchange->name_length, name);
+    return !writer->has_keyframe || writer_append(writer, CAPTURE_RECORD_EXCHANGE, exchange, sizeof(*exchange));
+}
+
+bool capture_writer_begin_block(capture_writer_t *writer, uint64_t block, uint64_t timestamp, bool keyframe) {
+    if (writer->in_block || (writer->index_count > 0 && block <= writer->last_block)) {
+        errno = EINVAL;
+        return false;
+    }
+    keyframe = keyframe || !writer->has_keyframe;
+    writer->entry_offset = writer->position;
+    if (keyframe) {
+        for (size_t i = 0; i < writer->token_count; i++) {
+            if (!writer_append(writer, CAPTURE_RECORD_TOKEN, &writer->tokens[i], sizeof(capture_token_t))) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < writer->exchange_count; i++) {
+            if (!writer_append(writer, CAPTURE_RECORD_EXCHANGE, &writer->exchanges[i], sizeof(capture_exchange_t))) {
+                return false;
+            }
+        }
+    }
+    capture_block_t header = {
+        .block = block,
+        .timestamp = timestamp,
+        .reserve_count = 0,
+        .flags = keyframe ? CAPTURE_BLOCK_KEYFRAME : 0,
+    };
+    writer->block_offset = writer->position;
+    if (!writer_append(writer, CAPTURE_RECORD_BLOCK, &header, sizeof(header))) {
+        return false;
+    }
+    if (!keyframe) {
+        writer->entry_offset = writer->block_offset;
+    }
+    writer->in_block = true;
+    writer->reserve_count = 0;
+    writer->block_flags = header.flags;
+    return true;
+}
+
+bool capture_writer_add_reserve(capture_writer_t *writer, const capture_reserve_t *reserve) {
+    if (!writer->in_block) {
+        errno = EINVAL;
+        return false;
+    }
+    uint64_t end = writer->position + sizeof(*reserve);
+    if (!mapping_reserve(&writer->data, end)) {
+        return false;
+    }
+    memcpy(writer->data.base + writer->position, reserve, sizeof(*reserve));
+    writer->position = end;
+    writer->reserve_count++;
+    return true;
+}
+
+bool capture_writer_end_block(capture_writer_t *writer) {
+    if (!writer->in_block) {
+        errno = EINVAL;
+        return false;
+    }
+    capture_record_header_t *header = (capture_record_header_t *)(writer->data.base + writer->block_offset);
+    capture_block_t *block = (capture_block_t *)(header + 1);
+    header->size = (uint32_t)(writer->position - writer->block_offset - sizeof(*header));
+    block->reserve_count = writer->reserve_count;
+
+    capture_index_entry_t entry = { .block = block->block, .offset = writer->entry_offset, .flags = writer->block_flags };
+    if (!writer_index(writer, entry)) {
+        return false;
+    }
+    // Data first, so that every indexed block is committed
+    writer->committed = writer->position;
+    header_commit(&writer->data, writer->committed);
+    header_commit(&writer->index, writer->index_count);
+    writer->in_block = false;
+    writer->has_keyframe = true;
+    return true;
+}
+
+uint64_t capture_writer_last_block(const capture_writer_t *writer) {
+    return writer->index_count > 0 ? writer->last_block : 0;
+}
+
+void capture_writer_close(capture_writer_t *writer) {
+    if (!writer) {
+        return;
+    }
+    mapping_close(&writer->data, writer->committed, true);
+    mapping_close(&writer->index, sizeof(file_header_t) + writer->index_count * sizeof(capture_index_entry_t), true);
+    free(writer->tokens);
+    free(writer->exchanges);
+    free(writer);
+}
+
+// MARK: - Reader
+
+struct capture_reader {
+    mapping_t data;
+    mapping_t index;
+    uint64_t used;
+    uint64_t position;
+    /// Either points into the index mapping, or to `owned_entries` when the index had to be rebuilt
+    const capture_index_entry_t *entries;
+    size_t entry_count;
+    capture_index_entry_t *owned_entries;
+    size_t owned_capacity;
+};
+
+static bool reader_index_visit(void *context, capture_index_entry_t entry) {
+    capture_reader_t *reader = context;
+    if (!grow_table((void **)&reader->owned_entries, &reader->owned_capacity, reader->entry_count, sizeof(entry))) {
+        return false;
+    }
+    reader->owned_entries[reader->entry_count++] = entry;
+    return true;
+}
+
+capture_reader_t *capture_reader_open(const char *path) {
+    capture_reader_t *reader = calloc(1, sizeof(*reader));
+    char *path_index = index_path(path);
+    if (!reader || !path_index) {
+        free(reader);
+        free(path_index);
+        errno = ENOMEM;
+        return NULL;
+    }
+    reader->index.fd = -1;
+
+    if (!mapping_open(&reader->data, path, O_RDONLY) || !mapping_map(&reader->data, false)) {
+        goto fail;
+    }
+    if (!header_is_valid(&reader->data, data_magic)) {
+        errno = EINVAL;
+        goto fail;
+    }
+    reader->used = header_length(&reader->data);
+    if (reader->used < sizeof(file_header_t) || reader->used > reader->data.capacity) {
+        errno = EINVAL;
+        goto fail;
+    }
+    reader->position = sizeof(file_header_t);
+
+    // Entries past the committed data belong to a block that is being written
+    if (mapping_open(&reader->index, path_index, O_RDONLY) && mapping_map(&reader->index, false)
+        && header_is_valid(&reader->index, index_magic)) {
+        uint64_t count = header_length(&reader->index);
+        if (sizeof(file_header_t) + count * sizeof(capture_index_entry_t) <= reader->index.capacity) {
+            reader->entries = (const capture_index_entry_t *)(reader->index.base + sizeof(file_header_t));
+            reader->entry_count = count;
+            while (reader->entry_count > 0 && reader->entries[reader->entry_count - 1].offset >= reader->used) {
+                reader->entry_count--;
+            }
+        }
+    }
+    if (!reader->entries) {
+        if (!scan_blocks(reader->data.base, reader->used, reader_index_visit, reader)) {
+            errno = EINVAL;
+            goto fail;
+        }
+        reader->entries = reader->owned_entries;
+    }
+
+    free(path_index);
+    return reader;
+
+fail:;
+    int error = errno;
+    capture_reader_close(reader);
+    free(path_index);
+    errno = error;
+    return NULL;
+}
+
+size_t capture_reader_block_count(const capture_reader_t *reader) {
+    return reader->entry_count;
+}
+
+const capture_index_entry_t *capture_reader_index(const capture_reader_t *reader) {
+    return reader->entries;
+}
+
+bool capture_reader_seek(capture_reader_t *reader, uint64_t block) {
+    // Last entry at or before `block`
+    size_t low = 0, high = reader->entry_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (reader->entries[middle].block <= block) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    for (size_t i = low; i > 0; i--) {
+        if (reader->entries[i - 1].flags & CAPTURE_BLOCK_KEYFRAME) {
+            reader->position = reader->entries[i - 1].offset;
+            return true;
+        }
+    }
+    for (size_t i = low; i < reader->entry_count; i++) {
+        if (reader->entries[i].flags & CAPTURE_BLOCK_KEYFRAME) {
+            reader->position = reader->entries[i].offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+void capture_reader_rewind(capture_reader_t *reader) {
+    reader->position = sizeof(file_header_t);
+}
+
+bool capture_reader_next(capture_reader_t *reader, capture_record_t *record) {
+    if (reader->position + sizeof(capture_record_header_t) > reader->used) {
+        return false;
+    }
+    const capture_record_header_t *header = (const capture_record_header_t *)(reader->data.base + reader->position);
+    uint64_t end = reader->position + sizeof(*header) + header->size;
+    if (end > reader->used) {
+        return false;
+    }
+    const void *payload = header + 1;
+    record->type = header->type;
+    record->reserves = NULL;
+    switch (header->type) {
+        case CAPTURE_RECORD_TOKEN:
+            if (header->size < sizeof(capture_token_t)) {
+                return false;
+            }
+            record->token = payload;
+            break;
+        case CAPTURE_RECORD_EXCHANGE:
+            if (header->size < sizeof(capture_exchange_t)) {
+                return false;
+            }
+            record->exchange = payload;
+            break;
+        case CAPTURE_RECORD_BLOCK:
+            record->block = payload;
+            if (header->size < sizeof(capture_block_t)
+                || header->size != sizeof(capture_block_t) + (uint64_t)record->block->reserve_count * sizeof(capture_reserve_t)) {
+                return false;
+            }
+            record->reserves = (const capture_reserve_t *)(record->block + 1);
+            break;
+        default:
+            // Unknown records are skipped, newer writers may add some
+            record->token = payload;
+            break;
+    }
+    reader->position = end;
+    return true;
+}
+
+void capture_reader_close(capture_reader_t *reader) {
+    if (!reader) {
+        return;
+    }
+    mapping_close(&reader->data, 0, false);
+    mapping_close(&reader->index, 0, false);
+    free(reader->owned_entries);
+    free(reader);
+}
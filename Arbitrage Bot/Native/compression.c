@@ -0,0 +1,74 @@
+//
+//  compression.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/compression.h"
+
+#include <string.h>
+#include <zlib.h>
+
+/// Negative window bits: raw deflate, as in permessage-deflate
+#define RAW_WINDOW_BITS (-15)
+
+compression_mode_t compression_policy(const uint8_t *message, size_t length, bool binary) {
+    if (binary && length >= COMPRESSION_FRAME_HEADER && (message[2] & COMPRESSION_FRAME_DEFLATED)) {
+        return COMPRESSION_NONE; // Deflating twice only adds overhead
+    }
+    if (length < COMPRESSION_MIN_SIZE) {
+        return COMPRESSION_NONE;
+    }
+    if (binary && length >= COMPRESSION_PRECOMPRESS_SIZE) {
+        return COMPRESSION_PRECOMPRESSED;
+    }
+    return COMPRESSION_SHARED;
+}
+
+size_t compression_deflate(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, RAW_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    stream.next_in = (Bytef *)src;
+    stream.avail_in = (uInt)len;
+    stream.next_out = dst;
+    stream.avail_out = (uInt)capacity;
+    int status = deflate(&stream, Z_FINISH);
+    size_t written = stream.total_out;
+    deflateEnd(&stream);
+    return status == Z_STREAM_END ? written : 0;
+}
+
+size_t compression_inflate(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, RAW_WINDOW_BITS) != Z_OK) {
+        return 0;
+    }
+    stream.next_in = (Bytef *)src;
+    stream.avail_in = (uInt)len;
+    stream.next_out = dst;
+    stream.avail_out = (uInt)capacity;
+    int status = inflate(&stream, Z_FINISH);
+    size_t written = stream.total_out;
+    inflateEnd(&stream);
+    return status == Z_STREAM_END ? written : 0;
+}
+
+size_t compression_precompress_frame(const uint8_t *frame, size_t len, uint8_t *dst) {
+    if (len <= COMPRESSION_FRAME_HEADER) return 0;
+    // Anything that doesn't fit in `len` isn't worth it
+    size_t payload = compression_deflate(frame + COMPRESSION_FRAME_HEADER, len - COMPRESSION_FRAME_HEADER,
+                                         dst + COMPRESSION_FRAME_HEADER, len - COMPRESSION_FRAME_HEADER - 1);
+    if (payload == 0) return 0;
+    memcpy(dst, frame, COMPRESSION_FRAME_HEADER);
+    dst[2] |= COMPRESSION_FRAME_DEFLATED;
+    dst[4] = (uint8_t)payload;
+    dst[5] = (uint8_t)(payload >> 8);
+    dst[6] = (uint8_t)(payload >> 16);
+    dst[7] = (uint8_t)(payload >> 24);
+    return COMPRESSION_FRAME_HEADER + payload;
+}
@@ -0,0 +1,81 @@
+//
+//  conflation.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/conflation.h"
+#include "include/metrics.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+conflation_t *conflation_create(void) {
+    return calloc(1, sizeof(conflation_t));
+}
+
+void conflation_free(conflation_t *conflation) {
+    for (size_t i = 0; i < conflation->count; i++) {
+        free(conflation->slots[i].topic);
+        free(conflation->slots[i].message);
+    }
+    free(conflation->slots);
+    free(conflation);
+}
+
+conflation_slot_t *conflation_slot(conflation_t *conflation, const char *topic, size_t topic_length) {
+    for (size_t i = 0; i < conflation->count; i++) {
+        conflation_slot_t *slot = &conflation->slots[i];
+        if (slot->topic_length == topic_length && memcmp(slot->topic, topic, topic_length) == 0) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+bool conflation_add_topic(conflation_t *conflation, const char *topic, size_t topic_length) {
+    if (conflation_slot(conflation, topic, topic_length)) return true;
+    if (conflation->count == conflation->capacity) {
+        size_t capacity = conflation->capacity ? conflation->capacity * 2 : 8;
+        conflation_slot_t *slots = realloc(conflation->slots, capacity * sizeof(conflation_slot_t));
+        if (!slots) return false;
+        conflation->slots = slots;
+        conflation->capacity = capacity;
+    }
+    char *copy = malloc(topic_length ? topic_length : 1);
+    if (!copy) return false;
+    memcpy(copy, topic, topic_length);
+    conflation->slots[conflation->count++] = (conflation_slot_t){.topic = copy, .topic_length = topic_length};
+    return true;
+}
+
+bool conflation_remove_topic(conflation_t *conflation, const char *topic, size_t topic_length) {
+    conflation_slot_t *slot = conflation_slot(conflation, topic, topic_length);
+    if (!slot) return false;
+    free(slot->topic);
+    free(slot->message);
+    *slot = conflation->slots[--conflation->count];
+    return true;
+}
+
+void conflation_store(conflation_t *conflation, const char *topic, size_t topic_length,
+                      const char *message, size_t length, int opcode, bool delta) {
+    conflation_slot_t *slot = conflation_slot(conflation, topic, topic_length);
+    if (!slot) return;
+    if (slot->message) {
+        metrics_increment(METRIC_WS_FRAMES_SKIPPED);
+    }
+    free(slot->message);
+    slot->message = delta ? NULL : malloc(length ? length : 1);
+    if (!slot->message) {
+        metrics_increment(METRIC_WS_FRAMES_SKIPPED);
+        slot->resync = true;
+        return;
+    }
+    if (length > 0) {
+        memcpy(slot->message, message, length);
+    }
+    slot->length = length;
+    slot->opcode = opcode;
+}
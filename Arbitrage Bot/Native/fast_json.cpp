@@ -0,0 +1,334 @@
+//
+//  fast_json.cpp
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/fast_json.h"
+
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+/// Forward only cursor over a JSON document. Values we don't need are skipped without being parsed.
+class Cursor {
+public:
+    Cursor(const char *json, size_t len) : p(json), end(json + len) {}
+
+    bool ok() const { return !failed; }
+
+    void skipWhitespace() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (p < end && *p == c) {
+            p++;
+            return true;
+        }
+        return false;
+    }
+
+    char peek() {
+        skipWhitespace();
+        return p < end ? *p : '\0';
+    }
+
+    /// Reads a string, returning its content without quotes.
+    bool string(std::string_view &out) {
+        if (!consume('"')) return fail();
+        const char *start = p;
+        while (p < end) {
+            const void *quote = memchr(p, '"', end - p);
+            if (!quote) return fail();
+            p = static_cast<const char *>(quote);
+            // Count preceding backslashes to know if the quote is escaped
+            size_t backslashes = 0;
+            for (const char *b = p - 1; b >= start && *b == '\\'; b--) backslashes++;
+            if (backslashes % 2 == 0) {
+                out = std::string_view(start, p - start);
+                p++;
+                return true;
+            }
+            p++;
+        }
+        return fail();
+    }
+
+    /// Skips any value, returning its raw span (quotes excluded for strings).
+    bool value(std::string_view &out) {
+        char c = peek();
+        if (c == '"') return string(out);
+        const char *start = p;
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (p < end) {
+                char ch = *p;
+                if (ch == '"') {
+                    std::string_view ignored;
+                    if (!string(ignored)) return false;
+                    continue;
+                }
+                if (ch == '{' || ch == '[') depth++;
+                else if (ch == '}' || ch == ']') {
+                    depth--;
+                    if (depth == 0) {
+                        p++;
+                        out = std::string_view(start, p - start);
+                        return true;
+                    }
+                }
+                p++;
+            }
+            return fail();
+        }
+        // Number, true, false, null
+        while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') p++;
+        if (p == start) return fail();
+        out = std::string_view(start, p - start);
+        return true;
+    }
+
+    /// Iterates over the members of an object, calling `f(key)` which must consume the value.
+    template <typename F>
+    bool object(F &&f) {
+        if (!consume('{')) return fail();
+        if (consume('}')) return true;
+        do {
+            std::string_view key;
+            if (!string(key) || !consume(':')) return fail();
+            if (!f(key)) return false;
+        } while (consume(','));
+        return consume('}') || fail();
+    }
+
+    /// Iterates over the elements of an array, calling `f()` which must consume the element.
+    template <typename F>
+    bool array(F &&f) {
+        if (!consume('[')) return fail();
+        if (consume(']')) return true;
+        do {
+            if (!f()) return false;
+        } while (consume(','));
+        return consume(']') || fail();
+    }
+
+    bool skip() {
+        std::string_view ignored;
+        return value(ignored);
+    }
+
+private:
+    const char *p;
+    const char *end;
+    bool failed = false;
+
+    bool fail() {
+        failed = true;
+        return false;
+    }
+};
+
+inline fj_slice slice(std::string_view view) {
+    return fj_slice{view.data(), view.size()};
+}
+
+inline bool parseInt(std::string_view view, int64_t &out) {
+    if (view.empty()) return false;
+    bool negative = view[0] == '-';
+    size_t i = negative ? 1 : 0;
+    if (i == view.size()) return false;
+    int64_t value = 0;
+    for (; i < view.size(); i++) {
+        char c = view[i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+inline bool quantity(Cursor &cursor, uint64_t &out) {
+    std::string_view view;
+    return cursor.value(view) && fj_parse_quantity(slice(view), &out);
+}
+
+/// Quantity that nodes may send as `null` (e.g. `baseFeePerGas` before London), read as 0.
+inline bool optionalQuantity(Cursor &cursor, uint64_t &out) {
+    std::string_view view;
+    if (!cursor.value(view)) return false;
+    if (view == "null") {
+        out = 0;
+        return true;
+    }
+    return fj_parse_quantity(slice(view), &out);
+}
+
+} // namespace
+
+extern "C" {
+
+bool fj_parse_quantity(fj_slice slice, uint64_t *out) {
+    std::string_view view(slice.ptr ? slice.ptr : "", slice.len);
+    if (view.size() >= 2 && view.front() == '"' && view.back() == '"') view = view.substr(1, view.size() - 2);
+    if (view.size() < 3 || view[0] != '0' || (view[1] != 'x' && view[1] != 'X')) return false;
+    view.remove_prefix(2);
+    if (view.size() > 16) return false;
+    uint64_t value = 0;
+    for (char c : view) {
+        uint8_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return false;
+        value = (value << 4) | digit;
+    }
+    *out = value;
+    return true;
+}
+
+bool fj_scan_message(const char *json, size_t len, fj_message *out) {
+    *out = fj_message{FJ_MESSAGE_INVALID, -1, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}};
+    Cursor cursor(json, len);
+
+    if (cursor.peek() == '[') {
+        // Batch: only the first id is needed to find the pending batch
+        bool first = true;
+        bool ok = cursor.array([&] {
+            if (!first) return cursor.skip();
+            first = false;
+            return cursor.object([&](std::string_view key) {
+                if (key == "id") {
+                    std::string_view view;
+                    return cursor.value(view) && parseInt(view, out->id);
+                }
+                return cursor.skip();
+            });
+        });
+        if (!ok) return false;
+        out->kind = FJ_MESSAGE_BATCH;
+        return true;
+    }
+
+    bool isNotification = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        std::string_view view;
+        if (key == "id") {
+            if (!cursor.value(view)) return false;
+            if (view != "null" && !parseInt(view, out->id)) return false;
+            return true;
+        }
+        if (key == "result") {
+            if (!cursor.value(view)) return false;
+            out->result = slice(view);
+            return true;
+        }
+        if (key == "error") {
+            if (!cursor.value(view)) return false;
+            out->error = slice(view);
+            return true;
+        }
+        if (key == "method") {
+            if (!cursor.value(view)) return false;
+            isNotification = view == "eth_subscription";
+            return true;
+        }
+        if (key == "params") {
+            if (cursor.peek() != '{') return cursor.skip();
+            return cursor.object([&](std::string_view key) {
+                if (key == "subscription") {
+                    if (!cursor.value(view)) return false;
+                    out->subscription = slice(view);
+                    return true;
+                }
+                if (key == "result") {
+                    if (!cursor.value(view)) return false;
+                    out->result = slice(view);
+                    return true;
+                }
+                return cursor.skip();
+            });
+        }
+        return cursor.skip();
+    });
+    if (!ok) return false;
+
+    if (isNotification && out->subscription.ptr) {
+        out->kind = FJ_MESSAGE_NOTIFICATION;
+    } else if (out->id >= 0) {
+        out->kind = FJ_MESSAGE_RESPONSE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool fj_parse_new_head(const char *json, size_t len, fj_new_head *out) {
+    *out = fj_new_head{};
+    Cursor cursor(json, len);
+    bool hasNumber = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        std::string_view view;
+        if (key == "number") return hasNumber = quantity(cursor, out->number);
+        if (key == "timestamp") return quantity(cursor, out->timestamp);
+        if (key == "gasLimit") return quantity(cursor, out->gas_limit);
+        if (key == "gasUsed") return quantity(cursor, out->gas_used);
+        if (key == "baseFeePerGas") return optionalQuantity(cursor, out->base_fee_per_gas);
+        if (key == "hash") {
+            if (!cursor.value(view)) return false;
+            out->hash = slice(view);
+            return true;
+        }
+        if (key == "parentHash") {
+            if (!cursor.value(view)) return false;
+            out->parent_hash = slice(view);
+            return true;
+        }
+        return cursor.skip();
+    });
+    return ok && hasNumber;
+}
+
+bool fj_parse_log(const char *json, size_t len, fj_log *out) {
+    *out = fj_log{};
+    Cursor cursor(json, len);
+    bool ok = cursor.object([&](std::string_view key) {
+        std::string_view view;
+        if (key == "address") {
+            if (!cursor.value(view)) return false;
+            out->address = slice(view);
+            return true;
+        }
+        if (key == "data") {
+            if (!cursor.value(view)) return false;
+            out->data = slice(view);
+            return true;
+        }
+        if (key == "topics") {
+            return cursor.array([&] {
+                if (!cursor.value(view)) return false;
+                if (out->topic_count < 4) out->topics[out->topic_count++] = slice(view);
+                return true;
+            });
+        }
+        if (key == "blockNumber") return quantity(cursor, out->block_number);
+        if (key == "logIndex") return quantity(cursor, out->log_index);
+        if (key == "transactionHash") {
+            if (!cursor.value(view)) return false;
+            out->transaction_hash = slice(view);
+            return true;
+        }
+        if (key == "removed") {
+            if (!cursor.value(view)) return false;
+            out->removed = view == "true";
+            return true;
+        }
+        return cursor.skip();
+    });
+    return ok && out->address.ptr && out->data.ptr;
+}
+
+} // extern "C"
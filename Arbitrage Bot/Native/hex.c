@@ -0,0 +1,245 @@
+//
+//  hex.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/hex.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEX_X86 1
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HEX_NEON 1
+#endif
+
+static const char hex_digits[16] = "0123456789abcdef";
+
+/// 0-15 for valid characters, 0xff otherwise
+static const uint8_t hex_value_table[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// MARK: - Scalar
+
+static void hex_encode_scalar(const uint8_t *src, size_t len, char *dst) {
+    for (size_t i = 0; i < len; i++) {
+        dst[2 * i] = hex_digits[src[i] >> 4];
+        dst[2 * i + 1] = hex_digits[src[i] & 0x0f];
+    }
+}
+
+static bool hex_decode_scalar(const char *src, size_t len, uint8_t *dst) {
+    uint8_t invalid = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t hi = hex_value_table[(uint8_t)src[2 * i]];
+        uint8_t lo = hex_value_table[(uint8_t)src[2 * i + 1]];
+        invalid |= (hi | lo) & 0xf0;
+        dst[i] = (uint8_t)((hi << 4) | (lo & 0x0f));
+    }
+    return invalid == 0;
+}
+
+// MARK: - x86
+
+#ifdef HEX_X86
+
+__attribute__((target("ssse3")))
+static void hex_encode_ssse3(const uint8_t *src, size_t len, char *dst) {
+    const __m128i lut = _mm_loadu_si128((const __m128i *)hex_digits);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    hex_encode_scalar(src + i, len - i, dst + 2 * i);
+}
+
+/// Converts 16 characters to nibbles, flagging invalid ones in `invalid`
+__attribute__((target("ssse3")))
+static inline __m128i hex_nibbles_ssse3(__m128i v, __m128i *invalid) {
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    *invalid = _mm_or_si128(*invalid, _mm_andnot_si128(_mm_or_si128(digit, alpha), _mm_set1_epi8(-1)));
+    const __m128i digitValue = _mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0')));
+    const __m128i alphaValue = _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)));
+    return _mm_or_si128(digitValue, alphaValue);
+}
+
+__attribute__((target("ssse3")))
+static bool hex_decode_ssse3(const char *src, size_t len, uint8_t *dst) {
+    // (hi, lo) nibble pairs -> hi * 16 + lo
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i invalid = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i a = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i *)(src + 2 * i)), &invalid);
+        __m128i b = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i *)(src + 2 * i + 16)), &invalid);
+        __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128((__m128i *)(dst + i), bytes);
+    }
+    if (_mm_movemask_epi8(invalid) != 0) return false;
+    return hex_decode_scalar(src + 2 * i, len - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+static void hex_encode_avx2(const uint8_t *src, size_t len, char *dst) {
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)hex_digits));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+        // Unpacking works per 128-bit lane, put the lanes back in order
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    hex_encode_ssse3(src + i, len - i, dst + 2 * i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hex_nibbles_avx2(__m256i v, __m256i *invalid) {
+    const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    *invalid = _mm256_or_si256(*invalid, _mm256_andnot_si256(_mm256_or_si256(digit, alpha), _mm256_set1_epi8(-1)));
+    const __m256i digitValue = _mm256_and_si256(digit, _mm256_sub_epi8(v, _mm256_set1_epi8('0')));
+    const __m256i alphaValue = _mm256_and_si256(alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)));
+    return _mm256_or_si256(digitValue, alphaValue);
+}
+
+__attribute__((target("avx2")))
+static bool hex_decode_avx2(const char *src, size_t len, uint8_t *dst) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i invalid = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i a = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i *)(src + 2 * i)), &invalid);
+        __m256i b = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i *)(src + 2 * i + 32)), &invalid);
+        // Packing works per 128-bit lane too: (a0, b0, a1, b1) -> (a0, a1, b0, b1)
+        __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    if (_mm256_movemask_epi8(invalid) != 0) return false;
+    return hex_decode_ssse3(src + 2 * i, len - i, dst + i);
+}
+
+#endif // HEX_X86
+
+// MARK: - NEON
+
+#ifdef HEX_NEON
+
+static void hex_encode_neon(const uint8_t *src, size_t len, char *dst) {
+    const uint8x16_t lut = vld1q_u8((const uint8_t *)hex_digits);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        uint8x16x2_t out;
+        out.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(v, 4));
+        out.val[1] = vqtbl1q_u8(lut, vandq_u8(v, mask));
+        vst2q_u8((uint8_t *)dst + 2 * i, out); // Interleaves high and low characters
+    }
+    hex_encode_scalar(src + i, len - i, dst + 2 * i);
+}
+
+static inline uint8x16_t hex_nibbles_neon(uint8x16_t v, uint8x16_t *invalid) {
+    const uint8x16_t digitValue = vsubq_u8(v, vdupq_n_u8('0'));
+    const uint8x16_t alphaValue = vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t digit = vcltq_u8(digitValue, vdupq_n_u8(10));
+    const uint8x16_t alpha = vcltq_u8(alphaValue, vdupq_n_u8(6));
+    *invalid = vorrq_u8(*invalid, vmvnq_u8(vorrq_u8(digit, alpha)));
+    return vbslq_u8(digit, digitValue, vaddq_u8(alphaValue, vdupq_n_u8(10)));
+}
+
+static bool hex_decode_neon(const char *src, size_t len, uint8_t *dst) {
+    uint8x16_t invalid = vdupq_n_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16x2_t chars = vld2q_u8((const uint8_t *)src + 2 * i); // High characters in val[0], low in val[1]
+        uint8x16_t hi = hex_nibbles_neon(chars.val[0], &invalid);
+        uint8x16_t lo = hex_nibbles_neon(chars.val[1], &invalid);
+        vst1q_u8(dst + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    if (vmaxvq_u8(invalid) != 0) return false;
+    return hex_decode_scalar(src + 2 * i, len - i, dst + i);
+}
+
+#endif // HEX_NEON
+
+// MARK: - Dispatch
+
+typedef void (*hex_encode_fn)(const uint8_t *, size_t, char *);
+typedef bool (*hex_decode_fn)(const char *, size_t, uint8_t *);
+
+static hex_encode_fn hex_encode_impl = NULL;
+static hex_decode_fn hex_decode_impl = NULL;
+
+/// Picks the implementations. Racing threads pick the same ones, so no synchronization is needed.
+static void hex_select(void) {
+    hex_encode_fn encode = hex_encode_scalar;
+    hex_decode_fn decode = hex_decode_scalar;
+#if defined(HEX_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        encode = hex_encode_avx2;
+        decode = hex_decode_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        encode = hex_encode_ssse3;
+        decode = hex_decode_ssse3;
+    }
+#elif defined(HEX_NEON)
+    encode = hex_encode_neon;
+    decode = hex_decode_neon;
+#endif
+    __atomic_store_n(&hex_decode_impl, decode, __ATOMIC_RELEASE);
+    __atomic_store_n(&hex_encode_impl, encode, __ATOMIC_RELEASE);
+}
+
+void hex_encode(const uint8_t *src, size_t len, char *dst) {
+    hex_encode_fn encode = __atomic_load_n(&hex_encode_impl, __ATOMIC_ACQUIRE);
+    if (encode == NULL) {
+        hex_select();
+        encode = hex_encode_impl;
+    }
+    encode(src, len, dst);
+}
+
+bool hex_decode(const char *src, size_t len, uint8_t *dst) {
+    hex_decode_fn decode = __atomic_load_n(&hex_decode_impl, __ATOMIC_ACQUIRE);
+    if (decode == NULL) {
+        hex_select();
+        decode = hex_decode_impl;
+    }
+    return decode(src, len, dst);
+}
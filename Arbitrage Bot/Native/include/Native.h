@@ -0,0 +1,22 @@
+//
+//  Native.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Umbrella header of the native hot path helpers, used from Swift.
+
+#ifndef NATIVE_H
+#define NATIVE_H
+
+#include "capture.h"
+#include "compression.h"
+#include "conflation.h"
+#include "fast_json.h"
+#include "hex.h"
+#include "keccak.h"
+#include "latency.h"
+#include "metrics.h"
+#include "outbox.h"
+
+#endif // NATIVE_H
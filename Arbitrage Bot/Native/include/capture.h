@@ -0,0 +1,169 @@
+//
+//  capture.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Append-only, memory-mapped capture of the reserves seen by the bot, block by block, for replay and analysis.
+//
+// A capture is made of two files: `<path>` holds the records, `<path>.idx` holds one entry per block, sorted by
+// block number. Records are 8-byte aligned, little-endian structs preceded by a `capture_record_header_t`, so a
+// reader maps the file and walks it without parsing anything.
+//
+// Blocks only contain the reserves that changed since the previous block. Keyframes contain every reserve, and are
+// preceded by the full token and exchange tables: replaying from any keyframe rebuilds the complete state.
+
+#ifndef NATIVE_CAPTURE_H
+#define NATIVE_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAPTURE_VERSION 1
+#define CAPTURE_ADDRESS_LENGTH 20
+#define CAPTURE_NAME_LENGTH 32
+
+typedef enum {
+    CAPTURE_RECORD_TOKEN = 1,
+    CAPTURE_RECORD_EXCHANGE = 2,
+    CAPTURE_RECORD_BLOCK = 3,
+} capture_record_type_t;
+
+typedef struct {
+    uint32_t type;
+    /// Size of the payload following the header, a multiple of 8
+    uint32_t size;
+} capture_record_header_t;
+
+/// Defines (or redefines) the token with id `id`. Ids are assigned by the writer and stay the same for a session.
+typedef struct {
+    uint16_t id;
+    uint8_t decimals;
+    uint8_t name_length;
+    uint8_t address[CAPTURE_ADDRESS_LENGTH];
+    char name[CAPTURE_NAME_LENGTH];
+} capture_token_t;
+
+typedef struct {
+    uint16_t id;
+    uint8_t name_length;
+    uint8_t reserved[5];
+    char name[CAPTURE_NAME_LENGTH];
+} capture_exchange_t;
+
+typedef enum {
+    /// Every reserve is included, and the tables were written right before the block
+    CAPTURE_BLOCK_KEYFRAME = 1 << 0,
+} capture_block_flags_t;
+
+/// Followed by `reserve_count` `capture_reserve_t`.
+typedef struct {
+    uint64_t block;
+    /// Unix timestamp of the block
+    uint64_t timestamp;
+    uint32_t reserve_count;
+    uint32_t flags;
+} capture_block_t;
+
+/// Reserves of a pool, `token0 < token1` by address like on chain.
+typedef struct {
+    uint16_t token0;
+    uint16_t token1;
+    uint16_t exchange;
+    /// Over 1000, like `ReserveFeeInfo.fee`
+    uint16_t fee;
+    /// 128-bit reserves, low word first (`uint112` on chain)
+    uint64_t reserve0[2];
+    uint64_t reserve1[2];
+    /// Spot prices as seen by the bot, NaN when unknown
+    double spot01;
+    double spot10;
+} capture_reserve_t;
+
+typedef struct {
+    uint64_t block;
+    /// Offset of the block record, or of the tables preceding it for keyframes
+    uint64_t offset;
+    uint32_t flags;
+    uint32_t reserved;
+} capture_index_entry_t;
+
+// MARK: - Writer
+
+typedef struct capture_writer capture_writer_t;
+
+/// Opens a capture for writing, appending to it if it already exists.
+/// @return `NULL` on failure, with `errno` set.
+capture_writer_t * _Nullable capture_writer_open(const char * _Nonnull path);
+
+/// Adds a token to the table. Outside of the first keyframe, the definition is written right away, so it must not be
+/// called between `capture_writer_begin_block` and `capture_writer_end_block`.
+bool capture_writer_add_token(capture_writer_t * _Nonnull writer, uint16_t id, const uint8_t * _Nonnull address,
+                              const char * _Nonnull name, uint8_t decimals);
+
+/// Same as `capture_writer_add_token`, for exchanges.
+bool capture_writer_add_exchange(capture_writer_t * _Nonnull writer, uint16_t id, const char * _Nonnull name);
+
+/// Starts a block. Block numbers must increase. The first block of a session is always a keyframe.
+bool capture_writer_begin_block(capture_writer_t * _Nonnull writer, uint64_t block, uint64_t timestamp, bool keyframe);
+
+bool capture_writer_add_reserve(capture_writer_t * _Nonnull writer, const capture_reserve_t * _Nonnull reserve);
+
+/// Commits the block: it becomes visible to readers and is added to the index.
+bool capture_writer_end_block(capture_writer_t * _Nonnull writer);
+
+/// Last committed block, 0 if none.
+uint64_t capture_writer_last_block(const capture_writer_t * _Nonnull writer);
+
+/// Flushes and closes the capture. A block that was not ended is discarded.
+void capture_writer_close(capture_writer_t * _Nullable writer);
+
+// MARK: - Reader
+
+typedef struct capture_reader capture_reader_t;
+
+typedef struct {
+    capture_record_type_t type;
+    union {
+        const capture_token_t * _Nullable token;
+        const capture_exchange_t * _Nullable exchange;
+        const capture_block_t * _Nullable block;
+    };
+    /// Reserves of a block record
+    const capture_reserve_t * _Nullable reserves;
+} capture_record_t;
+
+/// Maps a capture for reading. Only the blocks committed at that time are visible.
+/// @return `NULL` on failure, with `errno` set.
+capture_reader_t * _Nullable capture_reader_open(const char * _Nonnull path);
+
+/// Number of blocks in the capture.
+size_t capture_reader_block_count(const capture_reader_t * _Nonnull reader);
+
+/// Index entries, sorted by block number.
+const capture_index_entry_t * _Nullable capture_reader_index(const capture_reader_t * _Nonnull reader);
+
+/// Moves to the last keyframe at or before `block` (or the first keyframe when there is none), so that replaying up
+/// to `block` rebuilds the whole state.
+/// @return `false` if the capture has no keyframe.
+bool capture_reader_seek(capture_reader_t * _Nonnull reader, uint64_t block);
+
+/// Moves to the beginning of the capture.
+void capture_reader_rewind(capture_reader_t * _Nonnull reader);
+
+/// Reads the next record, pointing into the mapping: it stays valid until the reader is closed.
+/// @return `false` at the end of the capture, or on a malformed record.
+bool capture_reader_next(capture_reader_t * _Nonnull reader, capture_record_t * _Nonnull record);
+
+void capture_reader_close(capture_reader_t * _Nullable reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_CAPTURE_H
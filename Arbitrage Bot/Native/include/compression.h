@@ -0,0 +1,70 @@
+//
+//  compression.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Compression policy of the realtime server, and the raw deflate used to compress large binary frames once per
+// publication instead of once per socket.
+
+#ifndef NATIVE_COMPRESSION_H
+#define NATIVE_COMPRESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Messages shorter than this are sent as is: deflate saves a few dozen bytes at best, for more CPU than the send itself
+#define COMPRESSION_MIN_SIZE 1024
+/// Binary frames from this size are deflated once when published (matrix snapshots)
+#define COMPRESSION_PRECOMPRESS_SIZE (16 * 1024)
+/// Header of a `BinaryFrame`
+#define COMPRESSION_FRAME_HEADER 8
+/// Bit of the `flags` field of a `BinaryFrame` header: the payload is raw deflate, `length` is its compressed length
+#define COMPRESSION_FRAME_DEFLATED 0x01
+
+typedef enum {
+    /// Sent uncompressed
+    COMPRESSION_NONE = 0,
+    /// permessage-deflate, with the shared compressor of the route
+    COMPRESSION_SHARED = 1,
+    /// Deflated once before publishing, see `compression_precompress_frame`
+    COMPRESSION_PRECOMPRESSED = 2,
+} compression_mode_t;
+
+/// How a message should be sent.
+/// @param message Message, a `BinaryFrame` if `binary`.
+/// @param length Length of the message.
+/// @param binary Whether the message is a binary frame.
+/// @return `COMPRESSION_NONE` for small and already deflated messages, `COMPRESSION_PRECOMPRESSED` for large binary
+/// frames and `COMPRESSION_SHARED` otherwise.
+compression_mode_t compression_policy(const uint8_t * _Nonnull message, size_t length, bool binary);
+
+/// Raw deflate (no zlib header), readable with `DecompressionStream("deflate-raw")`.
+/// @param src Bytes to compress.
+/// @param len Number of bytes.
+/// @param dst Destination.
+/// @param capacity Capacity of `dst`.
+/// @return Compressed length, 0 if it doesn't fit in `capacity` or on error.
+size_t compression_deflate(const uint8_t * _Nonnull src, size_t len, uint8_t * _Nonnull dst, size_t capacity);
+
+/// Inverse of `compression_deflate`.
+/// @return Decompressed length, 0 if it doesn't fit in `capacity` or if `src` is invalid.
+size_t compression_inflate(const uint8_t * _Nonnull src, size_t len, uint8_t * _Nonnull dst, size_t capacity);
+
+/// Deflates the payload of a binary frame, keeping its header readable.
+/// @param frame Frame to compress, with an 8 bytes header.
+/// @param len Length of the frame.
+/// @param dst Destination, of at least `len` bytes.
+/// @return Length of the compressed frame, 0 if compressing doesn't make it smaller (send `frame` as is then).
+size_t compression_precompress_frame(const uint8_t * _Nonnull frame, size_t len, uint8_t * _Nonnull dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_COMPRESSION_H
@@ -0,0 +1,68 @@
+//
+//  conflation.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Latest publication of each topic of a slow realtime socket. The server decides when a socket is conflated and sends
+// the slots; nothing here depends on uWS.
+
+#ifndef NATIVE_CONFLATION_H
+#define NATIVE_CONFLATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    char *_Nonnull topic;
+    size_t topic_length;
+    char *_Nullable message; // Latest publication, NULL if none
+    size_t length;
+    /// `uws_opcode_t` of the message
+    int opcode;
+    bool resync; // A delta frame was dropped, the topic needs a snapshot
+} conflation_slot_t;
+
+/// Latest publication of each topic of a slow socket.
+///
+/// When a socket buffers too much, it is unsubscribed from its uWS topics, so that publishing never waits on it nor
+/// buffers for it. Publications to its topics only replace the slot of the topic, and once the socket drained, it
+/// receives the slots, in topic order, and is subscribed again. Memory is bounded by one message per topic, and fast
+/// sockets are untouched.
+typedef struct conflation {
+    conflation_slot_t *_Nullable slots;
+    size_t count;
+    size_t capacity;
+} conflation_t;
+
+/// @return `NULL` if out of memory.
+conflation_t *_Nullable conflation_create(void);
+
+void conflation_free(conflation_t *_Nonnull conflation);
+
+conflation_slot_t *_Nullable conflation_slot(conflation_t *_Nonnull conflation, const char *_Nonnull topic,
+                                             size_t topic_length);
+
+/// Adds an empty slot for `topic`, unless it already has one.
+/// @return `false` if the slot couldn't be allocated, in which case the conflation is unchanged.
+bool conflation_add_topic(conflation_t *_Nonnull conflation, const char *_Nonnull topic, size_t topic_length);
+
+/// Removes the slot of `topic`, and its publication. The last slot takes its place.
+/// @return `false` if the topic had no slot.
+bool conflation_remove_topic(conflation_t *_Nonnull conflation, const char *_Nonnull topic, size_t topic_length);
+
+/// Replaces the publication of `topic`, if it has a slot, counting the replaced one in `METRIC_WS_FRAMES_SKIPPED`.
+/// @param delta The message only carries changes since the previous one, so it can't replace it: the slot is emptied
+/// and flagged for `resync` instead. Also what happens when the copy can't be allocated.
+void conflation_store(conflation_t *_Nonnull conflation, const char *_Nonnull topic, size_t topic_length,
+                      const char *_Nullable message, size_t length, int opcode, bool delta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_CONFLATION_H
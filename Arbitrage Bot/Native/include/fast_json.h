@@ -0,0 +1,93 @@
+//
+//  fast_json.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// On-demand JSON scanner for the messages we receive from the node.
+// Nothing is allocated: fields are located in the input buffer and returned as slices.
+
+#ifndef FAST_JSON_H
+#define FAST_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// A view into the scanned buffer. Only valid as long as the buffer is.
+/// For JSON strings, the slice excludes the quotes (escapes are left as is).
+typedef struct {
+    const char * _Nullable ptr;
+    size_t len;
+} fj_slice;
+
+typedef enum {
+    FJ_MESSAGE_INVALID = 0,
+    /// `{"id": ..., "result" | "error": ...}`
+    FJ_MESSAGE_RESPONSE,
+    /// `[{"id": ...}, ...]`
+    FJ_MESSAGE_BATCH,
+    /// `{"method": "eth_subscription", "params": {"subscription": ..., "result": ...}}`
+    FJ_MESSAGE_NOTIFICATION,
+} fj_message_kind;
+
+/// The routing information of a message.
+/// @field id Response id, or the first id of a batch. `-1` if absent.
+/// @field subscription Subscription id of a notification.
+/// @field result Raw `result` value (of the response, or of the notification params).
+/// @field error Raw `error` value, `len` is 0 if there is none.
+typedef struct {
+    fj_message_kind kind;
+    int64_t id;
+    fj_slice subscription;
+    fj_slice result;
+    fj_slice error;
+} fj_message;
+
+/// Scans the top level of a message, without looking into the result.
+/// @return `true` if the message could be routed.
+bool fj_scan_message(const char * _Nonnull json, size_t len, fj_message * _Nonnull out);
+
+/// Fields of a `newHeads` notification we care about.
+typedef struct {
+    uint64_t number;
+    uint64_t timestamp;
+    uint64_t gas_limit;
+    uint64_t gas_used;
+    /// 0 before London, when missing or `null`
+    uint64_t base_fee_per_gas;
+    fj_slice hash;
+    fj_slice parent_hash;
+} fj_new_head;
+
+/// Parses the block header object (the `result` of a `newHeads` notification).
+bool fj_parse_new_head(const char * _Nonnull json, size_t len, fj_new_head * _Nonnull out);
+
+/// Fields of a log object (the `result` of a `logs` notification).
+typedef struct {
+    fj_slice address;
+    fj_slice data;
+    fj_slice topics[4];
+    size_t topic_count;
+    uint64_t block_number;
+    uint64_t log_index;
+    fj_slice transaction_hash;
+    bool removed;
+} fj_log;
+
+/// Parses a log object.
+bool fj_parse_log(const char * _Nonnull json, size_t len, fj_log * _Nonnull out);
+
+/// Parses a hex quantity (`"0x1b4"`, quotes optional).
+/// @return `false` on invalid digits or overflow.
+bool fj_parse_quantity(fj_slice slice, uint64_t * _Nonnull out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAST_JSON_H
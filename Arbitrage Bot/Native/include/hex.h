@@ -0,0 +1,38 @@
+//
+//  hex.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Vectorized hex codec (AVX2 / SSSE3 / NEON, with a scalar fallback).
+// The best implementation for the CPU is picked on first use.
+
+#ifndef NATIVE_HEX_H
+#define NATIVE_HEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Encodes bytes to lowercase hex.
+/// @param src Bytes to encode.
+/// @param len Number of bytes.
+/// @param dst Destination, of at least `2 * len` characters. No prefix nor terminator is written.
+void hex_encode(const uint8_t * _Nonnull src, size_t len, char * _Nonnull dst);
+
+/// Decodes hex characters (both cases are accepted) to bytes.
+/// @param src Characters to decode, without prefix.
+/// @param len Number of bytes to produce, `src` must hold `2 * len` characters.
+/// @param dst Destination, of at least `len` bytes.
+/// @return `false` if an invalid character was found, in which case `dst` holds garbage.
+bool hex_decode(const char * _Nonnull src, size_t len, uint8_t * _Nonnull dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HEX_H
@@ -0,0 +1,39 @@
+//
+//  keccak.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Keccak-256, as used by Ethereum (original padding, not the NIST SHA3-256 one).
+// Batches of same-length inputs are hashed four at a time, one input per SIMD lane.
+
+#ifndef NATIVE_KECCAK_H
+#define NATIVE_KECCAK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KECCAK256_DIGEST_LENGTH 32
+
+/// Hashes a single input.
+/// @param src Bytes to hash, can be `NULL` when `len` is 0.
+/// @param len Number of bytes.
+/// @param dst Destination of the 32-byte digest.
+void keccak256(const uint8_t * _Nullable src, size_t len, uint8_t * _Nonnull dst);
+
+/// Hashes `count` inputs of `len` bytes each, stored back to back in `src`.
+/// @param src `count * len` bytes.
+/// @param len Length of each input.
+/// @param count Number of inputs.
+/// @param dst Destination of the `count * 32` bytes of digests, in input order.
+void keccak256_batch(const uint8_t * _Nullable src, size_t len, size_t count, uint8_t * _Nonnull dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_KECCAK_H
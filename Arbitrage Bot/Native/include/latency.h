@@ -0,0 +1,74 @@
+//
+//  latency.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Block-to-decision latency tracing. Each pipeline stage marks the block it is working on, the time elapsed
+// since the previous mark of that block (and since its head arrived) goes into lock-free, log-linear histograms.
+
+#ifndef NATIVE_LATENCY_H
+#define NATIVE_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Pipeline stages, in the order they usually happen for a block.
+typedef enum {
+    /// `newHeads` notification received, starts the block
+    LATENCY_STAGE_HEAD = 0,
+    /// Reserves fetched and prices computed
+    LATENCY_STAGE_RESERVES,
+    /// Rate matrix built by `spotPicture`
+    LATENCY_STAGE_SPOT_PICTURE,
+    /// Cycle search done in the strategy, marked by `on_tick` itself
+    LATENCY_STAGE_CYCLE_SEARCH,
+    /// `on_tick` returned
+    LATENCY_STAGE_STRATEGY,
+    /// Opportunity turned into builder steps
+    LATENCY_STAGE_BUILD_STEPS,
+    /// Optimal input amount found
+    LATENCY_STAGE_OPTIMAL_PRICE,
+    /// Transaction signed, ready to be sent
+    LATENCY_STAGE_SIGNED,
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+/// Percentiles of a histogram, in nanoseconds.
+typedef struct {
+    uint64_t count;
+    /// Total of the recorded durations, exact
+    uint64_t sum;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} latency_summary_t;
+
+/// Monotonic clock, in nanoseconds.
+uint64_t latency_now(void);
+
+/// Marks the end of `stage` for `block`. Marking `LATENCY_STAGE_HEAD` starts tracking the block,
+/// marks for blocks that are not tracked anymore (or never were) are ignored.
+void latency_mark(uint64_t block, latency_stage_t stage);
+
+/// Summarizes the recorded durations of a stage.
+/// @param since_head `false` for the time spent in the stage itself (since the previous mark of the block),
+/// `true` for the time elapsed since the head of the block.
+void latency_summary(latency_stage_t stage, bool since_head, latency_summary_t * _Nonnull out);
+
+/// Display name of a stage.
+const char * _Nonnull latency_stage_name(latency_stage_t stage);
+
+/// Clears every histogram.
+void latency_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_LATENCY_H
@@ -0,0 +1,81 @@
+//
+//  metrics.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Process-wide counters and duration histograms of the hot paths, rendered in the Prometheus text format.
+// Recording is a relaxed atomic add (two for histograms), safe from any thread.
+
+#ifndef NATIVE_METRICS_H
+#define NATIVE_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    /// Blocks given to the strategy (`on_tick`)
+    METRIC_TICKS = 0,
+    /// Blocks dropped before the strategy: nothing subscribed, or no strategy attached yet
+    METRIC_TICKS_SKIPPED,
+    /// Cycles sent by the strategy with `add_opportunity_in_queue`
+    METRIC_CYCLES_FOUND,
+    /// Builder steps reviewed for an optimal input
+    METRIC_OPPORTUNITIES_PROCESSED,
+    /// Reviews skipped because the previous one was still running
+    METRIC_BUILDER_CONTENDED,
+    /// JSON-RPC calls that failed, per endpoint attempt
+    METRIC_RPC_ERRORS,
+    /// Publications fanned out to the sockets
+    METRIC_PUBLICATIONS,
+    /// Sends that uWS had to buffer
+    METRIC_WS_BACKPRESSURE,
+    /// Sends that uWS dropped (past `maxBackpressure`)
+    METRIC_WS_DROPPED,
+    /// Sockets that fell behind and got conflated
+    METRIC_WS_CONFLATED,
+    /// Publications a conflated socket never got, replaced by a newer one or dropped deltas
+    METRIC_WS_FRAMES_SKIPPED,
+    METRIC_COUNTER_COUNT
+} metric_counter_t;
+
+typedef enum {
+    /// Time spent in `on_tick`
+    METRIC_TICK_DURATION = 0,
+    /// Round trip of each JSON-RPC call, per endpoint attempt
+    METRIC_RPC_DURATION,
+    METRIC_HISTOGRAM_COUNT
+} metric_histogram_t;
+
+/// Adds `value` to a counter.
+void metrics_add(metric_counter_t counter, uint64_t value);
+
+/// Adds one to a counter.
+void metrics_increment(metric_counter_t counter);
+
+/// Records a duration.
+/// @param nanoseconds Duration, e.g. the difference of two `latency_now()`.
+void metrics_observe(metric_histogram_t histogram, uint64_t nanoseconds);
+
+/// Current value of a counter.
+uint64_t metrics_counter(metric_counter_t counter);
+
+/// Writes every metric in the Prometheus text format (version 0.0.4), including the `latency.h` stage percentiles.
+/// @param dst Destination, terminated when the text fits.
+/// @param capacity Capacity of `dst`.
+/// @return Length of the full text. It was entirely written only if it is smaller than `capacity`, as the terminator takes
+/// the last byte.
+size_t metrics_render(char * _Nonnull dst, size_t capacity);
+
+/// Clears every counter and histogram.
+void metrics_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_METRICS_H
@@ -0,0 +1,128 @@
+//
+//  outbox.h
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+// Messages and topic operations queued from any thread for the sockets of a server app, and the loop thread
+// structures that apply them: the table of open sockets, and the split of a flush by socket.
+//
+// Nothing here depends on uWS: sockets are opaque pointers, identified by ids that controllers keep instead of the
+// pointer, as they can outlive their socket.
+
+#ifndef NATIVE_OUTBOX_H
+#define NATIVE_OUTBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    OUTBOX_SEND,
+    OUTBOX_PUBLISH,
+    OUTBOX_SUBSCRIBE,
+    OUTBOX_UNSUBSCRIBE,
+} outbox_kind_t;
+
+typedef struct outbox_message {
+    struct outbox_message *_Nullable next;
+    outbox_kind_t kind;
+    /// `uws_opcode_t` of the message
+    int opcode;
+    /// 0 for publications
+    uint64_t socket_id;
+    size_t topic_length;
+    size_t length;
+    /// Topic, then message
+    char data[];
+} outbox_message_t;
+
+/// Message following the topic
+static inline const char *_Nonnull outbox_message_body(const outbox_message_t *_Nonnull message) {
+    return message->data + message->topic_length;
+}
+
+// MARK: - Queue
+
+/// Lock-free stack of messages. Producers push from any thread, the loop takes the whole stack at once.
+typedef struct {
+    outbox_message_t *_Nullable head; // Newest first
+    int scheduled;
+} outbox_t;
+
+typedef enum {
+    /// Out of memory, the message was dropped
+    OUTBOX_PUSH_FAILED,
+    OUTBOX_PUSH_QUEUED,
+    /// The outbox was idle: the caller must schedule a flush on the loop
+    OUTBOX_PUSH_SCHEDULE,
+} outbox_push_result_t;
+
+/// Copies and queues a message. Can be called from any thread.
+outbox_push_result_t outbox_push(outbox_t *_Nonnull outbox, outbox_kind_t kind, int opcode, uint64_t socket_id,
+                                 const char *_Nullable topic, size_t topic_length,
+                                 const char *_Nullable data, size_t length);
+
+/// Takes every queued message, oldest first. Messages pushed from now on schedule another flush.
+outbox_message_t *_Nullable outbox_take(outbox_t *_Nonnull outbox);
+
+/// Frees a list of messages.
+void outbox_free(outbox_message_t *_Nullable messages);
+
+// MARK: - Live sockets
+
+/// Open sockets, by id. Only touched from the loop thread.
+typedef struct {
+    uint64_t *_Nullable ids; // 0 for empty slots
+    void *_Nullable *_Nullable sockets;
+    size_t capacity; // Power of two
+    size_t count;
+} live_sockets_t;
+
+void *_Nullable live_sockets_find(const live_sockets_t *_Nonnull live, uint64_t id);
+
+/// @return `false` if the table couldn't grow, in which case it is unchanged.
+bool live_sockets_insert(live_sockets_t *_Nonnull live, uint64_t id, void *_Nonnull socket);
+
+void live_sockets_remove(live_sockets_t *_Nonnull live, uint64_t id);
+
+void live_sockets_free(live_sockets_t *_Nonnull live);
+
+// MARK: - Buckets
+
+/// Direct messages of one socket, in the order they were queued
+typedef struct {
+    uint64_t socket_id;
+    outbox_message_t *_Nullable first;
+    outbox_message_t *_Nullable *_Nonnull last;
+    size_t slot;
+} outbox_bucket_t;
+
+/// Direct messages of a flush, split by socket in a single pass so that each socket is corked once. The storage is kept
+/// from one flush to the next. Only touched from the loop thread.
+typedef struct {
+    outbox_bucket_t *_Nullable buckets; // In order of first message
+    uint32_t *_Nullable slots; // Index in `buckets` + 1, 0 for empty slots
+    size_t capacity; // Power of two, twice the room of `buckets`
+    size_t count;
+} outbox_buckets_t;
+
+/// Appends a direct message to the bucket of its socket.
+/// @return `false` if the socket had no bucket and none could be allocated. The message is left to the caller, and so
+/// should every later message of the flush, to keep each socket's order.
+bool outbox_buckets_add(outbox_buckets_t *_Nonnull buckets, outbox_message_t *_Nonnull message);
+
+/// Empties the buckets for the next flush. Their messages must have been sent or freed.
+void outbox_buckets_clear(outbox_buckets_t *_Nonnull buckets);
+
+void outbox_buckets_free(outbox_buckets_t *_Nonnull buckets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_OUTBOX_H
@@ -0,0 +1,205 @@
+//
+//  keccak.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/keccak.h"
+
+#include <string.h>
+
+#define KECCAK_RATE 136 // (1600 - 2 * 256) / 8
+#define KECCAK_ROUNDS 24
+
+static const uint64_t keccak_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+static inline uint64_t load64_le(const uint8_t *p) {
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+           (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static inline void store64_le(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+#define KECCAK_ROL(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+/// Keccak-f[1600] over any lane type supporting `^ & ~ << >>`: `uint64_t`, or a vector of them
+/// to run independent states side by side. Rotations are spelled out so they stay immediates.
+#define KECCAK_PERMUTATION(T, BROADCAST)                                                    \
+    static inline __attribute__((always_inline)) void keccak_f1600_##T(T A[25]) {          \
+        T B[25], C[5], D;                                                                  \
+        for (int round = 0; round < KECCAK_ROUNDS; round++) {                              \
+            /* theta */                                                                    \
+            for (int i = 0; i < 5; i++) {                                                  \
+                C[i] = A[i] ^ A[i + 5] ^ A[i + 10] ^ A[i + 15] ^ A[i + 20];                \
+            }                                                                              \
+            for (int i = 0; i < 5; i++) {                                                  \
+                D = C[(i + 4) % 5] ^ KECCAK_ROL(C[(i + 1) % 5], 1);                        \
+                for (int j = 0; j < 25; j += 5) {                                          \
+                    A[j + i] ^= D;                                                         \
+                }                                                                          \
+            }                                                                              \
+            /* rho and pi */                                                               \
+            B[0] = A[0];                                                                   \
+            B[1] = KECCAK_ROL(A[6], 44);                                                   \
+            B[2] = KECCAK_ROL(A[12], 43);                                                  \
+            B[3] = KECCAK_ROL(A[18], 21);                                                  \
+            B[4] = KECCAK_ROL(A[24], 14);                                                  \
+            B[5] = KECCAK_ROL(A[3], 28);                                                   \
+            B[6] = KECCAK_ROL(A[9], 20);                                                   \
+            B[7] = KECCAK_ROL(A[10], 3);                                                   \
+            B[8] = KECCAK_ROL(A[16], 45);                                                  \
+            B[9] = KECCAK_ROL(A[22], 61);                                                  \
+            B[10] = KECCAK_ROL(A[1], 1);                                                   \
+            B[11] = KECCAK_ROL(A[7], 6);                                                   \
+            B[12] = KECCAK_ROL(A[13], 25);                                                 \
+            B[13] = KECCAK_ROL(A[19], 8);                                                  \
+            B[14] = KECCAK_ROL(A[20], 18);                                                 \
+            B[15] = KECCAK_ROL(A[4], 27);                                                  \
+            B[16] = KECCAK_ROL(A[5], 36);                                                  \
+            B[17] = KECCAK_ROL(A[11], 10);                                                 \
+            B[18] = KECCAK_ROL(A[17], 15);                                                 \
+            B[19] = KECCAK_ROL(A[23], 56);                                                 \
+            B[20] = KECCAK_ROL(A[2], 62);                                                  \
+            B[21] = KECCAK_ROL(A[8], 55);                                                  \
+            B[22] = KECCAK_ROL(A[14], 39);                                                 \
+            B[23] = KECCAK_ROL(A[15], 41);                                                 \
+            B[24] = KECCAK_ROL(A[21], 2);                                                  \
+            /* chi */                                                                      \
+            for (int j = 0; j < 25; j += 5) {                                              \
+                for (int i = 0; i < 5; i++) {                                              \
+                    A[j + i] = B[j + i] ^ (~B[j + (i + 1) % 5] & B[j + (i + 2) % 5]);      \
+                }                                                                          \
+            }                                                                              \
+            /* iota */                                                                     \
+            A[0] ^= BROADCAST(keccak_round_constants[round]);                              \
+        }                                                                                  \
+    }
+
+#define KECCAK_SCALAR(x) (x)
+KECCAK_PERMUTATION(uint64_t, KECCAK_SCALAR)
+
+typedef uint64_t keccak_x4 __attribute__((vector_size(32)));
+#define KECCAK_BROADCAST_X4(x) ((keccak_x4){ (x), (x), (x), (x) })
+KECCAK_PERMUTATION(keccak_x4, KECCAK_BROADCAST_X4)
+
+// MARK: - Single input
+
+void keccak256(const uint8_t *src, size_t len, uint8_t *dst) {
+    uint64_t A[25] = { 0 };
+
+    while (len >= KECCAK_RATE) {
+        for (int i = 0; i < KECCAK_RATE / 8; i++) {
+            A[i] ^= load64_le(src + 8 * i);
+        }
+        keccak_f1600_uint64_t(A);
+        src += KECCAK_RATE;
+        len -= KECCAK_RATE;
+    }
+
+    uint8_t block[KECCAK_RATE] = { 0 };
+    if (len > 0) {
+        memcpy(block, src, len);
+    }
+    block[len] ^= 0x01;
+    block[KECCAK_RATE - 1] ^= 0x80;
+    for (int i = 0; i < KECCAK_RATE / 8; i++) {
+        A[i] ^= load64_le(block + 8 * i);
+    }
+    keccak_f1600_uint64_t(A);
+
+    for (int i = 0; i < 4; i++) {
+        store64_le(dst + 8 * i, A[i]);
+    }
+}
+
+// MARK: - Batch
+
+/// Absorbs 4 inputs of the same length in parallel, one per lane.
+#define KECCAK256_X4(NAME, ...)                                                            \
+    __VA_ARGS__ static void NAME(const uint8_t *src, size_t len, uint8_t *dst) {           \
+        keccak_x4 A[25];                                                                   \
+        memset(A, 0, sizeof(A));                                                           \
+        const uint8_t *in[4] = { src, src + len, src + 2 * len, src + 3 * len };           \
+        size_t remaining = len;                                                            \
+        while (remaining >= KECCAK_RATE) {                                                 \
+            for (int i = 0; i < KECCAK_RATE / 8; i++) {                                    \
+                A[i] ^= (keccak_x4){ load64_le(in[0] + 8 * i), load64_le(in[1] + 8 * i),   \
+                                     load64_le(in[2] + 8 * i), load64_le(in[3] + 8 * i) }; \
+            }                                                                              \
+            keccak_f1600_keccak_x4(A);                                                     \
+            for (int k = 0; k < 4; k++) {                                                  \
+                in[k] += KECCAK_RATE;                                                      \
+            }                                                                              \
+            remaining -= KECCAK_RATE;                                                      \
+        }                                                                                  \
+        uint8_t block[4][KECCAK_RATE];                                                     \
+        memset(block, 0, sizeof(block));                                                   \
+        for (int k = 0; k < 4; k++) {                                                      \
+            if (remaining > 0) {                                                           \
+                memcpy(block[k], in[k], remaining);                                        \
+            }                                                                              \
+            block[k][remaining] ^= 0x01;                                                   \
+            block[k][KECCAK_RATE - 1] ^= 0x80;                                             \
+        }                                                                                  \
+        for (int i = 0; i < KECCAK_RATE / 8; i++) {                                        \
+            A[i] ^= (keccak_x4){ load64_le(block[0] + 8 * i), load64_le(block[1] + 8 * i), \
+                                 load64_le(block[2] + 8 * i), load64_le(block[3] + 8 * i) }; \
+        }                                                                                  \
+        keccak_f1600_keccak_x4(A);                                                         \
+        for (int k = 0; k < 4; k++) {                                                      \
+            for (int i = 0; i < 4; i++) {                                                  \
+                store64_le(dst + 32 * k + 8 * i, A[i][k]);                                 \
+            }                                                                              \
+        }                                                                                  \
+    }
+
+KECCAK256_X4(keccak256_x4_generic)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KECCAK_X86 1
+KECCAK256_X4(keccak256_x4_avx2, __attribute__((target("avx2"))))
+#endif
+
+typedef void (*keccak256_x4_fn)(const uint8_t *, size_t, uint8_t *);
+
+static keccak256_x4_fn keccak256_x4_impl = NULL;
+
+/// Picks the 4-way implementation. Racing threads pick the same one, so no synchronization is needed.
+static keccak256_x4_fn keccak_select(void) {
+    keccak256_x4_fn impl = keccak256_x4_generic;
+#if defined(KECCAK_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        impl = keccak256_x4_avx2;
+    }
+#endif
+    __atomic_store_n(&keccak256_x4_impl, impl, __ATOMIC_RELEASE);
+    return impl;
+}
+
+void keccak256_batch(const uint8_t *src, size_t len, size_t count, uint8_t *dst) {
+    keccak256_x4_fn x4 = __atomic_load_n(&keccak256_x4_impl, __ATOMIC_ACQUIRE);
+    if (x4 == NULL) {
+        x4 = keccak_select();
+    }
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        x4(src + i * len, len, dst + i * KECCAK256_DIGEST_LENGTH);
+    }
+    for (; i < count; i++) {
+        keccak256(src + i * len, len, dst + i * KECCAK256_DIGEST_LENGTH);
+    }
+}
@@ -0,0 +1,160 @@
+//
+//  latency.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/latency.h"
+
+#include <string.h>
+#include <time.h>
+
+// MARK: - Histogram
+
+// Log-linear buckets, like HdrHistogram: values below 2^SUB_BITS are exact, above that every power of two is
+// split in 2^SUB_BITS buckets, so the relative error stays under 1 / 2^SUB_BITS (~3%).
+#define SUB_BITS 5
+#define SUB_COUNT (1 << SUB_BITS)
+#define MAX_EXPONENT 42 // ~73 minutes in nanoseconds, larger values are clamped
+#define BUCKET_COUNT ((MAX_EXPONENT - SUB_BITS + 2) * SUB_COUNT)
+
+typedef struct {
+    uint64_t buckets[BUCKET_COUNT];
+    uint64_t sum;
+    uint64_t max;
+} histogram_t;
+
+static inline unsigned bucket_index(uint64_t value) {
+    if (value < SUB_COUNT) {
+        return (unsigned)value;
+    }
+    unsigned exponent = 63 - (unsigned)__builtin_clzll(value);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    unsigned sub = (unsigned)(value >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+    return (exponent - SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+/// Middle of the bucket's range
+static inline uint64_t bucket_value(unsigned index) {
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    unsigned exponent = index / SUB_COUNT + SUB_BITS - 1;
+    uint64_t lower = (uint64_t)(SUB_COUNT + index % SUB_COUNT) << (exponent - SUB_BITS);
+    return lower + ((1ULL << (exponent - SUB_BITS)) >> 1);
+}
+
+static void histogram_record(histogram_t *histogram, uint64_t value) {
+    __atomic_fetch_add(&histogram->buckets[bucket_index(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (value > max && !__atomic_compare_exchange_n(&histogram->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void histogram_summary(histogram_t *histogram, latency_summary_t *out) {
+    // Buckets are read one by one while being written, so the snapshot is only approximately consistent.
+    uint64_t buckets[BUCKET_COUNT];
+    uint64_t count = 0;
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        count += buckets[i];
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->count = count;
+    out->sum = __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED);
+    out->max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    if (count == 0) {
+        return;
+    }
+
+    const double quantiles[3] = { 0.5, 0.99, 0.999 };
+    uint64_t *targets[3] = { &out->p50, &out->p99, &out->p999 };
+    uint64_t seen = 0;
+    unsigned q = 0;
+    for (unsigned i = 0; i < BUCKET_COUNT && q < 3; i++) {
+        seen += buckets[i];
+        while (q < 3 && seen >= (uint64_t)(quantiles[q] * (double)count + 0.5)) {
+            uint64_t value = bucket_value(i);
+            *targets[q++] = value < out->max ? value : out->max;
+        }
+    }
+}
+
+// MARK: - Blocks in flight
+
+// Blocks are tracked in a small ring indexed by block number, older blocks are overwritten.
+#define BLOCK_SLOTS 64
+
+typedef struct {
+    uint64_t block;
+    uint64_t head;
+    uint64_t last;
+} block_slot_t;
+
+static block_slot_t slots[BLOCK_SLOTS];
+static histogram_t stage_histograms[LATENCY_STAGE_COUNT];
+static histogram_t head_histograms[LATENCY_STAGE_COUNT];
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+    "head", "reserves", "spotPicture", "cycleSearch", "strategy", "buildSteps", "optimalPrice", "signed",
+};
+
+uint64_t latency_now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+}
+
+void latency_mark(uint64_t block, latency_stage_t stage) {
+    if (stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+    uint64_t now = latency_now();
+    block_slot_t *slot = &slots[block % BLOCK_SLOTS];
+
+    if (stage == LATENCY_STAGE_HEAD) {
+        __atomic_store_n(&slot->head, now, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->last, now, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->block, block + 1, __ATOMIC_RELEASE); // 0 means empty
+        return;
+    }
+
+    if (__atomic_load_n(&slot->block, __ATOMIC_ACQUIRE) != block + 1) {
+        return;
+    }
+    uint64_t head = __atomic_load_n(&slot->head, __ATOMIC_RELAXED);
+    uint64_t last = __atomic_exchange_n(&slot->last, now, __ATOMIC_RELAXED);
+
+    histogram_record(&stage_histograms[stage], now > last ? now - last : 0);
+    histogram_record(&head_histograms[stage], now > head ? now - head : 0);
+}
+
+void latency_summary(latency_stage_t stage, bool since_head, latency_summary_t *out) {
+    if (stage >= LATENCY_STAGE_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    histogram_summary(since_head ? &head_histograms[stage] : &stage_histograms[stage], out);
+}
+
+const char *latency_stage_name(latency_stage_t stage) {
+    return stage < LATENCY_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void latency_reset(void) {
+    for (unsigned stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        histogram_t *histograms[2] = { &stage_histograms[stage], &head_histograms[stage] };
+        for (unsigned h = 0; h < 2; h++) {
+            for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+                __atomic_store_n(&histograms[h]->buckets[i], 0, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&histograms[h]->sum, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&histograms[h]->max, 0, __ATOMIC_RELAXED);
+        }
+    }
+}
@@ -0,0 +1,176 @@
+//
+//  metrics.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/metrics.h"
+#include "include/latency.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+// Each metric has its own cache line, so that threads recording different metrics don't contend.
+typedef struct {
+    _Alignas(64) uint64_t value;
+} counter_t;
+
+// Power of two buckets: bucket `i` counts the durations in (2^(i-1), 2^i] nanoseconds, bounds included like the
+// Prometheus `le`. Coarser than the `latency.c` histograms, but cheap enough to render every bucket.
+#define HISTOGRAM_BUCKETS 65
+// Rendered bounds, from 2^10 ns (~1 µs) to 2^35 ns (~34 s). Longer durations only count in `+Inf`.
+#define RENDER_FIRST_BUCKET 10
+#define RENDER_LAST_BUCKET 35
+
+typedef struct {
+    _Alignas(64) uint64_t buckets[HISTOGRAM_BUCKETS];
+    uint64_t sum;
+} histogram_t;
+
+static counter_t counters[METRIC_COUNTER_COUNT];
+static histogram_t histograms[METRIC_HISTOGRAM_COUNT];
+
+static const char *const counter_names[METRIC_COUNTER_COUNT] = {
+    "ticks", "ticks_skipped", "cycles_found", "opportunities_processed", "builder_contended", "rpc_errors",
+    "publications", "ws_backpressure", "ws_dropped", "ws_conflated", "ws_frames_skipped",
+};
+
+static const char *const counter_help[METRIC_COUNTER_COUNT] = {
+    "Blocks given to the strategy",
+    "Blocks dropped before the strategy",
+    "Cycles found by the strategy",
+    "Builder steps reviewed for an optimal input",
+    "Reviews skipped because the previous one was still running",
+    "Failed JSON-RPC calls",
+    "Publications fanned out to the sockets",
+    "Sends buffered by uWS",
+    "Sends dropped by uWS",
+    "Sockets conflated for falling behind",
+    "Publications skipped by conflated sockets",
+};
+
+static const char *const histogram_names[METRIC_HISTOGRAM_COUNT] = {
+    "tick_duration", "rpc_duration",
+};
+
+static const char *const histogram_help[METRIC_HISTOGRAM_COUNT] = {
+    "Time spent in on_tick",
+    "Round trip of JSON-RPC calls",
+};
+
+void metrics_add(metric_counter_t counter, uint64_t value) {
+    if (counter < METRIC_COUNTER_COUNT) {
+        __atomic_fetch_add(&counters[counter].value, value, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_increment(metric_counter_t counter) {
+    metrics_add(counter, 1);
+}
+
+void metrics_observe(metric_histogram_t histogram, uint64_t nanoseconds) {
+    if (histogram >= METRIC_HISTOGRAM_COUNT) {
+        return;
+    }
+    unsigned bucket = nanoseconds > 1 ? 64 - (unsigned)__builtin_clzll(nanoseconds - 1) : 0;
+    __atomic_fetch_add(&histograms[histogram].buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histograms[histogram].sum, nanoseconds, __ATOMIC_RELAXED);
+}
+
+uint64_t metrics_counter(metric_counter_t counter) {
+    return counter < METRIC_COUNTER_COUNT ? __atomic_load_n(&counters[counter].value, __ATOMIC_RELAXED) : 0;
+}
+
+// MARK: - Rendering
+
+typedef struct {
+    char *dst;
+    size_t capacity;
+    size_t length;
+} writer_t;
+
+__attribute__((format(printf, 2, 3)))
+static void writer_print(writer_t *writer, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    char empty[1];
+    // Past the capacity, only the length is counted
+    int written = writer->length < writer->capacity
+        ? vsnprintf(writer->dst + writer->length, writer->capacity - writer->length, format, arguments)
+        : vsnprintf(empty, sizeof(empty), format, arguments);
+    va_end(arguments);
+    if (written > 0) {
+        writer->length += (size_t)written;
+    }
+}
+
+static void render_histogram(writer_t *writer, metric_histogram_t index) {
+    const char *name = histogram_names[index];
+    histogram_t *histogram = &histograms[index];
+    writer_print(writer, "# HELP arbitrage_%s_seconds %s.\n# TYPE arbitrage_%s_seconds histogram\n",
+                 name, histogram_help[index], name);
+    // Buckets are read one by one while being written, so the snapshot is only approximately consistent.
+    uint64_t cumulative = 0;
+    for (unsigned bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        cumulative += __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED);
+        if (bucket >= RENDER_FIRST_BUCKET && bucket <= RENDER_LAST_BUCKET) {
+            writer_print(writer, "arbitrage_%s_seconds_bucket{le=\"%.9g\"} %llu\n",
+                         name, (double)(1ULL << bucket) / 1e9, (unsigned long long)cumulative);
+        }
+    }
+    writer_print(writer, "arbitrage_%s_seconds_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)cumulative);
+    writer_print(writer, "arbitrage_%s_seconds_sum %.9f\n", name,
+                 (double)__atomic_load_n(&histogram->sum, __ATOMIC_RELAXED) / 1e9);
+    writer_print(writer, "arbitrage_%s_seconds_count %llu\n", name, (unsigned long long)cumulative);
+}
+
+static void render_stages(writer_t *writer, bool since_head) {
+    const char *name = since_head ? "stage_since_head_seconds" : "stage_duration_seconds";
+    writer_print(writer, "# HELP arbitrage_%s %s.\n# TYPE arbitrage_%s summary\n", name,
+                 since_head ? "Time from the head of the block to the end of each pipeline stage"
+                            : "Time spent in each pipeline stage", name);
+    for (unsigned stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        latency_summary_t summary;
+        latency_summary((latency_stage_t)stage, since_head, &summary);
+        const char *stage_name = latency_stage_name((latency_stage_t)stage);
+        const double quantiles[3] = { 0.5, 0.99, 0.999 };
+        const uint64_t values[3] = { summary.p50, summary.p99, summary.p999 };
+        for (unsigned q = 0; q < 3; q++) {
+            writer_print(writer, "arbitrage_%s{stage=\"%s\",quantile=\"%g\"} %.9f\n",
+                         name, stage_name, quantiles[q], (double)values[q] / 1e9);
+        }
+        writer_print(writer, "arbitrage_%s_sum{stage=\"%s\"} %.9f\n",
+                     name, stage_name, (double)summary.sum / 1e9);
+        writer_print(writer, "arbitrage_%s_count{stage=\"%s\"} %llu\n",
+                     name, stage_name, (unsigned long long)summary.count);
+    }
+}
+
+size_t metrics_render(char *dst, size_t capacity) {
+    writer_t writer = { .dst = dst, .capacity = capacity };
+    for (unsigned counter = 0; counter < METRIC_COUNTER_COUNT; counter++) {
+        const char *name = counter_names[counter];
+        writer_print(&writer, "# HELP arbitrage_%s_total %s.\n# TYPE arbitrage_%s_total counter\narbitrage_%s_total %llu\n",
+                     name, counter_help[counter], name, name,
+                     (unsigned long long)metrics_counter((metric_counter_t)counter));
+    }
+    for (unsigned histogram = 0; histogram < METRIC_HISTOGRAM_COUNT; histogram++) {
+        render_histogram(&writer, (metric_histogram_t)histogram);
+    }
+    render_stages(&writer, false);
+    render_stages(&writer, true);
+    return writer.length;
+}
+
+void metrics_reset(void) {
+    for (unsigned counter = 0; counter < METRIC_COUNTER_COUNT; counter++) {
+        __atomic_store_n(&counters[counter].value, 0, __ATOMIC_RELAXED);
+    }
+    for (unsigned histogram = 0; histogram < METRIC_HISTOGRAM_COUNT; histogram++) {
+        for (unsigned bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+            __atomic_store_n(&histograms[histogram].buckets[bucket], 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&histograms[histogram].sum, 0, __ATOMIC_RELAXED);
+    }
+}
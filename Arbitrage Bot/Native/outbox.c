@@ -0,0 +1,219 @@
+//
+//  outbox.c
+//  Arbitrage Bot
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+#include "include/outbox.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline size_t slot_for(uint64_t id, size_t capacity) {
+    return (size_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+}
+
+// MARK: - Queue
+
+outbox_push_result_t outbox_push(outbox_t *outbox, outbox_kind_t kind, int opcode, uint64_t socket_id,
+                                 const char *topic, size_t topic_length, const char *data, size_t length) {
+    outbox_message_t *message = malloc(sizeof(outbox_message_t) + topic_length + length);
+    if (!message) {
+        return OUTBOX_PUSH_FAILED;
+    }
+    message->kind = kind;
+    message->opcode = opcode;
+    message->socket_id = socket_id;
+    message->topic_length = topic_length;
+    message->length = length;
+    if (topic_length > 0) {
+        memcpy(message->data, topic, topic_length);
+    }
+    if (length > 0) {
+        memcpy(message->data + topic_length, data, length);
+    }
+
+    message->next = __atomic_load_n(&outbox->head, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&outbox->head, &message->next, message, true,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {}
+
+    return __atomic_exchange_n(&outbox->scheduled, 1, __ATOMIC_SEQ_CST) == 0 ? OUTBOX_PUSH_SCHEDULE : OUTBOX_PUSH_QUEUED;
+}
+
+outbox_message_t *outbox_take(outbox_t *outbox) {
+    // Cleared first: a message pushed from now on schedules another flush
+    __atomic_store_n(&outbox->scheduled, 0, __ATOMIC_SEQ_CST);
+    outbox_message_t *stack = __atomic_exchange_n(&outbox->head, NULL, __ATOMIC_SEQ_CST);
+
+    outbox_message_t *queue = NULL;
+    while (stack) {
+        outbox_message_t *next = stack->next;
+        stack->next = queue;
+        queue = stack;
+        stack = next;
+    }
+    return queue;
+}
+
+void outbox_free(outbox_message_t *messages) {
+    while (messages) {
+        outbox_message_t *next = messages->next;
+        free(messages);
+        messages = next;
+    }
+}
+
+// MARK: - Live sockets
+
+void *live_sockets_find(const live_sockets_t *live, uint64_t id) {
+    if (live->capacity == 0) return NULL;
+    for (size_t i = slot_for(id, live->capacity);; i = (i + 1) & (live->capacity - 1)) {
+        if (live->ids[i] == id) return live->sockets[i];
+        if (live->ids[i] == 0) return NULL;
+    }
+}
+
+static void live_sockets_place(live_sockets_t *live, uint64_t id, void *socket) {
+    size_t i = slot_for(id, live->capacity);
+    while (live->ids[i] != 0) {
+        i = (i + 1) & (live->capacity - 1);
+    }
+    live->ids[i] = id;
+    live->sockets[i] = socket;
+    live->count++;
+}
+
+static bool live_sockets_grow(live_sockets_t *live) {
+    live_sockets_t grown = {
+        .capacity = live->capacity ? live->capacity * 2 : 64,
+    };
+    grown.ids = calloc(grown.capacity, sizeof(uint64_t));
+    grown.sockets = calloc(grown.capacity, sizeof(void *));
+    if (!grown.ids || !grown.sockets) {
+        free(grown.ids);
+        free(grown.sockets);
+        return false;
+    }
+    for (size_t i = 0; i < live->capacity; i++) {
+        if (live->ids[i] != 0) {
+            live_sockets_place(&grown, live->ids[i], live->sockets[i]);
+        }
+    }
+    free(live->ids);
+    free(live->sockets);
+    *live = grown;
+    return true;
+}
+
+bool live_sockets_insert(live_sockets_t *live, uint64_t id, void *socket) {
+    if ((live->count + 1) * 2 > live->capacity && !live_sockets_grow(live)) {
+        return false;
+    }
+    live_sockets_place(live, id, socket);
+    return true;
+}
+
+void live_sockets_remove(live_sockets_t *live, uint64_t id) {
+    if (live->capacity == 0) return;
+    size_t mask = live->capacity - 1;
+    size_t i = slot_for(id, live->capacity);
+    while (live->ids[i] != id) {
+        if (live->ids[i] == 0) return;
+        i = (i + 1) & mask;
+    }
+    // Backward shift, so that lookups never need tombstones
+    for (size_t j = (i + 1) & mask; live->ids[j] != 0; j = (j + 1) & mask) {
+        size_t home = slot_for(live->ids[j], live->capacity);
+        // Move `j` to the hole if its home slot isn't in (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            live->ids[i] = live->ids[j];
+            live->sockets[i] = live->sockets[j];
+            i = j;
+        }
+    }
+    live->ids[i] = 0;
+    live->sockets[i] = NULL;
+    live->count--;
+}
+
+void live_sockets_free(live_sockets_t *live) {
+    free(live->ids);
+    free(live->sockets);
+    *live = (live_sockets_t){0};
+}
+
+// MARK: - Buckets
+
+static bool outbox_buckets_grow(outbox_buckets_t *buckets) {
+    size_t capacity = buckets->capacity ? buckets->capacity * 2 : 64;
+    uint32_t *slots = calloc(capacity, sizeof(uint32_t));
+    outbox_bucket_t *grown = realloc(buckets->buckets, capacity / 2 * sizeof(outbox_bucket_t));
+    if (grown) {
+        // Buckets always hold a message, so `last` never points into them
+        buckets->buckets = grown;
+    }
+    if (!slots || !grown) {
+        free(slots);
+        return false;
+    }
+    for (size_t index = 0; index < buckets->count; index++) {
+        outbox_bucket_t *bucket = &grown[index];
+        size_t i = slot_for(bucket->socket_id, capacity);
+        while (slots[i] != 0) {
+            i = (i + 1) & (capacity - 1);
+        }
+        slots[i] = (uint32_t)index + 1;
+        bucket->slot = i;
+    }
+    free(buckets->slots);
+    buckets->slots = slots;
+    buckets->buckets = grown;
+    buckets->capacity = capacity;
+    return true;
+}
+
+bool outbox_buckets_add(outbox_buckets_t *buckets, outbox_message_t *message) {
+    message->next = NULL;
+    if (buckets->capacity > 0) {
+        for (size_t i = slot_for(message->socket_id, buckets->capacity);; i = (i + 1) & (buckets->capacity - 1)) {
+            uint32_t index = buckets->slots[i];
+            if (index == 0) break;
+            outbox_bucket_t *bucket = &buckets->buckets[index - 1];
+            if (bucket->socket_id == message->socket_id) {
+                *bucket->last = message;
+                bucket->last = &message->next;
+                return true;
+            }
+        }
+    }
+
+    if ((buckets->count + 1) * 2 > buckets->capacity && !outbox_buckets_grow(buckets)) {
+        return false;
+    }
+    size_t i = slot_for(message->socket_id, buckets->capacity);
+    while (buckets->slots[i] != 0) {
+        i = (i + 1) & (buckets->capacity - 1);
+    }
+    outbox_bucket_t *bucket = &buckets->buckets[buckets->count];
+    buckets->slots[i] = (uint32_t)++buckets->count;
+    bucket->socket_id = message->socket_id;
+    bucket->first = message;
+    bucket->last = &message->next;
+    bucket->slot = i;
+    return true;
+}
+
+void outbox_buckets_clear(outbox_buckets_t *buckets) {
+    // Only the slots in use, the table stays as large as the busiest flush
+    for (size_t index = 0; index < buckets->count; index++) {
+        buckets->slots[buckets->buckets[index].slot] = 0;
+    }
+    buckets->count = 0;
+}
+
+void outbox_buckets_free(outbox_buckets_t *buckets) {
+    free(buckets->buckets);
+    free(buckets->slots);
+    *buckets = (outbox_buckets_t){0};
+}
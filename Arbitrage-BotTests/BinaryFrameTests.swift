@@ -0,0 +1,86 @@
+//
+//  BinaryFrameTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Euler
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class BinaryFrameTests: XCTestCase {
+    let tokenA = Token(name: "WBNB", address: try! EthereumAddress(hex: "0xbb4CdB9CBd36B01bD1cBaEBF2De08d9173bc095c", eip55: false))
+    let tokenB = Token(name: "BUSD", address: try! EthereumAddress(hex: "0xe9e7CEA3DedcA5984780Bafc599bD69ADd087D56", eip55: false))
+
+    func u32(_ frame: Bytes, _ offset: Int) -> UInt32 {
+        frame[offset..<offset + 4].reversed().reduce(0) { $0 << 8 | UInt32($1) }
+    }
+
+    func f64(_ frame: Bytes, _ offset: Int) -> Double {
+        Double(bitPattern: frame[offset..<offset + 8].reversed().reduce(0) { $0 << 8 | UInt64($1) })
+    }
+
+    func testQuoteLayout() {
+        let quote = Quote(exchangeName: "uniswap", amount: Euler.BigInt(1_000_000_000_000_000_000), amountOut: Euler.BigInt(300), price: BigDouble(300.5),
+                          transactionPrice: BigDouble(301), tokenA: tokenA, tokenB: tokenB, ask: 302)
+        let frame = BinaryFrame.quote(quote)
+
+        XCTAssertEqual(frame[0], BinaryFrame.Kind.quote.rawValue)
+        XCTAssertEqual(frame[1], BinaryFrame.version)
+        XCTAssertEqual(Int(u32(frame, 4)), frame.count - 8)
+        XCTAssertEqual(f64(frame, 8), 300.5)
+        XCTAssertEqual(f64(frame, 16), 301)
+        XCTAssertEqual(f64(frame, 24), 302)
+        XCTAssertTrue(f64(frame, 32).isNaN) // No bid
+        XCTAssertEqual(f64(frame, 48), 1e18)
+        XCTAssertEqual(frame[64], 18)
+        XCTAssertEqual(Array(frame[65..<85]), tokenA.address.rawAddress)
+        XCTAssertEqual(Array(frame[85..<105]), tokenB.address.rawAddress)
+        XCTAssertEqual(frame[105], 7)
+        XCTAssertEqual(String(decoding: frame[106..<113], as: UTF8.self), "uniswap")
+    }
+
+    func testMatrixDelta() throws {
+        let previous: [Double] = [1, 2, 3, 4]
+        let frame = try XCTUnwrap(BinaryFrame.matrixDelta([1, 2.5, 3, .infinity], previous: previous, size: 2))
+
+        XCTAssertEqual(frame[0], BinaryFrame.Kind.matrixDelta.rawValue)
+        XCTAssertEqual(u32(frame, 8), 2)
+        XCTAssertEqual(u32(frame, 12), 2)
+        XCTAssertEqual(u32(frame, 16), 1)
+        XCTAssertEqual(f64(frame, 20), 2.5)
+        XCTAssertEqual(u32(frame, 28), 3)
+        XCTAssertEqual(f64(frame, 32), .infinity)
+        XCTAssertEqual(frame.count, 8 + 8 + 2 * 12)
+
+        // A resized matrix needs a snapshot
+        XCTAssertNil(BinaryFrame.matrixDelta(Array(repeating: 1, count: 9), previous: previous, size: 3))
+    }
+
+    func testMatrixSnapshot() {
+        let frame = BinaryFrame.matrixSnapshot([1, 2, 3, 4], tokens: [tokenA, tokenB])
+
+        XCTAssertEqual(frame[0], BinaryFrame.Kind.matrixSnapshot.rawValue)
+        XCTAssertEqual(u32(frame, 8), 2)
+        XCTAssertEqual(Array(frame[12..<32]), tokenA.address.rawAddress)
+        XCTAssertEqual(f64(frame, 52 + 3 * 8), 4)
+        XCTAssertEqual(frame.count, 8 + 4 + 40 + 32)
+    }
+
+    func testDecisionSkipsResponsesWithoutTrade() {
+        XCTAssertNil(BinaryFrame.encode(BotResponse(status: .success, topic: .decision)))
+
+        var response = BotResponse(status: .success, topic: .decision)
+        response.executedTrade = Trade(timestamp: Date(timeIntervalSince1970: 1), token: "WBNB", startAmount: 1,
+                                       route: [.init(exchange: "uniswap", token: "BUSD")], profit: 0.1)
+        let frame = BinaryFrame.encode(response)
+        XCTAssertEqual(frame?[0], BinaryFrame.Kind.decision.rawValue)
+        XCTAssertEqual(frame.map { f64($0, 8) }, 1000)
+        XCTAssertTrue(frame.map { f64($0, 32).isNaN } ?? false) // No fees yet
+    }
+}
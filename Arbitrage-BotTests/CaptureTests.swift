@@ -0,0 +1,159 @@
+//
+//  CaptureTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Native
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class CaptureTests: XCTestCase {
+    var path: String!
+
+    override func setUp() {
+        path = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).capture").path
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(atPath: path)
+        try? FileManager.default.removeItem(atPath: path + ".idx")
+    }
+
+    /// Writes `count` blocks of `reservesPerBlock` reserves, with a keyframe every 100 blocks
+    func write(blocks count: UInt64, reservesPerBlock: Int = 3) {
+        let writer = capture_writer_open(path)!
+        defer { capture_writer_close(writer) }
+        for id in 0..<10 {
+            let address = Bytes(repeating: UInt8(id), count: 20)
+            XCTAssertTrue(capture_writer_add_token(writer, UInt16(id), address, "TK\(id)", 18))
+        }
+        XCTAssertTrue(capture_writer_add_exchange(writer, 0, "uniswap"))
+
+        for block in 1...count {
+            XCTAssertTrue(capture_writer_begin_block(writer, block, 1_700_000_000 + block, block % 100 == 0))
+            for i in 0..<reservesPerBlock {
+                var reserve = capture_reserve_t(token0: UInt16(i % 10), token1: UInt16((i + 1) % 10), exchange: 0, fee: 3,
+                                                reserve0: (block, 0), reserve1: (UInt64(i), 1),
+                                                spot01: 1.5, spot10: .nan)
+                XCTAssertTrue(capture_writer_add_reserve(writer, &reserve))
+            }
+            XCTAssertTrue(capture_writer_end_block(writer))
+        }
+    }
+
+    func testRoundTrip() throws {
+        write(blocks: 1_000)
+
+        let reader = try XCTUnwrap(capture_reader_open(path))
+        defer { capture_reader_close(reader) }
+        XCTAssertEqual(capture_reader_block_count(reader), 1_000)
+
+        var record = capture_record_t()
+        var tokens = [UInt16: String]()
+        var blocks = [UInt64]()
+        while capture_reader_next(reader, &record) {
+            switch record.type {
+            case CAPTURE_RECORD_TOKEN:
+                var token = record.token!.pointee
+                tokens[token.id] = withUnsafeBytes(of: &token.name) { String(decoding: $0.prefix(Int(token.name_length)), as: UTF8.self) }
+            case CAPTURE_RECORD_BLOCK:
+                let block = record.block!.pointee
+                blocks.append(block.block)
+                XCTAssertEqual(block.timestamp, 1_700_000_000 + block.block)
+                XCTAssertEqual(block.reserve_count, 3)
+                XCTAssertEqual(record.reserves![2].reserve0.0, block.block)
+                XCTAssertEqual(record.reserves![2].reserve1.1, 1)
+                XCTAssertTrue(record.reserves![2].spot10.isNaN)
+            default:
+                break
+            }
+        }
+        XCTAssertEqual(blocks, Array(1...1_000))
+        XCTAssertEqual(tokens[7], "TK7")
+
+        // Seeking lands on the keyframe, right before its tables
+        XCTAssertTrue(capture_reader_seek(reader, 456))
+        XCTAssertTrue(capture_reader_next(reader, &record))
+        XCTAssertEqual(record.type, CAPTURE_RECORD_TOKEN)
+        while capture_reader_next(reader, &record), record.type != CAPTURE_RECORD_BLOCK {}
+        XCTAssertEqual(record.block!.pointee.block, 400)
+        XCTAssertNotEqual(record.block!.pointee.flags & CAPTURE_BLOCK_KEYFRAME.rawValue, 0)
+    }
+
+    func testAppendAfterReopen() throws {
+        write(blocks: 10)
+
+        let writer = try XCTUnwrap(capture_writer_open(path))
+        XCTAssertEqual(capture_writer_last_block(writer), 10)
+        XCTAssertFalse(capture_writer_begin_block(writer, 10, 0, false), "Block numbers must increase")
+        XCTAssertTrue(capture_writer_begin_block(writer, 11, 0, false))
+        XCTAssertTrue(capture_writer_end_block(writer))
+        capture_writer_close(writer)
+
+        // The index is rebuilt from the data when missing
+        try FileManager.default.removeItem(atPath: path + ".idx")
+        let reader = try XCTUnwrap(capture_reader_open(path))
+        defer { capture_reader_close(reader) }
+        XCTAssertEqual(capture_reader_block_count(reader), 11)
+        // First block of a session is always a keyframe
+        XCTAssertNotEqual(capture_reader_index(reader)![10].flags & CAPTURE_BLOCK_KEYFRAME.rawValue, 0)
+    }
+
+    func testConcurrentRecordsFollowOneStore() async throws {
+        do {
+            let capture = try XCTUnwrap(ReserveCapture(path: path, keyframeInterval: 10))
+            let store = AdjacencyList(), other = AdjacencyList()
+            await capture.record(block: 1, timestamp: 1, from: store)
+
+            // Overlapping blocks, as when heads come faster than they are dispatched
+            await withTaskGroup(of: Void.self) { group in
+                for block in UInt64(2)...40 {
+                    group.addTask { await capture.record(block: block, timestamp: block, from: store) }
+                    group.addTask { await capture.record(block: block + 100, timestamp: block, from: other) }
+                }
+            }
+            await capture.record(block: 41, timestamp: 41, from: store)
+        } // Closes the capture
+
+        let reader = try XCTUnwrap(capture_reader_open(path))
+        defer { capture_reader_close(reader) }
+        var record = capture_record_t()
+        var blocks = [UInt64]()
+        while capture_reader_next(reader, &record) {
+            if record.type == CAPTURE_RECORD_BLOCK {
+                blocks.append(record.block!.pointee.block)
+            }
+        }
+        // Written one at a time, in increasing order, and only from the first store
+        XCTAssertEqual(blocks, blocks.sorted())
+        XCTAssertEqual(Set(blocks).count, blocks.count)
+        XCTAssertEqual(blocks.first, 1)
+        XCTAssertEqual(blocks.last, 41)
+    }
+
+    // MARK: - Benchmarks
+
+    func testReadPerformance() throws {
+        write(blocks: 200_000)
+        let reader = try XCTUnwrap(capture_reader_open(path))
+        defer { capture_reader_close(reader) }
+
+        measure {
+            capture_reader_rewind(reader)
+            var record = capture_record_t()
+            var blocks = 0
+            while capture_reader_next(reader, &record) {
+                if record.type == CAPTURE_RECORD_BLOCK {
+                    blocks += 1
+                }
+            }
+            XCTAssertEqual(blocks, 200_000)
+        }
+    }
+}
@@ -0,0 +1,123 @@
+//
+//  CompressionTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Euler
+import Native
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class CompressionTests: XCTestCase {
+    /// Snapshot of a 64 tokens matrix (~33 KB)
+    lazy var snapshot: Bytes = {
+        let tokens = (0..<64).map { i in
+            Token(name: "TK\(i)", address: try! EthereumAddress(hex: "0x" + String(repeating: String(format: "%02x", i), count: 20), eip55: false))
+        }
+        let rates = (0..<64 * 64).map { i in i % 65 == 0 ? 1 : 1 + Double(i % 97) / 1_000 }
+        return BinaryFrame.matrixSnapshot(rates, tokens: tokens)
+    }()
+
+    /// A quote frame (~130 bytes)
+    lazy var quote: Bytes = {
+        let tokenA = Token(name: "WBNB", address: try! EthereumAddress(hex: "0xbb4CdB9CBd36B01bD1cBaEBF2De08d9173bc095c", eip55: false))
+        let tokenB = Token(name: "BUSD", address: try! EthereumAddress(hex: "0xe9e7CEA3DedcA5984780Bafc599bD69ADd087D56", eip55: false))
+        return BinaryFrame.quote(Quote(exchangeName: "uniswap", amount: Euler.BigInt(1_000_000_000_000_000_000), amountOut: Euler.BigInt(300),
+                                       price: BigDouble(300.5), transactionPrice: BigDouble(301), tokenA: tokenA, tokenB: tokenB))
+    }()
+
+    /// Subscribers of the snapshot, for the per socket modes
+    let sockets = 100
+
+    func precompress(_ frame: Bytes) -> Bytes {
+        var out = Bytes(repeating: 0, count: frame.count)
+        let length = compression_precompress_frame(frame, frame.count, &out)
+        return Array(out.prefix(length))
+    }
+
+    func deflate(_ bytes: Bytes) -> Int {
+        var out = Bytes(repeating: 0, count: bytes.count + 64)
+        return compression_deflate(bytes, bytes.count, &out, out.count)
+    }
+
+    func testPolicy() {
+        XCTAssertEqual(compression_policy(quote, quote.count, true), COMPRESSION_NONE)
+        let json = Bytes(repeating: UInt8(ascii: "a"), count: 2_048)
+        XCTAssertEqual(compression_policy(json, json.count, false), COMPRESSION_SHARED)
+        XCTAssertEqual(compression_policy(snapshot, snapshot.count, true), COMPRESSION_PRECOMPRESSED)
+        // Large JSON stays with the compressor of the socket
+        XCTAssertEqual(compression_policy(snapshot, snapshot.count, false), COMPRESSION_SHARED)
+
+        let deflated = precompress(snapshot)
+        XCTAssertEqual(compression_policy(deflated, deflated.count, true), COMPRESSION_NONE)
+    }
+
+    func testPrecompressedFrame() throws {
+        let deflated = precompress(snapshot)
+        XCTAssertEqual(deflated[0], BinaryFrame.Kind.matrixSnapshot.rawValue)
+        XCTAssertEqual(UInt32(deflated[2]) & UInt32(COMPRESSION_FRAME_DEFLATED), UInt32(COMPRESSION_FRAME_DEFLATED))
+        let length = deflated[4..<8].reversed().reduce(0) { $0 << 8 | Int($1) }
+        XCTAssertEqual(length, deflated.count - 8)
+        XCTAssertLessThan(deflated.count, snapshot.count / 2)
+
+        var payload = Bytes(repeating: 0, count: snapshot.count)
+        let inflated = compression_inflate(Array(deflated[8...]), length, &payload, payload.count)
+        XCTAssertEqual(Array(payload.prefix(inflated)), Array(snapshot[8...]))
+    }
+
+    func testIncompressibleFrameIsKept() {
+        var generator = SystemRandomNumberGenerator()
+        var frame: Bytes = [BinaryFrame.Kind.matrixSnapshot.rawValue, BinaryFrame.version, 0, 0, 0, 0, 0, 0]
+        frame += (0..<COMPRESSION_PRECOMPRESS_SIZE).map { _ in UInt8.random(in: 0...255, using: &generator) }
+        XCTAssertTrue(precompress(frame).isEmpty)
+    }
+
+    /// Bytes sent per message in each mode: quotes save a few dozen bytes, snapshots shrink many times
+    func testBytesOnTheWire() {
+        XCTAssertGreaterThan(deflate(quote), quote.count / 2)
+        XCTAssertLessThan(precompress(snapshot).count, snapshot.count / 10)
+    }
+
+    // MARK: - Benchmarks
+    // CPU per message of each mode. Per socket compressors deflate every snapshot once per subscriber.
+
+    func testQuotePolicyPerformance() {
+        let quote = self.quote
+        measure {
+            for _ in 0..<100_000 {
+                _ = quote.withUnsafeBufferPointer { compression_policy($0.baseAddress!, $0.count, true) }
+            }
+        }
+    }
+
+    func testQuoteDeflatePerformance() {
+        let quote = self.quote
+        measure {
+            for _ in 0..<10_000 {
+                _ = deflate(quote)
+            }
+        }
+    }
+
+    func testSnapshotPerSocketDeflatePerformance() {
+        let snapshot = self.snapshot
+        measure {
+            for _ in 0..<sockets {
+                _ = deflate(snapshot)
+            }
+        }
+    }
+
+    func testSnapshotPrecompressedPerformance() {
+        let snapshot = self.snapshot
+        measure {
+            _ = precompress(snapshot)
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  ConflationTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Native
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class ConflationTests: XCTestCase {
+    var conflation: UnsafeMutablePointer<conflation_t>!
+
+    override func setUp() {
+        metrics_reset()
+        conflation = conflation_create()
+        for topic in ["prices", "decision", "latency"] {
+            XCTAssertTrue(conflation_add_topic(conflation, topic, topic.utf8.count))
+        }
+    }
+
+    override func tearDown() {
+        conflation_free(conflation)
+    }
+
+    func store(_ topic: String, _ message: String, opcode: Int32 = 1, delta: Bool = false) {
+        conflation_store(conflation, topic, topic.utf8.count, message, message.utf8.count, opcode, delta)
+    }
+
+    /// Slots in the order they are sent, with their publication
+    var slots: [(topic: String, message: String?)] {
+        (0..<conflation.pointee.count).map { i in
+            let slot = conflation.pointee.slots![i]
+            let topic = String(decoding: UnsafeRawBufferPointer(start: slot.topic, count: slot.topic_length), as: UTF8.self)
+            let message = slot.message.map { String(decoding: UnsafeRawBufferPointer(start: $0, count: slot.length), as: UTF8.self) }
+            return (topic, message)
+        }
+    }
+
+    func testOnlyLatestPublicationIsSent() {
+        store("prices", "1")
+        store("decision", "a")
+        store("prices", "2")
+        store("latency", "x", opcode: 2)
+        store("prices", "3")
+        store("unsubscribed", "z")
+
+        XCTAssertEqual(slots.map(\.topic), ["prices", "decision", "latency"])
+        XCTAssertEqual(slots.map(\.message), ["3", "a", "x"])
+        XCTAssertEqual(conflation.pointee.slots![2].opcode, 2)
+        XCTAssertEqual(Metrics.value(of: .wsFramesSkipped), 2)
+
+        // Adding a topic twice keeps its slot
+        XCTAssertTrue(conflation_add_topic(conflation, "prices", 6))
+        XCTAssertEqual(slots.map(\.message), ["3", "a", "x"])
+    }
+
+    func testDeltaFrameRequiresResync() {
+        store("prices", "snapshot", opcode: 2)
+        store("prices", "\u{4}delta", opcode: 2, delta: true)
+
+        XCTAssertNil(slots[0].message)
+        XCTAssertTrue(conflation.pointee.slots![0].resync)
+        XCTAssertEqual(Metrics.value(of: .wsFramesSkipped), 2)
+
+        // A later snapshot is kept, but the topic still resyncs
+        store("prices", "snapshot", opcode: 2)
+        XCTAssertEqual(slots[0].message, "snapshot")
+        XCTAssertTrue(conflation.pointee.slots![0].resync)
+    }
+
+    func testRemoveTopic() {
+        store("prices", "1")
+        XCTAssertTrue(conflation_remove_topic(conflation, "prices", 6))
+        XCTAssertFalse(conflation_remove_topic(conflation, "prices", 6))
+        XCTAssertNil(conflation_slot(conflation, "prices", 6))
+        XCTAssertEqual(Set(slots.map(\.topic)), ["decision", "latency"])
+    }
+}
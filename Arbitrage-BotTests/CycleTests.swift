@@ -16,7 +16,8 @@ import Euler
 class CycleTests: XCTestCase {
     
     override func setUpWithError() throws {
-        Environment.shared["JSON_RPC_URL"] = "wss://newest-clean-brook.bsc-testnet.discover.quiknode.pro/a7741560cac07bb20c2dce045b38655fad4569b8/"
+        Environment.shared["JSON_RPC_URL"] = jsonRPCURL
+        Environment.shared["TESTNET_JSON_RPC_URL"] = jsonRPCURL
         Environment.shared["WALLET_PRIVATE_KEY"] = try EthereumPrivateKey().hex()
     }
 
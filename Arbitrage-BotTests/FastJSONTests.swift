@@ -0,0 +1,113 @@
+//
+//  FastJSONTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Synthetic payloads, shaped like the messages of a BSC node. Hashes and addresses are made up.
+private enum Payloads {
+    static let newHead = """
+    {"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x9ce59a13059e417087c02d3236a0b1cc","result":{"parentHash":"0x2a1ad1b6b4f1c4b06d7b4e1bd5c0e7ab4d3b2a6b4c2f0c4d7a1c2b3e4f5a6b7c","sha3Uncles":"0x1dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347","miner":"0x35552c16704d214347f29fa77f77da6d75d7c752","stateRoot":"0x8b3c0a6e0b0d4f2c1a9e7d6c5b4a39281706f5e4d3c2b1a0f9e8d7c6b5a49382","transactionsRoot":"0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421","receiptsRoot":"0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421","logsBloom":"0x00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000","difficulty":"0x2","number":"0x2238f4b","gasLimit":"0x2faf080","gasUsed":"0x6f3b1c","timestamp":"0x6530d6e1","extraData":"0xd883010202846765746888676f312e31392e38856c696e7578","mixHash":"0x0000000000000000000000000000000000000000000000000000000000000000","nonce":"0x0000000000000000","baseFeePerGas":null,"hash":"0x4d3f9a6c2b1e0d8f7a6b5c4d3e2f1a0b9c8d7e6f5a4b3c2d1e0f9a8b7c6d5e4f"}}}
+    """
+
+    static let callResult = """
+    {"jsonrpc":"2.0","id":4123,"result":"0x00000000000000000000000000000000000000000000000d8d726b7177a800000000000000000000000000000000000000000000000000000000048c27395000000000000000000000000000000000000000000000000000000000006530d6e1"}
+    """
+
+    static let syncLog = """
+    {"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x4a8a4c0517381924f9838102c5a4dcb7","result":{"address":"0x0ed7e52944161450477ee417de9cd3a859b14fd0","topics":["0x1c411e9a96e071241c2f21f7726b17ae89e3cab4c78be50e062b03a9fffbbad1"],"data":"0x00000000000000000000000000000000000000000000000d8d726b7177a800000000000000000000000000000000000000000000000000000000048c27395000","blockNumber":"0x2238f4b","transactionHash":"0x6f1c3b2a0d9e8f7a6b5c4d3e2f1a0b9c8d7e6f5a4b3c2d1e0f9a8b7c6d5e4f3a","transactionIndex":"0x3","blockHash":"0x4d3f9a6c2b1e0d8f7a6b5c4d3e2f1a0b9c8d7e6f5a4b3c2d1e0f9a8b7c6d5e4f","logIndex":"0x11","removed":false}}}
+    """
+}
+
+final class FastJSONTests: XCTestCase {
+
+    func testRouting() {
+        guard case .notification(let subscription) = FastJSON.scan(Payloads.newHead) else { return XCTFail("Not a notification") }
+        XCTAssertEqual(subscription, "0x9ce59a13059e417087c02d3236a0b1cc")
+
+        guard case .response(let id) = FastJSON.scan(Payloads.callResult) else { return XCTFail("Not a response") }
+        XCTAssertEqual(id, 4123)
+
+        guard case .batch(let firstId) = FastJSON.scan("[\(Payloads.callResult)]") else { return XCTFail("Not a batch") }
+        XCTAssertEqual(firstId, 4123)
+
+        XCTAssertNil(FastJSON.scan("{\"jsonrpc\":\"2.0\",\"id\":"))
+    }
+
+    func testPayloads() throws {
+        let head = try XCTUnwrap(FastJSON.newHead(Payloads.newHead))
+        XCTAssertEqual(head.number, 0x2238f4b)
+        XCTAssertEqual(head.timestamp, 0x6530d6e1)
+        XCTAssertEqual(head.baseFeePerGas, 0)
+
+        let result = try XCTUnwrap(FastJSON.callResult(Payloads.callResult))
+        XCTAssertEqual(result.bytes.count, 96)
+
+        let log = try XCTUnwrap(FastJSON.log(Payloads.syncLog))
+        XCTAssertEqual(log.address.hex(eip55: false), "0x0ed7e52944161450477ee417de9cd3a859b14fd0")
+        XCTAssertEqual(log.topics, [SyncLogListener.syncTopic])
+        XCTAssertEqual(log.data.count, 64)
+        XCTAssertEqual(log.blockNumber, 0x2238f4b)
+        XCTAssertEqual(log.logIndex, 0x11)
+        XCTAssertFalse(log.removed)
+    }
+
+    func testMissingBaseFee() throws {
+        let null = Payloads.newHead.replacingOccurrences(of: "\"baseFeePerGas\":null,", with: "\"baseFeePerGas\": null ,")
+        XCTAssertEqual(try XCTUnwrap(FastJSON.newHead(null)).baseFeePerGas, 0)
+
+        let missing = Payloads.newHead.replacingOccurrences(of: "\"baseFeePerGas\":null,", with: "")
+        let head = try XCTUnwrap(FastJSON.newHead(missing))
+        XCTAssertEqual(head.number, 0x2238f4b)
+        XCTAssertEqual(head.baseFeePerGas, 0)
+
+        let london = Payloads.newHead.replacingOccurrences(of: "\"baseFeePerGas\":null", with: "\"baseFeePerGas\":\"0x3b9aca00\"")
+        XCTAssertEqual(try XCTUnwrap(FastJSON.newHead(london)).baseFeePerGas, 1_000_000_000)
+    }
+
+    // MARK: - Benchmarks
+
+    func testNewHeadJSONDecoderPerformance() {
+        let data = Payloads.newHead.data(using: .utf8)!
+        let decoder = JSONDecoder()
+        measure {
+            for _ in 0..<1_000 {
+                _ = try? decoder.decode(RPCEventResponse<EthereumBlockObject>.self, from: data)
+            }
+        }
+    }
+
+    func testNewHeadFastJSONPerformance() {
+        measure {
+            for _ in 0..<1_000 {
+                _ = FastJSON.newHead(Payloads.newHead)
+            }
+        }
+    }
+
+    func testCallResultJSONDecoderPerformance() {
+        let data = Payloads.callResult.data(using: .utf8)!
+        let decoder = JSONDecoder()
+        measure {
+            for _ in 0..<1_000 {
+                _ = try? decoder.decode(RPCResponse<EthereumData>.self, from: data)
+            }
+        }
+    }
+
+    func testCallResultFastJSONPerformance() {
+        measure {
+            for _ in 0..<1_000 {
+                _ = FastJSON.callResult(Payloads.callResult)
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+//
+//  HTTPSnapshotsTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Bodies received by the stub `realtime_store_snapshot`
+private var stored = [(path: String, body: String)]()
+
+final class HTTPSnapshotsTests: XCTestCase {
+    let tokenA = Token(name: "WBNB", address: try! EthereumAddress(hex: "0xbb4CdB9CBd36B01bD1cBaEBF2De08d9173bc095c", eip55: false))
+    let tokenB = Token(name: "BUSD", address: try! EthereumAddress(hex: "0xe9e7CEA3DedcA5984780Bafc599bD69ADd087D56", eip55: false))
+
+    override func setUp() {
+        stored.removeAll()
+        HTTPSnapshots.register(store: { path, pathLength, body, length in
+            let path = String(decoding: UnsafeRawBufferPointer(start: path, count: pathLength), as: UTF8.self)
+            let body = String(decoding: UnsafeRawBufferPointer(start: body, count: length), as: UTF8.self)
+            stored.append((path, body))
+        })
+    }
+
+    func testMatrixEncodesMissingEdges() throws {
+        HTTPSnapshots.storeMatrix([0, 1.5, .infinity, 0], tokens: [tokenA, tokenB], storeId: 42, systemTime: 7)
+
+        let matrix = try XCTUnwrap(stored.first { $0.path == HTTPSnapshots.matrix })
+        let json = try XCTUnwrap(JSONSerialization.jsonObject(with: Data(matrix.body.utf8)) as? [String: Any])
+        XCTAssertEqual(json["systemTime"] as? Int, 7)
+        XCTAssertEqual(json["tokens"] as? [String], [tokenA.address.hex(eip55: false), tokenB.address.hex(eip55: false)])
+        XCTAssertEqual((json["rates"] as? [Any])?.count, 4)
+        XCTAssertEqual((json["rates"] as? [Any])?[2] as? String, "Infinity")
+    }
+
+    func testTokensAreOnlyStoredWhenTheyChange() {
+        HTTPSnapshots.storeMatrix([0], tokens: [tokenA], storeId: 43, systemTime: 1)
+        HTTPSnapshots.storeMatrix([0], tokens: [tokenA], storeId: 43, systemTime: 2)
+        XCTAssertEqual(stored.filter { $0.path == HTTPSnapshots.tokens }.count, 1)
+        XCTAssertEqual(stored.filter { $0.path == HTTPSnapshots.matrix }.count, 2)
+
+        HTTPSnapshots.storeMatrix([0, 1, 1, 0], tokens: [tokenA, tokenB], storeId: 43, systemTime: 3)
+        XCTAssertEqual(stored.filter { $0.path == HTTPSnapshots.tokens }.count, 2)
+    }
+
+    func testOpportunityRoutes() throws {
+        let step = BuilderStep(tokenA: tokenA, tokenB: tokenB, reserveFeeInfos: [])
+        step.next = BuilderStep(tokenA: tokenB, tokenB: tokenA, reserveFeeInfos: [])
+        HTTPSnapshots.storeOpportunities([step], storeId: 0, systemTime: 9)
+
+        let body = try XCTUnwrap(stored.first { $0.path == HTTPSnapshots.opportunities }?.body)
+        let json = try XCTUnwrap(JSONSerialization.jsonObject(with: Data(body.utf8)) as? [String: Any])
+        let routes = try XCTUnwrap(json["routes"] as? [[[String: Any]]])
+        XCTAssertEqual(routes.first?.compactMap { $0["name"] as? String }, ["WBNB", "BUSD", "WBNB"])
+    }
+}
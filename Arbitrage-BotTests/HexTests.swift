@@ -0,0 +1,126 @@
+//
+//  HexTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class HexTests: XCTestCase {
+    /// A 32-byte ABI word
+    let word: Bytes = (0..<32).map { UInt8($0 * 7 & 0xff) }
+    /// Calldata of a multi-kilobyte multicall
+    let calldata: Bytes = (0..<4_100).map { UInt8($0 * 31 & 0xff) }
+
+    /// The character-based implementation the codec replaced.
+    private func referenceHexString(_ bytes: Bytes) -> String {
+        let mapping = Array("0123456789abcdef")
+        var chars = [Character](repeating: "0", count: bytes.count * 2)
+        for i in 0..<bytes.count {
+            chars[i * 2] = mapping[Int(bytes[i]) / 16]
+            chars[i * 2 + 1] = mapping[Int(bytes[i]) % 16]
+        }
+        return String(chars)
+    }
+
+    func testEncode() {
+        XCTAssertEqual(Bytes().hexString(prefix: true), "0x")
+        XCTAssertEqual(Bytes().hexString(prefix: false), "")
+        XCTAssertEqual([0x00, 0x0f, 0xab, 0xff].hexString(prefix: true), "0x000fabff")
+        XCTAssertEqual(word.hexString(prefix: false), referenceHexString(word))
+        XCTAssertEqual(calldata.hexString(prefix: true), "0x" + referenceHexString(calldata))
+        XCTAssertEqual(EthereumData(word).hex(), "0x" + referenceHexString(word))
+    }
+
+    func testDecode() throws {
+        XCTAssertEqual(try "0x".hexBytes(), [])
+        XCTAssertEqual(try "".hexBytes(), [])
+        XCTAssertEqual(try "0xABcd01".hexBytes(), [0xab, 0xcd, 0x01])
+        // Leading 0 can be omitted
+        XCTAssertEqual(try "0xfff".hexBytes(), [0x0f, 0xff])
+        XCTAssertEqual(try "0x1".quantityHexBytes(), [0x01])
+
+        // Every length around the vector widths
+        for count in 0..<100 {
+            let bytes = Array(calldata[0..<count])
+            XCTAssertEqual(try bytes.hexString(prefix: true).hexBytes(), bytes)
+            XCTAssertEqual(try bytes.hexString(prefix: false).uppercased().hexBytes(), bytes)
+        }
+        XCTAssertEqual(try calldata.hexString(prefix: true).hexBytes(), calldata)
+    }
+
+    func testRejectsInvalidCharacters() {
+        var hex = Array(calldata.hexString(prefix: false).utf8)
+        for position in [0, 17, 63, 4_000, hex.count - 1] {
+            let original = hex[position]
+            for invalid in ["g", "G", "/", ":", "@", "`", " ", "x"] {
+                hex[position] = UInt8(ascii: invalid.unicodeScalars.first!)
+                XCTAssertThrowsError(try String(decoding: hex, as: UTF8.self).hexBytes())
+            }
+            hex[position] = original
+        }
+        XCTAssertThrowsError(try "0xzz".hexBytes())
+    }
+
+    // MARK: - Benchmarks
+
+    func testWordReferenceEncodePerformance() {
+        let word = self.word
+        measure {
+            for _ in 0..<100_000 {
+                _ = referenceHexString(word)
+            }
+        }
+    }
+
+    func testWordEncodePerformance() {
+        let word = self.word
+        measure {
+            for _ in 0..<100_000 {
+                _ = word.hexString(prefix: true)
+            }
+        }
+    }
+
+    func testWordDecodePerformance() {
+        let hex = word.hexString(prefix: true)
+        measure {
+            for _ in 0..<100_000 {
+                _ = try? hex.hexBytes()
+            }
+        }
+    }
+
+    func testCalldataReferenceEncodePerformance() {
+        let calldata = self.calldata
+        measure {
+            for _ in 0..<1_000 {
+                _ = referenceHexString(calldata)
+            }
+        }
+    }
+
+    func testCalldataEncodePerformance() {
+        let calldata = self.calldata
+        measure {
+            for _ in 0..<1_000 {
+                _ = calldata.hexString(prefix: true)
+            }
+        }
+    }
+
+    func testCalldataDecodePerformance() {
+        let hex = calldata.hexString(prefix: true)
+        measure {
+            for _ in 0..<1_000 {
+                _ = try? hex.hexBytes()
+            }
+        }
+    }
+}
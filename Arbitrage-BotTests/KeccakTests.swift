@@ -0,0 +1,82 @@
+//
+//  KeccakTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import CryptoSwift
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class KeccakTests: XCTestCase {
+    /// 40-byte inputs, like pair salts
+    let salts: Bytes = (0..<4_000 * 40).map { UInt8($0 * 13 & 0xff) }
+
+    func testKnownDigests() {
+        XCTAssertEqual(Bytes().keccak256().hexString(prefix: false),
+                       "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470")
+        // Crosses the 136 bytes block boundary
+        XCTAssertEqual(Array(0..<200).map { UInt8($0) }.keccak256().hexString(prefix: false),
+                       "bfb0aa97863e797943cf7c33bb7e880bb4543f3d2703c0923c6901c2af57b890")
+        XCTAssertEqual(SyncLogListener.syncTopic.bytes, Array("Sync(uint112,uint112)".utf8).keccak256())
+    }
+
+    func testMatchesCryptoSwift() {
+        for count in 0..<300 {
+            let bytes = Array(salts[0..<count])
+            XCTAssertEqual(bytes.keccak256(), SHA3(variant: .keccak256).calculate(for: bytes))
+        }
+    }
+
+    func testBatch() {
+        for length in [1, 40, 85, 136, 137, 300] {
+            for count in 0..<10 {
+                let inputs = Array(salts[0..<length * count])
+                let digests = Keccak.hash256(batch: inputs, length: length)
+                XCTAssertEqual(digests.count, count * 32)
+                for i in 0..<count {
+                    let single = Array(inputs[i * length ..< (i + 1) * length]).keccak256()
+                    XCTAssertEqual(Array(digests[i * 32 ..< (i + 1) * 32]), single)
+                }
+            }
+        }
+    }
+
+    func testCreate2Address() throws {
+        // First example of EIP-1014
+        let address = try EthereumUtils.getCreate2Address(from: .zero, salt: Bytes(repeating: 0, count: 32), initCode: [0x00])
+        XCTAssertEqual(address.hex(eip55: false), "0x4d1a2e2bb4f88f0250f26ffff098b0b30b26bf38")
+    }
+
+    // MARK: - Benchmarks
+
+    func testCryptoSwiftPerformance() {
+        let salts = self.salts
+        measure {
+            for i in 0..<4_000 {
+                _ = SHA3(variant: .keccak256).calculate(for: Array(salts[i * 40 ..< (i + 1) * 40]))
+            }
+        }
+    }
+
+    func testNativePerformance() {
+        let salts = self.salts
+        measure {
+            for i in 0..<4_000 {
+                _ = Array(salts[i * 40 ..< (i + 1) * 40]).keccak256()
+            }
+        }
+    }
+
+    func testNativeBatchPerformance() {
+        let salts = self.salts
+        measure {
+            _ = Keccak.hash256(batch: salts, length: 40)
+        }
+    }
+}
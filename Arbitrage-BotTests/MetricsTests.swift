@@ -0,0 +1,96 @@
+//
+//  MetricsTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Native
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class MetricsTests: XCTestCase {
+    override func setUp() {
+        metrics_reset()
+    }
+
+    func testCounters() {
+        Metrics.increment(.cyclesFound)
+        Metrics.increment(.cyclesFound, by: 4)
+        XCTAssertEqual(Metrics.value(of: .cyclesFound), 5)
+        XCTAssertEqual(Metrics.value(of: .ticks), 0)
+
+        let text = Metrics.render()
+        XCTAssertTrue(text.contains("# TYPE arbitrage_cycles_found_total counter\n"))
+        XCTAssertTrue(text.contains("\narbitrage_cycles_found_total 5\n"))
+    }
+
+    func testHistogramBucketsAreCumulative() {
+        metrics_observe(.rpcDuration, 1_500) // ~1.5 µs
+        metrics_observe(.rpcDuration, 3_000_000) // 3 ms
+        metrics_observe(.rpcDuration, 100_000_000_000) // Past the last bound
+
+        let lines = Metrics.render().split(separator: "\n").filter { $0.hasPrefix("arbitrage_rpc_duration_seconds") }
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"1.024e-06\"} 0"))
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"2.048e-06\"} 1"))
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"0.004194304\"} 2"))
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"+Inf\"} 3"))
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_count 3"))
+    }
+
+    func testHistogramBoundsAreInclusive() {
+        metrics_observe(.rpcDuration, 1_024) // 2^10 ns
+        metrics_observe(.rpcDuration, 1_025)
+        metrics_observe(.rpcDuration, 2_048)
+
+        let lines = Metrics.render().split(separator: "\n").filter { $0.hasPrefix("arbitrage_rpc_duration_seconds") }
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"1.024e-06\"} 1"))
+        XCTAssertTrue(lines.contains("arbitrage_rpc_duration_seconds_bucket{le=\"2.048e-06\"} 3"))
+    }
+
+    func testRenderReportsFullLength() {
+        var small = [CChar](repeating: 0, count: 16)
+        let length = metrics_render(&small, small.count)
+        XCTAssertGreaterThan(length, small.count)
+        XCTAssertEqual(Metrics.render().utf8.count, length)
+
+        // The terminator takes the last byte: the text only fits with one more
+        var exact = [CChar](repeating: 0, count: length)
+        XCTAssertEqual(metrics_render(&exact, exact.count), length)
+        XCTAssertEqual(exact.last, 0)
+        var fitting = [CChar](repeating: 0, count: length + 1)
+        XCTAssertEqual(metrics_render(&fitting, fitting.count), length)
+        XCTAssertEqual(String(cString: fitting), Metrics.render())
+    }
+
+    func testStagePercentiles() {
+        latency_mark(1, .head)
+        latency_mark(1, .reserves)
+        let text = Metrics.render()
+        XCTAssertTrue(text.contains("arbitrage_stage_duration_seconds_count{stage=\"reserves\"} 1\n"))
+        XCTAssertTrue(text.contains("arbitrage_stage_duration_seconds_sum{stage=\"reserves\"} "))
+        latency_reset()
+    }
+
+    // MARK: - Benchmarks
+
+    func testIncrementPerformance() {
+        measure {
+            for _ in 0..<1_000_000 {
+                Metrics.increment(.publications)
+            }
+        }
+    }
+
+    func testObservePerformance() {
+        measure {
+            for i in 0..<1_000_000 {
+                metrics_observe(.tickDuration, UInt64(i))
+            }
+        }
+    }
+}
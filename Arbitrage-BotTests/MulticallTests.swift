@@ -0,0 +1,145 @@
+//
+//  MulticallTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import BigInt
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Local stand-in for a node: answers every `eth_call` with `getReserves` results for each aggregated call.
+private final class MulticallStubProvider: Web3Provider {
+    let reserves: (Web3BigUInt, Web3BigUInt)
+    var requestCount = 0
+
+    init(reserves: (Web3BigUInt, Web3BigUInt)) {
+        self.reserves = reserves
+    }
+
+    func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>) {
+        requestCount += 1
+        guard let params = request.params as? EthereumCallParams else {
+            return response(Web3Response(error: .requestFailed(nil)))
+        }
+        // Skip selector, requireSuccess and array offset to read the number of calls
+        let data = params.call.data?.bytes ?? []
+        let count = Int(Web3BigUInt(Data(data[68..<100])))
+
+        let returnData = MulticallTests.word(reserves.0) + MulticallTests.word(reserves.1) + MulticallTests.word(0)
+        let result = EthereumData(MulticallTests.encodeResults(Array(repeating: (true, returnData), count: count)))
+        response(Web3Response(status: .success(result as! Result)))
+    }
+}
+
+final class MulticallTests: XCTestCase {
+
+    static func word(_ value: Web3BigUInt) -> Bytes {
+        let bytes = Bytes(value.serialize())
+        return Bytes(repeating: 0, count: 32 - bytes.count) + bytes
+    }
+
+    /// ABI encodes `(bool, bytes)[]` the way Multicall3 returns it.
+    static func encodeResults(_ results: [(Bool, Bytes)]) -> Bytes {
+        let elements = results.map { success, data -> Bytes in
+            let padding = Bytes(repeating: 0, count: (32 - data.count % 32) % 32)
+            return word(success ? 1 : 0) + word(64) + word(Web3BigUInt(data.count)) + data + padding
+        }
+        var encoded = word(32) + word(Web3BigUInt(results.count))
+        var offset = results.count * 32
+        for element in elements {
+            encoded += word(Web3BigUInt(offset))
+            offset += element.count
+        }
+        return elements.reduce(encoded, +)
+    }
+
+    func testEncodeTryAggregate() throws {
+        let target = try EthereumAddress(hex: "0xB4e16d0168e52d35CaCD2c6185b44281Ec28C9Dc", eip55: false)
+        let calls = [
+            Multicall.Call(target: target, callData: UniswapV2Pair.Reserves.selector),
+            Multicall.Call(target: target, callData: UniswapV2Pair.Reserves.selector)
+        ]
+        let data = Multicall.encodeTryAggregate(requireSuccess: false, calls: calls)
+
+        XCTAssertEqual(Array(data[0..<4]), Multicall.tryAggregateSelector)
+        // selector + bool + offset + length + 2 offsets + 2 * (address, offset, length, padded selector)
+        XCTAssertEqual(data.count, 4 + 32 * 5 + 2 * 32 * 4)
+        XCTAssertEqual(Web3BigUInt(Data(data[100..<132])), 64) // First element right after the 2 offsets
+        XCTAssertEqual(Web3BigUInt(Data(data[132..<164])), 64 + 128)
+        XCTAssertEqual(Array(data[176..<196]), target.rawAddress)
+    }
+
+    func testDecodeTryAggregate() throws {
+        let encoded = MulticallTests.encodeResults([(true, [0x01, 0x02]), (false, []), (true, Bytes(repeating: 0xff, count: 96))])
+        let results = try Multicall.decodeTryAggregate(encoded)
+
+        XCTAssertEqual(results.count, 3)
+        XCTAssertEqual(results[0].success, true)
+        XCTAssertEqual(results[0].returnData, [0x01, 0x02])
+        XCTAssertEqual(results[1].success, false)
+        XCTAssertEqual(results[1].returnData, [])
+        XCTAssertEqual(results[2].returnData.count, 96)
+
+        XCTAssertThrowsError(try Multicall.decodeTryAggregate(Array(encoded[0..<100])))
+    }
+
+    func testDecodeMalformedResponses() {
+        let encoded = MulticallTests.encodeResults([(true, [0x01, 0x02]), (false, [])])
+        func patched(word index: Int, _ value: Bytes) -> Bytes {
+            var data = encoded
+            data.replaceSubrange(index * 32..<(index + 1) * 32, with: Bytes(repeating: 0, count: 32 - value.count) + value)
+            return data
+        }
+        let negative: Bytes = [0x80, 0, 0, 0, 0, 0, 0, 0x01]
+        let huge: Bytes = [0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff]
+
+        // Layout: array offset, count, 2 element offsets, then the first element (success, bytes offset, length, data)
+        let malformed: [String: Bytes] = [
+            "empty": [],
+            "truncated": Array(encoded[0..<31]),
+            "truncated element": Array(encoded[0..<(4 + 3) * 32]),
+            "negative count": patched(word: 1, negative),
+            "huge count": patched(word: 1, huge),
+            "count past the end": patched(word: 1, [0x10]),
+            "negative array offset": patched(word: 0, negative),
+            "array offset past the end": patched(word: 0, [0xff, 0xff]),
+            "negative element offset": patched(word: 2, negative),
+            "huge element offset": patched(word: 2, huge),
+            "negative bytes offset": patched(word: 5, negative),
+            "negative length": patched(word: 6, negative),
+            "huge length": patched(word: 6, huge),
+            "length past the end": patched(word: 6, [0x01, 0x00]),
+        ]
+        for (name, data) in malformed {
+            XCTAssertThrowsError(try Multicall.decodeTryAggregate(data), name)
+        }
+    }
+
+    func testTryAggregateSingleRequest() async throws {
+        let provider = MulticallStubProvider(reserves: (1_000, 2_000))
+        let multicall = Multicall(eth: Web3(provider: provider).eth)
+        let target = try EthereumAddress(hex: "0xB4e16d0168e52d35CaCD2c6185b44281Ec28C9Dc", eip55: false)
+        let calls = Array(repeating: Multicall.Call(target: target, callData: UniswapV2Pair.Reserves.selector), count: 50)
+
+        let results = try await multicall.tryAggregate(calls: calls)
+
+        XCTAssertEqual(provider.requestCount, 1)
+        XCTAssertEqual(results.count, 50)
+        XCTAssertEqual(Web3BigUInt(Data(results[0].returnData[0..<32])), 1_000)
+        XCTAssertEqual(Web3BigUInt(Data(results[49].returnData[32..<64])), 2_000)
+    }
+
+    func testDecodePerformance() {
+        let returnData = MulticallTests.word(1_000) + MulticallTests.word(2_000) + MulticallTests.word(0)
+        let encoded = MulticallTests.encodeResults(Array(repeating: (true, returnData), count: 500))
+        measure {
+            _ = try? Multicall.decodeTryAggregate(encoded)
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//
+//  NonceManagerTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import BigInt
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class NonceManagerTests: XCTestCase {
+    let node = StubProvider(delay: 0.01) // Pending count is always 1
+    let address = try! EthereumAddress(hex: "0x0000000000000000000000000000000000000001", eip55: false)
+
+    func testCountsLocally() async throws {
+        let web3 = Web3(provider: node)
+        let manager = NonceManager(address: address) { (web3, .development) }
+
+        let first = try await manager.reserve()
+        let second = try await manager.reserve()
+        XCTAssertEqual(first.quantity, 1)
+        XCTAssertEqual(second.quantity, 2)
+        XCTAssertEqual(node.calls, 1)
+
+        // Only the last nonce can be given back
+        await manager.release(first)
+        await manager.release(second)
+        let third = try await manager.reserve()
+        XCTAssertEqual(third.quantity, 2)
+
+        await manager.resync()
+        let synced = try await manager.reserve()
+        XCTAssertEqual(synced.quantity, 1)
+        XCTAssertEqual(node.calls, 2)
+    }
+
+    func testConcurrentReservesAreUnique() async throws {
+        let web3 = Web3(provider: node)
+        let manager = NonceManager(address: address) { (web3, .development) }
+
+        let nonces = try await withThrowingTaskGroup(of: EthereumQuantity.self) { group in
+            for _ in 0..<50 {
+                group.addTask { try await manager.reserve() }
+            }
+            return try await group.reduce(into: []) { $0.append($1.quantity) }
+        }
+        XCTAssertEqual(Set(nonces), Set((1...50).map { BigUInt($0) }))
+        XCTAssertEqual(node.calls, 1, "Concurrent syncs are shared")
+    }
+
+    func testResyncsOnEnvironmentChange() async throws {
+        let web3 = Web3(provider: node)
+        var environment = BotRequest.Environment.development
+        let manager = NonceManager(address: address) { (web3, environment) }
+
+        _ = try await manager.reserve()
+        _ = try await manager.reserve()
+        environment = .production
+        let nonce = try await manager.reserve()
+        XCTAssertEqual(nonce.quantity, 1)
+    }
+}
@@ -0,0 +1,160 @@
+//
+//  OutboxTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import Native
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class OutboxTests: XCTestCase {
+    private var outbox: UnsafeMutablePointer<outbox_t>!
+    private var buckets = outbox_buckets_t()
+    private var live = live_sockets_t()
+
+    override func setUp() {
+        outbox = .allocate(capacity: 1)
+        outbox.initialize(to: outbox_t())
+    }
+
+    override func tearDown() {
+        outbox_free(outbox_take(outbox))
+        outbox.deinitialize(count: 1)
+        outbox.deallocate()
+        outbox_buckets_free(&buckets)
+        live_sockets_free(&live)
+    }
+
+    @discardableResult
+    private func push(_ text: String, to socket: UInt64) -> outbox_push_result_t {
+        let bytes = Array(text.utf8CString.dropLast())
+        return bytes.withUnsafeBufferPointer {
+            outbox_push(outbox, OUTBOX_SEND, 1, socket, nil, 0, $0.baseAddress, $0.count)
+        }
+    }
+
+    private func text(of message: UnsafeMutablePointer<outbox_message_t>) -> String {
+        let body = UnsafeRawPointer(outbox_message_body(message)).assumingMemoryBound(to: UInt8.self)
+        return String(decoding: UnsafeBufferPointer(start: body, count: message.pointee.length), as: UTF8.self)
+    }
+
+    /// Splits a flush like the loop does, returning the texts of each socket in bucket order
+    private func bucketFlush() -> [(socket: UInt64, texts: [String])] {
+        var queue = outbox_take(outbox)
+        while let message = queue {
+            queue = message.pointee.next
+            XCTAssertTrue(outbox_buckets_add(&buckets, message))
+        }
+        var flush: [(socket: UInt64, texts: [String])] = []
+        for bucket in UnsafeBufferPointer(start: buckets.buckets, count: buckets.count) {
+            var texts: [String] = []
+            var message = bucket.first
+            while let current = message {
+                XCTAssertEqual(current.pointee.socket_id, bucket.socket_id)
+                texts.append(text(of: current))
+                message = current.pointee.next
+            }
+            flush.append((bucket.socket_id, texts))
+            outbox_free(bucket.first)
+        }
+        outbox_buckets_clear(&buckets)
+        return flush
+    }
+
+    func testSchedulesOncePerFlush() {
+        XCTAssertEqual(push("a", to: 1), OUTBOX_PUSH_SCHEDULE)
+        XCTAssertEqual(push("b", to: 1), OUTBOX_PUSH_QUEUED)
+        XCTAssertEqual(bucketFlush().map(\.texts), [["a", "b"]])
+        XCTAssertEqual(push("c", to: 1), OUTBOX_PUSH_SCHEDULE)
+    }
+
+    func testPerSocketOrderAcrossProducers() {
+        let producers = 4, messages = 2_000, sockets: UInt64 = 40
+        DispatchQueue.concurrentPerform(iterations: producers) { producer in
+            for i in 0..<messages {
+                push("\(producer):\(i)", to: 1 + UInt64(i) % sockets)
+            }
+        }
+
+        let flush = bucketFlush()
+        XCTAssertEqual(flush.count, Int(sockets)) // Past the initial capacity
+        XCTAssertEqual(Set(flush.map(\.socket)).count, flush.count)
+        XCTAssertEqual(flush.reduce(0) { $0 + $1.texts.count }, producers * messages)
+        for (socket, texts) in flush {
+            // Each producer's messages come in the order it pushed them
+            var last = [Int](repeating: -1, count: producers)
+            for text in texts {
+                let parts = text.split(separator: ":").compactMap { Int($0) }
+                XCTAssertEqual(UInt64(parts[1]) % sockets + 1, socket)
+                XCTAssertGreaterThan(parts[1], last[parts[0]])
+                last[parts[0]] = parts[1]
+            }
+        }
+
+        // The table is reused by the next flush
+        push("next", to: 7)
+        XCTAssertEqual(bucketFlush().map(\.socket), [7])
+    }
+
+    func testSocketRemovedDuringFlush() {
+        let sockets = (1...3).map { _ in UnsafeMutableRawPointer.allocate(byteCount: 1, alignment: 1) }
+        defer { sockets.forEach { $0.deallocate() } }
+        for (index, socket) in sockets.enumerated() {
+            XCTAssertTrue(live_sockets_insert(&live, UInt64(index + 1), socket))
+        }
+        for socket: UInt64 in [1, 2, 3, 1, 3] {
+            push("to \(socket)", to: socket)
+        }
+
+        var queue = outbox_take(outbox)
+        while let message = queue {
+            queue = message.pointee.next
+            XCTAssertTrue(outbox_buckets_add(&buckets, message))
+        }
+        // Sockets are resolved at their turn: sending to the first one closes the third
+        var sent: [String] = []
+        for bucket in UnsafeBufferPointer(start: buckets.buckets, count: buckets.count) {
+            if live_sockets_find(&live, bucket.socket_id) != nil {
+                var message = bucket.first
+                while let current = message {
+                    sent.append(text(of: current))
+                    message = current.pointee.next
+                }
+            }
+            if bucket.socket_id == 1 {
+                live_sockets_remove(&live, 3)
+            }
+            outbox_free(bucket.first)
+        }
+        outbox_buckets_clear(&buckets)
+
+        XCTAssertEqual(sent, ["to 1", "to 1", "to 2"])
+        XCTAssertEqual(live.count, 2)
+        XCTAssertEqual(live_sockets_find(&live, 1), sockets[0])
+        XCTAssertEqual(live_sockets_find(&live, 2), sockets[1])
+        XCTAssertNil(live_sockets_find(&live, 3))
+    }
+
+    func testLiveSocketsRemoval() {
+        let socket = UnsafeMutableRawPointer.allocate(byteCount: 1, alignment: 1)
+        defer { socket.deallocate() }
+        // Enough ids to grow the table and collide
+        for id in UInt64(1)...1_000 {
+            XCTAssertTrue(live_sockets_insert(&live, id, socket))
+        }
+        for id in stride(from: UInt64(1), through: 1_000, by: 2) {
+            live_sockets_remove(&live, id)
+        }
+        live_sockets_remove(&live, 2_000) // Unknown
+        XCTAssertEqual(live.count, 500)
+        for id in UInt64(1)...1_000 {
+            XCTAssertEqual(live_sockets_find(&live, id) != nil, id % 2 == 0, "\(id)")
+        }
+    }
+}
@@ -0,0 +1,74 @@
+//
+//  PairAddressIndexTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class PairAddressIndexTests: XCTestCase {
+    // WETH/USDC on Uniswap V2 mainnet
+    let factory = try! EthereumAddress(hex: "0x5c69bee701ef814a2b6a3edd4b1652cb9cc5aa6f", eip55: false)
+    let weth = try! EthereumAddress(hex: "0xc02aaa39b223fe8d0a0e5c4f27ead9083c756cc2", eip55: false)
+    let usdc = try! EthereumAddress(hex: "0xa0b86991c6218b36c1d19d4a2e9eb0ce3606eb48", eip55: false)
+    let pair = try! EthereumAddress(hex: "0xb4e16d0168e52d35cacd2c6185b44281ec28c9dc", eip55: false)
+    let initCodeHash = try! "0x96e8ac4277198ff8b6f785478aa9a39f403cb768dd02cbee326c3e7da348845f".hexBytes()
+
+    let cacheFile = ".pair-index-tests.json"
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: PairAddressIndex(cacheFile: cacheFile).cacheURL)
+    }
+
+    /// Index holding the WETH/USDC pair, saved to the test cache
+    func savedIndex() -> PairAddressIndex {
+        let index = PairAddressIndex(cacheFile: cacheFile)
+        index[factory, usdc, weth] = pair
+        index.save(initCodeHashes: [factory: initCodeHash])
+        return index
+    }
+
+    func testPairAddresses() {
+        let key = PairAddressIndex.Key(factory: factory, tokenA: weth, tokenB: usdc)
+        XCTAssertEqual(PairAddressIndex.pairAddresses(of: [key, key], initCodeHashes: [initCodeHash, initCodeHash]), [pair, pair])
+    }
+
+    func testCacheIsKeyedByInitCodeHash() {
+        let index = savedIndex()
+
+        let loaded = PairAddressIndex(cacheFile: cacheFile)
+        loaded.load(initCodeHashes: [factory: initCodeHash])
+        XCTAssertEqual(loaded[factory, weth, usdc], pair)
+        XCTAssertEqual(loaded.key(for: pair)?.token0, usdc)
+
+        // Same factory, other pair bytecode: the cached pair is left to the build
+        let changed = PairAddressIndex(cacheFile: cacheFile)
+        changed.load(initCodeHashes: [factory: Array(repeating: 0, count: 32)])
+        XCTAssertEqual(changed.count, 0)
+
+        // Unknown factory
+        let other = PairAddressIndex(cacheFile: cacheFile)
+        other.load(initCodeHashes: [:])
+        XCTAssertEqual(other.count, 0)
+        XCTAssertEqual(index.count, 1)
+    }
+
+    func testTamperedCacheIsDiscarded() throws {
+        let index = savedIndex()
+        let text = try String(contentsOf: index.cacheURL, encoding: .utf8)
+        XCTAssertTrue(text.contains(pair.hex(eip55: false)))
+        try text.replacingOccurrences(of: pair.hex(eip55: false), with: "0x00000000000000000000000000000000000000aa")
+            .write(to: index.cacheURL, atomically: true, encoding: .utf8)
+
+        let loaded = PairAddressIndex(cacheFile: cacheFile)
+        loaded.load(initCodeHashes: [factory: initCodeHash])
+        XCTAssertEqual(loaded.count, 0)
+        XCTAssertNil(loaded[factory, weth, usdc])
+    }
+}
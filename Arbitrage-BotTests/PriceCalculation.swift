@@ -15,7 +15,8 @@ import AGGRenderer
 final class PriceCalculation: XCTestCase {
 
     override func setUpWithError() throws {
-        Environment.shared["JSON_RPC_URL"] = "wss://newest-clean-brook.bsc-testnet.discover.quiknode.pro/a7741560cac07bb20c2dce045b38655fad4569b8/"
+        Environment.shared["JSON_RPC_URL"] = jsonRPCURL
+        Environment.shared["TESTNET_JSON_RPC_URL"] = jsonRPCURL
         Environment.shared["WALLET_PRIVATE_KEY"] = "97e74b612c20179a0767b7f6bdfd41f3f14fe9ae84d7a61468b0fae08ee33fe8"
     }
 
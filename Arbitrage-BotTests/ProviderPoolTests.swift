@@ -0,0 +1,110 @@
+//
+//  ProviderPoolTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Stand-in endpoint answering `"0x1"` after `delay`, or failing like a dropped connection.
+final class StubProvider: Web3Provider {
+    let delay: TimeInterval
+    let fails: Bool
+
+    private let lock = NSLock()
+    private var _calls = 0
+    var calls: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return _calls
+    }
+
+    init(delay: TimeInterval, fails: Bool = false) {
+        self.delay = delay
+        self.fails = fails
+    }
+
+    func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>) {
+        lock.lock()
+        _calls += 1
+        lock.unlock()
+        DispatchQueue.global().asyncAfter(deadline: .now() + delay) {
+            guard !self.fails else {
+                response(Web3Response(error: .connectionFailed(nil)))
+                return
+            }
+            let json = #"{"jsonrpc":"2.0","id":\#(request.id),"result":"0x1"}"#
+            let decoded = try! JSONDecoder().decode(RPCResponse<Result>.self, from: Data(json.utf8))
+            response(Web3Response(rpcResponse: decoded))
+        }
+    }
+}
+
+final class ProviderPoolTests: XCTestCase {
+    let request = BasicRPCRequest(id: 1, jsonrpc: Web3.jsonrpc, method: "eth_gasPrice", params: [])
+
+    /// Sends `request` and returns the response with the time it took, in seconds
+    func send(_ pool: Web3ProviderPool, request: BasicRPCRequest? = nil) -> (Web3Response<EthereumQuantity>, TimeInterval) {
+        let expectation = expectation(description: "response")
+        var result: Web3Response<EthereumQuantity>!
+        let start = Date()
+        pool.send(request: request ?? self.request) { (resp: Web3Response<EthereumQuantity>) in
+            result = resp
+            expectation.fulfill()
+        }
+        wait(for: [expectation], timeout: 5)
+        return (result, Date().timeIntervalSince(start))
+    }
+
+    func testPrefersFastestEndpoint() {
+        let slow = StubProvider(delay: 0.05), fast = StubProvider(delay: 0.005)
+        let pool = Web3ProviderPool(endpoints: [.init(name: "slow", provider: slow), .init(name: "fast", provider: fast)])
+
+        for _ in 0..<20 {
+            XCTAssertEqual(send(pool).0.result?.quantity, 1)
+        }
+        XCTAssertEqual(pool.ranked.first?.name, "fast")
+        // Once measured, the slow endpoint is only hit by hedges
+        XCTAssertLessThan(slow.calls, 10)
+    }
+
+    func testHedgesStalledEndpoint() {
+        let stalled = StubProvider(delay: 2), backup = StubProvider(delay: 0.005)
+        let pool = Web3ProviderPool(endpoints: [.init(name: "stalled", provider: stalled), .init(name: "backup", provider: backup)])
+        pool.maximumHedgeDelay = .milliseconds(50)
+
+        // Both are unmeasured, the first configured one is tried first
+        let (response, elapsed) = send(pool)
+        XCTAssertEqual(response.result?.quantity, 1)
+        XCTAssertLessThan(elapsed, 0.5)
+        XCTAssertEqual(stalled.calls, 1)
+        XCTAssertEqual(backup.calls, 1)
+    }
+
+    func testFailsOverImmediately() {
+        let failing = StubProvider(delay: 0, fails: true), backup = StubProvider(delay: 0.005)
+        let pool = Web3ProviderPool(endpoints: [.init(name: "failing", provider: failing), .init(name: "backup", provider: backup)])
+
+        let (response, elapsed) = send(pool)
+        XCTAssertEqual(response.result?.quantity, 1)
+        XCTAssertLessThan(elapsed, 0.25, "Shouldn't wait for the hedge delay")
+        XCTAssertEqual(pool.ranked.first?.name, "backup")
+        XCTAssertEqual(pool.stats.first { $0.name == "failing" }?.failures, 1)
+    }
+
+    func testTransactionsAreNotHedged() {
+        let stalled = StubProvider(delay: 0.1), backup = StubProvider(delay: 0.005)
+        let pool = Web3ProviderPool(endpoints: [.init(name: "stalled", provider: stalled), .init(name: "backup", provider: backup)])
+        pool.maximumHedgeDelay = .milliseconds(10)
+
+        let transaction = BasicRPCRequest(id: 1, jsonrpc: Web3.jsonrpc, method: "eth_sendRawTransaction", params: [])
+        _ = send(pool, request: transaction)
+        XCTAssertEqual(stalled.calls + backup.calls, 1)
+    }
+}
@@ -0,0 +1,70 @@
+//
+//  RealtimeTopicsTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Messages received by the stub `uws_publish`
+private var published = [(topic: String, message: String)]()
+
+final class RealtimeTopicsTests: XCTestCase {
+    let subscription = PriceDataActiveSubscription(
+        exchangeKey: "uniswap",
+        environment: .production,
+        pair: PairInfo(tokenA: Token(name: "WBNB", address: try! EthereumAddress(hex: "0xbb4CdB9CBd36B01bD1cBaEBF2De08d9173bc095c", eip55: false)),
+                       tokenB: Token(name: "BUSD", address: try! EthereumAddress(hex: "0xe9e7CEA3DedcA5984780Bafc599bD69ADd087D56", eip55: false)))
+    )
+
+    override func setUp() {
+        published.removeAll()
+        RealtimeTopics.register(publish: { topic, topicLength, message, length, _ in
+            let topic = String(decoding: UnsafeRawBufferPointer(start: topic, count: topicLength), as: UTF8.self)
+            let message = String(decoding: UnsafeRawBufferPointer(start: message, count: length), as: UTF8.self)
+            published.append((topic, message))
+        }, subscribe: { _, _, _, _ in })
+    }
+
+    override func tearDown() {
+        // Later tests must not publish to the stubs
+        RealtimeTopics.unregister()
+        XCTAssertFalse(RealtimeTopics.isAvailable)
+    }
+
+    func testPriceTopic() {
+        XCTAssertEqual(RealtimeTopics.price(subscription),
+                       "price/production/uniswap/0xbb4cdb9cbd36b01bd1cbaebf2de08d9173bc095c/0xe9e7cea3dedca5984780bafc599bd69add087d56")
+
+        // Silent subscriptions share the topic of the pair
+        var silent = subscription
+        silent.silent = true
+        XCTAssertEqual(RealtimeTopics.price(silent), RealtimeTopics.price(subscription))
+    }
+
+    func testStateKeepsTopicsOfActiveSubscriptions() {
+        let state = PriceDataSubscriptionState()
+        state.activeSubscriptions = [subscription]
+        XCTAssertEqual(state.topics[subscription.hashValue], RealtimeTopics.price(subscription))
+
+        state.activeSubscriptions.removeAll()
+        XCTAssertTrue(state.topics.isEmpty)
+    }
+
+    func testPublishEncodesOnce() throws {
+        RealtimeTopics.connect(binary: false)
+        defer { RealtimeTopics.disconnect(binary: false) }
+        let response = BotResponse(status: .success, topic: .decision)
+        RealtimeTopics.publish(response, to: RealtimeTopics.decision)
+
+        XCTAssertEqual(published.count, 1)
+        XCTAssertEqual(published.first?.topic, "decision")
+        XCTAssertEqual(published.first?.message, try response.toJSON())
+    }
+}
@@ -0,0 +1,100 @@
+//
+//  ReceiptTrackerTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Stand-in node answering receipts for the transactions in `mined`, `null` for the others, after `delay`.
+final class ReceiptNode: Web3Provider {
+    static let event = "0x" + String(repeating: "ab", count: 32)
+
+    var mined = Set<String>()
+    var delay: TimeInterval = 0
+
+    func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>) {
+        let hash = (try? JSONEncoder().encode(request.params)).flatMap { String(data: $0, encoding: .utf8) }?
+            .trimmingCharacters(in: CharacterSet(charactersIn: "[]\"")) ?? ""
+        let result = mined.contains(hash) ? """
+        {"transactionHash":"\(hash)","transactionIndex":"0x0","blockHash":"0x\(String(repeating: "00", count: 32))",
+         "blockNumber":"0x10","cumulativeGasUsed":"0x30d40","gasUsed":"0x186a0","contractAddress":null,
+         "logs":[{"address":"0x\(String(repeating: "11", count: 20))","data":"0x\(String(repeating: "00", count: 24))0de0b6b3a7640000",
+                  "topics":["\(Self.event)"]}],
+         "logsBloom":"0x00","root":null,"status":"0x1"}
+        """ : "null"
+        let json = #"{"jsonrpc":"2.0","id":1,"result":\#(result)}"#
+        let decoded = try! JSONDecoder().decode(RPCResponse<Result>.self, from: Data(json.utf8))
+        guard delay > 0 else {
+            return response(Web3Response(rpcResponse: decoded))
+        }
+        DispatchQueue.global().asyncAfter(deadline: .now() + delay) {
+            response(Web3Response(rpcResponse: decoded))
+        }
+    }
+}
+
+final class ReceiptTrackerTests: XCTestCase {
+    func pending(_ hash: String) -> ReceiptTracker.Pending {
+        var response = BotResponse(status: .success, topic: .decision)
+        response.executedTrade = Trade(timestamp: .now, token: "WBNB", startAmount: 1, route: [], profit: 0.1)
+        return .init(hash: try! EthereumData(ethereumValue: hash),
+                     response: response,
+                     gasPrice: EthereumQuantity(quantity: 5.gwei),
+                     event: try! EthereumData(ethereumValue: ReceiptNode.event),
+                     environment: .development)
+    }
+
+    func testPublishesMinedTransactions() async {
+        let node = ReceiptNode()
+        var published = [BotResponse]()
+        let tracker = ReceiptTracker(web3: { _ in Web3(provider: node) }, publish: { published.append($0) })
+
+        let first = "0x" + String(repeating: "01", count: 32), second = "0x" + String(repeating: "02", count: 32)
+        await tracker.track(pending(first))
+        await tracker.track(pending(second))
+
+        node.mined = [first]
+        await tracker.onHead(block: 1)
+        await tracker.onHead(block: 1) // Same head from another store
+        XCTAssertEqual(published.count, 1)
+        XCTAssertEqual(published.first?.executedTrade?.txHash, first)
+        XCTAssertEqual(published.first?.executedTrade?.profit, 1)
+        XCTAssertEqual(published.first?.executedTrade?.fees ?? 0, 0.0005, accuracy: 1e-12)
+        let remaining = await tracker.count
+        XCTAssertEqual(remaining, 1)
+
+        node.mined.insert(second)
+        await tracker.onHead(block: 2)
+        XCTAssertEqual(published.count, 2)
+        let done = await tracker.count
+        XCTAssertEqual(done, 0)
+    }
+
+    func testOverlappingHeadsPublishOnce() async {
+        let node = ReceiptNode()
+        node.delay = 0.05
+        var published = [BotResponse]()
+        let tracker = ReceiptTracker(web3: { _ in Web3(provider: node) }, publish: { published.append($0) })
+
+        let hash = "0x" + String(repeating: "03", count: 32)
+        await tracker.track(pending(hash))
+        node.mined = [hash]
+
+        // The next head arrives while the receipts of the previous one are still being fetched
+        async let first: Void = tracker.onHead(block: 1)
+        try? await Task.sleep(nanoseconds: 10_000_000)
+        async let second: Void = tracker.onHead(block: 2)
+        _ = await (first, second)
+
+        XCTAssertEqual(published.count, 1)
+        let remaining = await tracker.count
+        XCTAssertEqual(remaining, 0)
+    }
+}
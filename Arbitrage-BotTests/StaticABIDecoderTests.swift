@@ -0,0 +1,72 @@
+//
+//  StaticABIDecoderTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import BigInt
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class StaticABIDecoderTests: XCTestCase {
+    /// `getReserves()` result: 250 ETH, 5_000_000 USDT (6 decimals), timestamp
+    let hex = "0x00000000000000000000000000000000000000000000000d8d726b7177a80000" +
+              "0000000000000000000000000000000000000000000000000000048c27395000" +
+              "000000000000000000000000000000000000000000000000000000006530d6e1"
+
+    var bytes: Bytes {
+        Array<UInt8>(hex: hex)
+    }
+
+    func testDecodeReserves() throws {
+        let reserves = try StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: bytes)
+
+        XCTAssertEqual(reserves.reserve0.biguint, BigUInt("250000000000000000000"))
+        XCTAssertEqual(reserves.reserve1.biguint, BigUInt("5000000000000"))
+        XCTAssertEqual(reserves.blockTimestampLast, 0x6530d6e1)
+        XCTAssertEqual(reserves.reserve0.euler, BigUInt("250000000000000000000")!.euler)
+    }
+
+    func testRejectsInvalidInput() {
+        XCTAssertThrowsError(try StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: Array(bytes[0..<64])))
+
+        // reserve0 doesn't fit in an uint112
+        var overflow = bytes
+        overflow[0] = 1
+        XCTAssertThrowsError(try StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: overflow))
+    }
+
+    // MARK: - Benchmarks
+
+    func testABIDecoderPerformance() {
+        let outputs = [
+            SolidityFunctionParameter(name: "reserve0", type: .uint256),
+            SolidityFunctionParameter(name: "reserve1", type: .uint256),
+            SolidityFunctionParameter(name: "blockTimestampLast", type: .uint32)
+        ]
+        let hex = self.hex
+        measure {
+            for _ in 0..<10_000 {
+                let decoded = try? ABIDecoder.decodeTuple(outputs: outputs, from: hex)
+                _ = (decoded?["reserve0"] as? BigUInt)?.euler
+                _ = (decoded?["reserve1"] as? BigUInt)?.euler
+            }
+        }
+    }
+
+    func testStaticABIDecoderPerformance() {
+        let bytes = self.bytes
+        measure {
+            for _ in 0..<10_000 {
+                let decoded = try? StaticABIDecoder.decode(UniswapV2Pair.Reserves.self, from: bytes)
+                _ = decoded?.reserve0.euler
+                _ = decoded?.reserve1.euler
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+//
+//  SyncLogListenerTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Stand-in node for `logs` subscriptions, which can refuse them, cancel them like a reconnect, and push logs.
+private final class LogSubscriptionNode: Web3Provider, Web3RawSubscriptionProvider {
+    var fails = false
+    var subscriptions = 0
+    var cancel: (() -> Void)?
+    var notify: ((String) -> Void)?
+
+    func send<Params, Result>(request: RPCRequest<Params>, response: @escaping Web3ResponseCompletion<Result>) {
+        response(Web3Response(error: .connectionFailed(nil)))
+    }
+
+    func subscribe<Params>(request: RPCRequest<Params>, response: @escaping Web3.Web3ResponseCompletion<String>, onCancel: @escaping () -> Void, onNotification: @escaping (_ notification: String) -> Void) {
+        subscriptions += 1
+        guard !fails else {
+            response(Web3Response(error: .connectionFailed(nil)))
+            return
+        }
+        response(Web3Response(status: .success("0x\(subscriptions)")))
+        cancel = onCancel
+        notify = onNotification
+    }
+
+    func sync(_ pair: EthereumAddress, block: UInt64, index: UInt64, reserve0: UInt64) {
+        let word = { (value: UInt64) in String(repeating: "0", count: 48) + String(format: "%016llx", value) }
+        notify?("""
+        {"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x\(subscriptions)","result":{"address":"\(pair.hex(eip55: false))","topics":["\(SyncLogListener.syncTopic.hex())"],"data":"0x\(word(reserve0))\(word(1))","blockNumber":"0x\(String(block, radix: 16))","logIndex":"0x\(String(index, radix: 16))","removed":false}}}
+        """)
+    }
+}
+
+final class SyncLogListenerTests: XCTestCase {
+    private let node = LogSubscriptionNode()
+    let pair = try! EthereumAddress(hex: "0x00000000000000000000000000000000000000aa", eip55: false)
+    let key = PairAddressIndex.Key(factory: .init(1), tokenA: .init(2), tokenB: .init(3))
+
+    override func setUp() {
+        PairAddressIndex.shared[key.factory, key.token0, key.token1] = pair
+    }
+
+    /// Subscribed listener, past the full fetch following the subscription
+    func listener() -> SyncLogListener {
+        let listener = SyncLogListener(web3: Web3(provider: node))
+        XCTAssertTrue(listener.track(pairs: [pair]))
+        XCTAssertNil(listener.drain())
+        return listener
+    }
+
+    func testFailedSubscriptionFallsBackToFullFetches() {
+        node.fails = true
+        let listener = SyncLogListener(web3: Web3(provider: node))
+        XCTAssertTrue(listener.track(pairs: [pair]))
+        XCTAssertNil(listener.drain())
+        XCTAssertNil(listener.drain())
+
+        // Subscribes again on the next block
+        node.fails = false
+        XCTAssertTrue(listener.track(pairs: [pair]))
+        XCTAssertEqual(node.subscriptions, 2)
+        XCTAssertNil(listener.drain())
+        XCTAssertEqual(listener.drain()?.count, 0)
+        XCTAssertFalse(listener.track(pairs: [pair]))
+    }
+
+    func testReconnectResubscribes() {
+        let listener = listener()
+        XCTAssertEqual(listener.drain()?.count, 0)
+
+        node.cancel?()
+        XCTAssertNil(listener.drain())
+        XCTAssertTrue(listener.track(pairs: [pair]))
+        XCTAssertEqual(node.subscriptions, 2)
+    }
+
+    func testLogsAreKeyedByBlock() throws {
+        let listener = listener()
+        node.sync(pair, block: 11, index: 0, reserve0: 3)
+        node.sync(pair, block: 10, index: 5, reserve0: 2)
+        node.sync(pair, block: 10, index: 1, reserve0: 1)
+
+        // Block 11 was received first, but isn't dispatched with block 10
+        XCTAssertEqual(try XCTUnwrap(listener.drain(through: 10))[key]?.0, UInt256(2))
+        XCTAssertEqual(try XCTUnwrap(listener.drain(through: 11))[key]?.0, UInt256(3))
+
+        // A late log never replaces a newer one
+        node.sync(pair, block: 10, index: 9, reserve0: 4)
+        XCTAssertEqual(listener.drain(through: 11)?.count, 0)
+    }
+}
@@ -0,0 +1,97 @@
+//
+//  TransactionTemplateTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+import BigInt
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+final class TransactionTemplateTests: XCTestCase {
+    let key = try! EthereumPrivateKey(hexPrivateKey: "0x4c0883a69102937d6231471b5dbb6204fe5129617082792ae468d01a3f362318")
+    let contract = Web3(provider: StubProvider(delay: 0)).eth.Contract(type: SwapRouteCoordinator.self)
+
+    func route(_ count: Int) -> [Step] {
+        (0..<count).map { i in
+            Step(intermediary: try! EthereumAddress(rawAddress: Bytes(repeating: UInt8(0x10 + i), count: 20)),
+                 token: try! EthereumAddress(rawAddress: Bytes(repeating: UInt8(0x40 + i), count: 20)),
+                 tokenName: "TK\(i)",
+                 data: try! EthereumAddress(rawAddress: Bytes(repeating: UInt8(0x70 + i), count: 20)),
+                 exchangeName: "uniswap")
+        }
+    }
+
+    /// Same transaction, through `SolidityInvocation`, `EthereumTransaction` and `RLPEncoder`
+    func reference(startAmount: BigUInt, steps: [Step], nonce: EthereumQuantity, gasPrice: EthereumQuantity) throws -> Bytes {
+        let invocation = contract.startArbitrage(startAmount: startAmount, lapExchange: steps[0].intermediary, steps: steps)
+        let tx = invocation.createTransaction(nonce: nonce,
+                                              gasPrice: gasPrice,
+                                              maxFeePerGas: nil,
+                                              maxPriorityFeePerGas: nil,
+                                              gasLimit: 1000000,
+                                              from: key.address,
+                                              value: 0,
+                                              accessList: .init(),
+                                              transactionType: .legacy)
+        return try XCTUnwrap(tx).sign(with: key, chainId: 97).rawTransaction().bytes
+    }
+
+    func testMatchesGenericEncoder() throws {
+        for count in [2, 3, 5] {
+            let steps = route(count)
+            let template = StartArbitrageTemplate.shared(steps: count)
+            // Small and large values, to cover single-byte and multi-byte RLP integers
+            for (amount, nonce, gasPrice) in [(BigUInt(1), BigUInt(0), BigUInt(5)), (BigUInt(10).power(24) + 7, BigUInt(300), 3.gwei)] {
+                let raw = try template.signedTransaction(startAmount: amount,
+                                                         lapExchange: steps[0].intermediary,
+                                                         steps: steps,
+                                                         to: try XCTUnwrap(contract.address),
+                                                         nonce: EthereumQuantity(quantity: nonce),
+                                                         gasPrice: EthereumQuantity(quantity: gasPrice),
+                                                         gasLimit: 1000000,
+                                                         chainId: 97,
+                                                         key: key)
+                let expected = try reference(startAmount: amount, steps: steps,
+                                             nonce: EthereumQuantity(quantity: nonce), gasPrice: EthereumQuantity(quantity: gasPrice))
+                XCTAssertEqual(raw, expected, "\(count) steps, nonce \(nonce)")
+            }
+        }
+    }
+
+    // MARK: - Benchmarks
+
+    func testTemplatePerformance() throws {
+        let steps = route(3)
+        let template = StartArbitrageTemplate.shared(steps: 3)
+        let to = try XCTUnwrap(contract.address)
+        measure {
+            for nonce in 0..<1_000 {
+                _ = try? template.signedTransaction(startAmount: BigUInt(10).power(18),
+                                                    lapExchange: steps[0].intermediary,
+                                                    steps: steps,
+                                                    to: to,
+                                                    nonce: EthereumQuantity(quantity: BigUInt(nonce)),
+                                                    gasPrice: EthereumQuantity(quantity: 3.gwei),
+                                                    gasLimit: 1000000,
+                                                    chainId: 97,
+                                                    key: key)
+            }
+        }
+    }
+
+    func testGenericEncoderPerformance() throws {
+        let steps = route(3)
+        measure {
+            for nonce in 0..<1_000 {
+                _ = try? reference(startAmount: BigUInt(10).power(18), steps: steps,
+                                   nonce: EthereumQuantity(quantity: BigUInt(nonce)), gasPrice: EthereumQuantity(quantity: 3.gwei))
+            }
+        }
+    }
+}
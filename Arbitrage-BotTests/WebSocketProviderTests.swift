@@ -0,0 +1,138 @@
+//
+//  WebSocketProviderTests.swift
+//  Arbitrage-BotTests
+//
+//  Created by Arthur Guiot on 19/10/2026.
+//
+
+import XCTest
+
+@testable import Arbitrage_Bot
+#if canImport(Aggregator)
+@testable import Aggregator
+#endif
+
+/// Socket standing in for the node: keeps the frames the provider sends, and answers them on demand.
+private final class StubSocket {
+    private let lock = NSLock()
+    private var frames = [String]()
+
+    func append(_ frame: String) {
+        lock.lock()
+        frames.append(frame)
+        lock.unlock()
+    }
+
+    /// Ids the provider gave to the requests of the last frame
+    var lastIds: [Int] {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let data = frames.last?.data(using: .utf8),
+              let requests = try? JSONSerialization.jsonObject(with: data) as? [[String: Any]] else { return [] }
+        return requests.compactMap { $0["id"] as? Int }
+    }
+
+    static func batch(_ results: [(id: Int, result: String)]) -> String {
+        "[" + results.map { "{\"jsonrpc\":\"2.0\",\"id\":\($0.id),\"result\":\"\($0.result)\"}" }.joined(separator: ",") + "]"
+    }
+}
+
+final class WebSocketProviderTests: XCTestCase {
+    private let socket = StubSocket()
+    private var provider: Web3WebSocketProvider!
+
+    override func setUp() {
+        let socket = socket
+        provider = Web3WebSocketProvider(stubSocket: { socket.append($0) }, timeout: .milliseconds(200))
+    }
+
+    let requests = (0..<3).map { BasicRPCRequest(id: 100 + $0, jsonrpc: Web3.jsonrpc, method: "eth_chainId", params: []) }
+
+    /// Sends the batch and answers it with `answer`, returning every call of the completion
+    func sendBatch(answer: (_ ids: [Int]) -> String?, timeout: TimeInterval = 1) -> [[Web3Response<String>]] {
+        let lock = NSLock()
+        var calls = [[Web3Response<String>]]()
+        let expectation = self.expectation(description: "Batch answered")
+        provider.send(batch: requests) { (responses: [Web3Response<String>]) in
+            lock.lock()
+            calls.append(responses)
+            lock.unlock()
+            expectation.fulfill()
+        }
+        if let frame = answer(socket.lastIds) {
+            provider.receive(frame)
+        }
+        wait(for: [expectation], timeout: timeout)
+        lock.lock()
+        defer { lock.unlock() }
+        return calls
+    }
+
+    func testBatchAnsweredOutOfOrder() throws {
+        let calls = sendBatch { ids in
+            XCTAssertEqual(ids.count, 3)
+            XCTAssertEqual(Set(ids).count, 3, "Ids are remapped to unique ones")
+            return StubSocket.batch(ids.enumerated().reversed().map { (id: $1, result: "0x\($0)") })
+        }
+        let responses = try XCTUnwrap(calls.first)
+        XCTAssertEqual(responses.map(\.result), ["0x0", "0x1", "0x2"])
+    }
+
+    func testMissingIdIsEmptyResponse() throws {
+        let calls = sendBatch { ids in
+            StubSocket.batch([(ids[2], "0x2"), (ids[0], "0x0")])
+        }
+        let responses = try XCTUnwrap(calls.first)
+        XCTAssertEqual(responses[0].result, "0x0")
+        XCTAssertEqual(responses[2].result, "0x2")
+        guard case .emptyResponse? = responses[1].error as? Web3Response<String>.Error else {
+            return XCTFail("Expected an empty response, got \(String(describing: responses[1].error))")
+        }
+    }
+
+    func testLateResponseAfterTimeoutIsIgnored() throws {
+        // Not answered before the timeout
+        let calls = sendBatch(answer: { _ in nil })
+        XCTAssertEqual(calls.count, 1)
+        guard case .serverError(let error)? = calls.first?.first?.error as? Web3Response<String>.Error,
+              case .timeoutError? = error as? Web3WebSocketProvider.Error else {
+            return XCTFail("Expected a timeout")
+        }
+
+        // The late answer finds nothing pending: no second call (the expectation would be over fulfilled)
+        provider.receive(StubSocket.batch(socket.lastIds.map { (id: $0, result: "0x1") }))
+        let settled = self.expectation(description: "Late answer processed")
+        settled.isInverted = true
+        wait(for: [settled], timeout: 0.3)
+    }
+
+    func testShardedDictionaryConcurrentAccess() {
+        let dictionary = ShardedDictionary<Int, Int>(shardCount: 4)
+        DispatchQueue.concurrentPerform(iterations: 8) { thread in
+            for i in 0..<10_000 {
+                let key = thread * 10_000 + i
+                dictionary[key] = i
+                XCTAssertEqual(dictionary[key], i)
+                if i % 2 == 1 {
+                    XCTAssertEqual(dictionary.removeValue(forKey: key), i)
+                }
+            }
+        }
+        XCTAssertEqual(dictionary.count, 8 * 5_000)
+
+        // Only one of the concurrent removals gets the value
+        dictionary[-1] = 42
+        let lock = NSLock()
+        var winners = 0
+        DispatchQueue.concurrentPerform(iterations: 16) { _ in
+            if dictionary.removeValue(forKey: -1) != nil {
+                lock.lock()
+                winners += 1
+                lock.unlock()
+            }
+        }
+        XCTAssertEqual(winners, 1)
+        XCTAssertEqual(dictionary.removeAll().count, 8 * 5_000)
+        XCTAssertEqual(dictionary.count, 0)
+    }
+}
@@ -9,6 +9,12 @@ import Foundation
 import XCTest
 
 extension XCTestCase {
+    /// Node used by the tests: `MOCK_NODE_URL`, then `TESTNET_JSON_RPC_URL`, then a `yarn mock-node` on its default port.
+    var jsonRPCURL: String {
+        let environment = ProcessInfo.processInfo.environment
+        return environment["MOCK_NODE_URL"] ?? environment["TESTNET_JSON_RPC_URL"] ?? "ws://localhost:8546"
+    }
+
     func measureAsync(callback: @escaping () async -> Void) {
         self.measure {
             let sema = DispatchSemaphore(value: 0)
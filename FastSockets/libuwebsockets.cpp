@@ -25,6 +25,136 @@
 #include "App.h"
 #include "ClientApp.h"
 #include <optional>
+#include <cstddef>
+#include <cstring>
+
+/* Sockets are only ever accessed as WebSocket<SSL, true, void *> below: the user data type only decides the size of
+ * the socket extension (and the type of the handlers), not the layout of the socket nor of its context. */
+template <bool SSL, typename UserData>
+static void uws_ws_register(uWS::TemplatedApp<SSL> *app, const char *pattern, uws_socket_behavior_t behavior, void *user_data)
+{
+    auto generic_handler = typename uWS::TemplatedApp<SSL>::template WebSocketBehavior<UserData>{
+        .compression = (uWS::CompressOptions)(uint64_t)behavior.compression,
+        .maxPayloadLength = behavior.maxPayloadLength,
+        .idleTimeout = behavior.idleTimeout,
+        .maxBackpressure = behavior.maxBackpressure,
+        .closeOnBackpressureLimit = behavior.closeOnBackpressureLimit,
+        .resetIdleTimeoutOnSend = behavior.resetIdleTimeoutOnSend,
+        .sendPingsAutomatically = behavior.sendPingsAutomatically,
+        .maxLifetime = behavior.maxLifetime,
+    };
+    
+    if (behavior.upgrade)
+        generic_handler.upgrade = [behavior, user_data](auto *res, auto *req, auto *context)
+    {
+        behavior.upgrade((uws_res_t *)res, (uws_req_t *)req, (uws_socket_context_t *)context, user_data);
+    };
+    if (behavior.open)
+        generic_handler.open = [behavior, user_data](auto *ws)
+    {
+        behavior.open((uws_websocket_t *)ws, user_data);
+    };
+    if (behavior.message)
+        generic_handler.message = [behavior, user_data](auto *ws, auto message, auto opcode)
+    {
+        behavior.message((uws_websocket_t *)ws, message.data(), message.length(), (uws_opcode_t)opcode, user_data);
+    };
+    if (behavior.drain)
+        generic_handler.drain = [behavior, user_data](auto *ws)
+    {
+        behavior.drain((uws_websocket_t *)ws, user_data);
+    };
+    if (behavior.ping)
+        generic_handler.ping = [behavior, user_data](auto *ws, auto message)
+    {
+        behavior.ping((uws_websocket_t *)ws, message.data(), message.length(), user_data);
+    };
+    if (behavior.pong)
+        generic_handler.pong = [behavior, user_data](auto *ws, auto message)
+    {
+        behavior.pong((uws_websocket_t *)ws, message.data(), message.length(), user_data);
+    };
+    if (behavior.close)
+        generic_handler.close = [behavior, user_data](auto *ws, int code, auto message)
+    {
+        behavior.close((uws_websocket_t *)ws, code, message.data(), message.length(), user_data);
+    };
+    if (behavior.subscription)
+        generic_handler.subscription = [behavior, user_data](auto *ws, auto topic, int subscribers, int old_subscribers)
+    {
+        behavior.subscription((uws_websocket_t *)ws, topic.data(), topic.length(), subscribers, old_subscribers, user_data);
+    };
+    app->template ws<UserData>(pattern, std::move(generic_handler));
+}
+
+/* Inline user data: a fixed size block stored in the socket extension, instead of a pointer to a heap allocation.
+ * Sizes are rounded up to a few classes, so that uws_ws_inline and uws_res_upgrade_inline agree on the type. */
+template <size_t N>
+struct InlineStorage
+{
+    alignas(std::max_align_t) unsigned char bytes[N];
+};
+
+template <bool SSL, size_t N>
+static void uws_res_upgrade_storage(uws_res_t *res, const void *data, size_t user_data_size, std::string_view key, std::string_view protocol, std::string_view extensions, uws_socket_context_t *context)
+{
+    InlineStorage<N> storage = {};
+    if (data)
+    {
+        memcpy(storage.bytes, data, user_data_size);
+    }
+    ((uWS::HttpResponse<SSL> *)res)->template upgrade<InlineStorage<N>>(std::move(storage), key, protocol, extensions, (struct us_socket_context_t *)context);
+}
+
+/* Calls `F<N>` with the size class of `user_data_size`, false if it's larger than UWS_INLINE_USER_DATA_MAX */
+template <template <size_t> typename F, typename... Args>
+static bool uws_inline_size_class(size_t user_data_size, Args &&...args)
+{
+    if (user_data_size <= 32)
+        F<32>::call(std::forward<Args>(args)...);
+    else if (user_data_size <= 64)
+        F<64>::call(std::forward<Args>(args)...);
+    else if (user_data_size <= 128)
+        F<128>::call(std::forward<Args>(args)...);
+    else if (user_data_size <= UWS_INLINE_USER_DATA_MAX)
+        F<UWS_INLINE_USER_DATA_MAX>::call(std::forward<Args>(args)...);
+    else
+        return false;
+    return true;
+}
+
+template <size_t N>
+struct uws_ws_inline_register
+{
+    static void call(int ssl, uws_app_t *app, const char *pattern, uws_socket_behavior_t behavior, void *user_data)
+    {
+        if (ssl)
+        {
+            uws_ws_register<true, InlineStorage<N>>((uWS::SSLApp *)app, pattern, behavior, user_data);
+        }
+        else
+        {
+            uws_ws_register<false, InlineStorage<N>>((uWS::App *)app, pattern, behavior, user_data);
+        }
+    }
+};
+
+template <size_t N>
+struct uws_res_inline_upgrade
+{
+    static void call(int ssl, uws_res_t *res, const void *data, size_t user_data_size, std::string_view key, std::string_view protocol, std::string_view extensions, uws_socket_context_t *context)
+    {
+        if (ssl)
+        {
+            uws_res_upgrade_storage<true, N>(res, data, user_data_size, key, protocol, extensions, context);
+        }
+        else
+        {
+            uws_res_upgrade_storage<false, N>(res, data, user_data_size, key, protocol, extensions, context);
+        }
+    }
+};
+
 extern "C"
 {
 
@@ -552,117 +682,37 @@ void uws_ws(int ssl, uws_app_t *app, const char *pattern, uws_socket_behavior_t
 {
     if (ssl)
     {
-        auto generic_handler = uWS::SSLApp::WebSocketBehavior<void *>{
-            .compression = (uWS::CompressOptions)(uint64_t)behavior.compression,
-            .maxPayloadLength = behavior.maxPayloadLength,
-            .idleTimeout = behavior.idleTimeout,
-            .maxBackpressure = behavior.maxBackpressure,
-            .closeOnBackpressureLimit = behavior.closeOnBackpressureLimit,
-            .resetIdleTimeoutOnSend = behavior.resetIdleTimeoutOnSend,
-            .sendPingsAutomatically = behavior.sendPingsAutomatically,
-            .maxLifetime = behavior.maxLifetime,
-        };
-        
-        if (behavior.upgrade)
-            generic_handler.upgrade = [behavior, user_data](auto *res, auto *req, auto *context)
-        {
-            behavior.upgrade((uws_res_t *)res, (uws_req_t *)req, (uws_socket_context_t *)context, user_data);
-        };
-        if (behavior.open)
-            generic_handler.open = [behavior, user_data](auto *ws)
-        {
-            behavior.open((uws_websocket_t *)ws, user_data);
-        };
-        if (behavior.message)
-            generic_handler.message = [behavior, user_data](auto *ws, auto message, auto opcode)
-        {
-            behavior.message((uws_websocket_t *)ws, message.data(), message.length(), (uws_opcode_t)opcode, user_data);
-        };
-        if (behavior.drain)
-            generic_handler.drain = [behavior, user_data](auto *ws)
-        {
-            behavior.drain((uws_websocket_t *)ws, user_data);
-        };
-        if (behavior.ping)
-            generic_handler.ping = [behavior, user_data](auto *ws, auto message)
-        {
-            behavior.ping((uws_websocket_t *)ws, message.data(), message.length(), user_data);
-        };
-        if (behavior.pong)
-            generic_handler.pong = [behavior, user_data](auto *ws, auto message)
-        {
-            behavior.pong((uws_websocket_t *)ws, message.data(), message.length(), user_data);
-        };
-        if (behavior.close)
-            generic_handler.close = [behavior, user_data](auto *ws, int code, auto message)
-        {
-            behavior.close((uws_websocket_t *)ws, code, message.data(), message.length(), user_data);
-        };
-        if (behavior.subscription)
-            generic_handler.subscription = [behavior, user_data](auto *ws, auto topic, int subscribers, int old_subscribers)
-        {
-            behavior.subscription((uws_websocket_t *)ws, topic.data(), topic.length(), subscribers, old_subscribers, user_data);
-        };
-        uWS::SSLApp *uwsApp = (uWS::SSLApp *)app;
-        
-        uwsApp->ws<void *>(pattern, std::move(generic_handler));
+        uws_ws_register<true, void *>((uWS::SSLApp *)app, pattern, behavior, user_data);
     }
     else
     {
-        auto generic_handler = uWS::App::WebSocketBehavior<void *>{
-            .compression = (uWS::CompressOptions)(uint64_t)behavior.compression,
-            .maxPayloadLength = behavior.maxPayloadLength,
-            .idleTimeout = behavior.idleTimeout,
-            .maxBackpressure = behavior.maxBackpressure,
-            .closeOnBackpressureLimit = behavior.closeOnBackpressureLimit,
-            .resetIdleTimeoutOnSend = behavior.resetIdleTimeoutOnSend,
-            .sendPingsAutomatically = behavior.sendPingsAutomatically,
-            .maxLifetime = behavior.maxLifetime,
-        };
-        
-        if (behavior.upgrade)
-            generic_handler.upgrade = [behavior, user_data](auto *res, auto *req, auto *context)
-        {
-            behavior.upgrade((uws_res_t *)res, (uws_req_t *)req, (uws_socket_context_t *)context, user_data);
-        };
-        if (behavior.open)
-            generic_handler.open = [behavior, user_data](auto *ws)
-        {
-            behavior.open((uws_websocket_t *)ws, user_data);
-        };
-        if (behavior.message)
-            generic_handler.message = [behavior, user_data](auto *ws, auto message, auto opcode)
-        {
-            behavior.message((uws_websocket_t *)ws, message.data(), message.length(), (uws_opcode_t)opcode, user_data);
-        };
-        if (behavior.drain)
-            generic_handler.drain = [behavior, user_data](auto *ws)
-        {
-            behavior.drain((uws_websocket_t *)ws, user_data);
-        };
-        if (behavior.ping)
-            generic_handler.ping = [behavior, user_data](auto *ws, auto message)
-        {
-            behavior.ping((uws_websocket_t *)ws, message.data(), message.length(), user_data);
-        };
-        if (behavior.pong)
-            generic_handler.pong = [behavior, user_data](auto *ws, auto message)
-        {
-            behavior.pong((uws_websocket_t *)ws, message.data(), message.length(), user_data);
-        };
-        if (behavior.close)
-            generic_handler.close = [behavior, user_data](auto *ws, int code, auto message)
-        {
-            behavior.close((uws_websocket_t *)ws, code, message.data(), message.length(), user_data);
-        };
-        if (behavior.subscription)
-            generic_handler.subscription = [behavior, user_data](auto *ws, auto topic, int subscribers, int old_subscribers)
-        {
-            behavior.subscription((uws_websocket_t *)ws, topic.data(), topic.length(), subscribers, old_subscribers, user_data);
-        };
-        uWS::App *uwsApp = (uWS::App *)app;
-        uwsApp->ws<void *>(pattern, std::move(generic_handler));
+        uws_ws_register<false, void *>((uWS::App *)app, pattern, behavior, user_data);
+    }
+}
+
+bool uws_ws_inline(int ssl, uws_app_t *app, const char *pattern, uws_socket_behavior_t behavior, size_t user_data_size, void *user_data)
+{
+    return uws_inline_size_class<uws_ws_inline_register>(user_data_size, ssl, app, pattern, behavior, user_data);
+}
+
+bool uws_res_upgrade_inline(int ssl, uws_res_t *res, const void *data, size_t user_data_size, const char *sec_web_socket_key, size_t sec_web_socket_key_length, const char *sec_web_socket_protocol, size_t sec_web_socket_protocol_length, const char *sec_web_socket_extensions, size_t sec_web_socket_extensions_length, uws_socket_context_t *ws)
+{
+    return uws_inline_size_class<uws_res_inline_upgrade>(user_data_size, ssl, res, data, user_data_size,
+                                                         std::string_view(sec_web_socket_key, sec_web_socket_key_length),
+                                                         std::string_view(sec_web_socket_protocol, sec_web_socket_protocol_length),
+                                                         std::string_view(sec_web_socket_extensions, sec_web_socket_extensions_length),
+                                                         ws);
+}
+
+void *uws_ws_get_inline_user_data(int ssl, uws_websocket_t *ws)
+{
+    if (ssl)
+    {
+        uWS::WebSocket<true, true, void *> *uws = (uWS::WebSocket<true, true, void *> *)ws;
+        return (void *)uws->getUserData();
     }
+    uWS::WebSocket<false, true, void *> *uws = (uWS::WebSocket<false, true, void *> *)ws;
+    return (void *)uws->getUserData();
 }
 
 void *uws_ws_get_user_data(int ssl, uws_websocket_t *ws)
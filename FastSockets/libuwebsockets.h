@@ -190,6 +190,14 @@ DLL_EXPORT void uws_filter(int ssl, uws_app_t *app, uws_filter_handler handler,
 //WebSocket
 DLL_EXPORT void uws_ws(int ssl, uws_app_t *app, const char *pattern, uws_socket_behavior_t behavior, void* user_data);
 DLL_EXPORT void *uws_ws_get_user_data(int ssl, uws_websocket_t *ws);
+/* Largest user data of uws_ws_inline */
+#define UWS_INLINE_USER_DATA_MAX 256
+/* Same as uws_ws, but the user data of every socket is a block of user_data_size bytes (at most
+ * UWS_INLINE_USER_DATA_MAX) stored inline in the socket, so it needs no allocation. Sockets of the route must be
+ * upgraded with uws_res_upgrade_inline and the same size, and their data read with uws_ws_get_inline_user_data.
+ * Returns false if user_data_size is too large. */
+DLL_EXPORT bool uws_ws_inline(int ssl, uws_app_t *app, const char *pattern, uws_socket_behavior_t behavior, size_t user_data_size, void* user_data);
+DLL_EXPORT void *uws_ws_get_inline_user_data(int ssl, uws_websocket_t *ws);
 DLL_EXPORT void uws_ws_close(int ssl, uws_websocket_t *ws);
 DLL_EXPORT uws_sendstatus_t uws_ws_send(int ssl, uws_websocket_t *ws, const char *message, size_t length, uws_opcode_t opcode);
 DLL_EXPORT uws_sendstatus_t uws_ws_send_with_options(int ssl, uws_websocket_t *ws, const char *message, size_t length, uws_opcode_t opcode, bool compress, bool fin);
@@ -230,6 +238,8 @@ DLL_EXPORT void uws_res_on_writable(int ssl, uws_res_t *res, bool (*handler)(uws
 DLL_EXPORT void uws_res_on_aborted(int ssl, uws_res_t *res, void (*handler)(uws_res_t *res, void *optional_data), void *optional_data);
 DLL_EXPORT void uws_res_on_data(int ssl, uws_res_t *res, void (*handler)(uws_res_t *res, const char *chunk, size_t chunk_length, bool is_end, void *optional_data), void *optional_data);
 DLL_EXPORT void uws_res_upgrade(int ssl, uws_res_t *res, void *data, const char *sec_web_socket_key, size_t sec_web_socket_key_length, const char *sec_web_socket_protocol, size_t sec_web_socket_protocol_length, const char *sec_web_socket_extensions, size_t sec_web_socket_extensions_length, uws_socket_context_t *ws);
+/* Upgrades to a socket of a uws_ws_inline route: user_data_size bytes of data are copied in the socket (zeros if NULL) */
+DLL_EXPORT bool uws_res_upgrade_inline(int ssl, uws_res_t *res, const void *data, size_t user_data_size, const char *sec_web_socket_key, size_t sec_web_socket_key_length, const char *sec_web_socket_protocol, size_t sec_web_socket_protocol_length, const char *sec_web_socket_extensions, size_t sec_web_socket_extensions_length, uws_socket_context_t *ws);
 DLL_EXPORT size_t uws_res_get_remote_address(int ssl, uws_res_t *res, const char **dest);
 DLL_EXPORT size_t uws_res_get_remote_address_as_text(int ssl, uws_res_t *res, const char **dest);
 #ifdef UWS_WITH_PROXY
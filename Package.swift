@@ -25,15 +25,24 @@ let package = Package(
         .package(url: "https://github.com/krzyzanowskim/CryptoSwift.git", from: "1.7.1"),
         .package(url: "https://github.com/apple/swift-docc-plugin", from: "1.0.0"),
         .package(url: "https://github.com/vapor/websocket-kit", .upToNextMajor(from: "2.6.1")),
+        .package(url: "https://github.com/apple/swift-atomics.git", from: "1.1.0"),
     ],
     targets: [
         .systemLibrary(
             name: "FastSockets",
             path: "FastSockets"
         ),
+        .target(
+            name: "Native",
+            path: "Arbitrage Bot/Native/",
+            linkerSettings: [
+                .linkedLibrary("z")
+            ]
+        ),
         .target(
             name: "Aggregator",
             dependencies: [
+                "Native",
                 .product(name: "OpenCombine", package: "OpenCombine"),
                 .product(name: "OpenCombineDispatch", package: "OpenCombine"),
                 .product(name: "OpenCombineFoundation", package: "OpenCombine"),
@@ -44,6 +53,7 @@ let package = Package(
                 .product(name: "Collections", package: "swift-collections"),
                 .product(name: "secp256k1", package: "secp256k1.swift"),
                 .product(name: "WebSocketKit", package: "websocket-kit"),
+                .product(name: "Atomics", package: "swift-atomics"),
             ],
             path: "Arbitrage Bot/Aggregator/"
         ),
@@ -51,6 +61,7 @@ let package = Package(
             name: "Arbitrage_Bot",
             dependencies: [
                 "Aggregator",
+                "Native",
                 "FastSockets"
             ],
             path: "Arbitrage Bot/Arbitrager/",
@@ -66,7 +77,7 @@ let package = Package(
         ),
         .testTarget(
             name: "Arbitrage-BotTests",
-            dependencies: ["Arbitrage_Bot"],
+            dependencies: ["Arbitrage_Bot", "Native"],
             path: "Arbitrage-BotTests"
         ),
         .executableTarget(
@@ -88,5 +99,6 @@ let package = Package(
 //            ]
 //        )
     ],
-    cLanguageStandard: .gnu99
+    cLanguageStandard: .gnu99,
+    cxxLanguageStandard: .gnucxx20
 )
@@ -16,8 +16,196 @@ interface WebSocket {
     onopen: ((event: Event) => void) | null;
     close(code?: number, reason?: string): void;
     send(data: string | ArrayBuffer | Blob | ArrayBufferView): void;
+    binaryType: "blob" | "arraybuffer";
+    readyState: number;
 }
 
+// MARK: - Binary protocol
+
+/// Subprotocol of the binary frames, see `BinaryFrame.swift`
+export const BINARY_PROTOCOL = "arbitrage-bot.v1";
+
+const FRAME_QUOTE = 1;
+const FRAME_DECISION = 2;
+const FRAME_MATRIX_SNAPSHOT = 3;
+const FRAME_MATRIX_DELTA = 4;
+/// Flag of the header: the payload is raw deflate (large frames, compressed once by the server)
+const FRAME_DEFLATED = 0x01;
+
+/// Reads the little-endian fields of a frame, in order
+class FrameReader {
+    view: DataView;
+    offset: number;
+    decoder = new TextDecoder();
+
+    constructor(view: DataView, offset: number) {
+        this.view = view;
+        this.offset = offset;
+    }
+
+    u8() {
+        return this.view.getUint8(this.offset++);
+    }
+
+    u32() {
+        const value = this.view.getUint32(this.offset, true);
+        this.offset += 4;
+        return value;
+    }
+
+    f64() {
+        const value = this.view.getFloat64(this.offset, true);
+        this.offset += 8;
+        return value;
+    }
+
+    /// NaN encodes a missing value
+    optionalF64() {
+        const value = this.f64();
+        return Number.isNaN(value) ? undefined : value;
+    }
+
+    bytes(length: number) {
+        const bytes = new Uint8Array(this.view.buffer, this.view.byteOffset + this.offset, length);
+        this.offset += length;
+        return bytes;
+    }
+
+    hex(length: number) {
+        return (
+            "0x" +
+            Array.from(this.bytes(length), (byte) => byte.toString(16).padStart(2, "0")).join("")
+        );
+    }
+
+    string() {
+        return this.decoder.decode(this.bytes(this.u8()));
+    }
+}
+
+export function isDeflated(buffer: ArrayBuffer) {
+    return buffer.byteLength >= 8 && (new DataView(buffer).getUint8(2) & FRAME_DEFLATED) !== 0;
+}
+
+/// Same frame, with its payload inflated
+export async function inflateFrame(buffer: ArrayBuffer): Promise<ArrayBuffer> {
+    const length = new DataView(buffer).getUint32(4, true);
+    const stream = new Blob([new Uint8Array(buffer, 8, length)])
+        .stream()
+        .pipeThrough(new DecompressionStream("deflate-raw"));
+    const payload = await new Response(stream).arrayBuffer();
+    const frame = new Uint8Array(8 + payload.byteLength);
+    frame.set(new Uint8Array(buffer, 0, 8));
+    frame.set(new Uint8Array(payload), 8);
+    const view = new DataView(frame.buffer);
+    view.setUint8(2, view.getUint8(2) & ~FRAME_DEFLATED);
+    view.setUint32(4, payload.byteLength, true);
+    return frame.buffer;
+}
+
+/// Turns a binary frame into the JSON message it stands for, or a matrix update
+export function decodeFrame(buffer: ArrayBuffer): any {
+    const view = new DataView(buffer);
+    const kind = view.getUint8(0);
+    const length = view.getUint32(4, true);
+    if (length + 8 > buffer.byteLength) {
+        throw new Error("Truncated frame");
+    }
+    const reader = new FrameReader(view, 8);
+    switch (kind) {
+        case FRAME_QUOTE: {
+            const price = reader.f64();
+            const transactionPrice = reader.f64();
+            const ask = reader.optionalF64();
+            const bid = reader.optionalF64();
+            const ttf = reader.optionalF64();
+            const amount = reader.f64();
+            const amountOut = reader.f64();
+            const decimals = reader.u8();
+            const tokenA = { address: reader.hex(20) } as any;
+            const tokenB = { address: reader.hex(20) } as any;
+            const exchangeName = reader.string();
+            tokenA.name = reader.string();
+            tokenB.name = reader.string();
+            return {
+                status: "success",
+                topic: "priceData",
+                quote: { exchangeName, amount, amountOut, decimals, price, transactionPrice, tokenA, tokenB, ask, bid, ttf },
+            };
+        }
+        case FRAME_DECISION: {
+            const timestamp = reader.f64();
+            const startAmount = reader.f64();
+            const profit = reader.f64();
+            const fees = reader.optionalF64();
+            const txHash = reader.hex(32);
+            const token = reader.string();
+            const route = [];
+            for (let count = reader.u8(); count > 0; count--) {
+                route.push({ exchange: reader.string(), token: reader.string() });
+            }
+            return {
+                status: "success",
+                topic: "decision",
+                executedTrade: {
+                    timestamp,
+                    token,
+                    startAmount,
+                    route,
+                    profit,
+                    fees,
+                    txHash: /^0x0+$/.test(txHash) ? undefined : txHash,
+                },
+            };
+        }
+        case FRAME_MATRIX_SNAPSHOT: {
+            const size = reader.u32();
+            const tokens = [];
+            for (let i = 0; i < size; i++) {
+                tokens.push(reader.hex(20));
+            }
+            const rates = new Float64Array(size * size);
+            for (let i = 0; i < rates.length; i++) {
+                rates[i] = reader.f64();
+            }
+            return { topic: "matrix", tokens, rates };
+        }
+        case FRAME_MATRIX_DELTA: {
+            const size = reader.u32();
+            const count = reader.u32();
+            const indices = new Uint32Array(count);
+            const values = new Float64Array(count);
+            for (let i = 0; i < count; i++) {
+                indices[i] = reader.u32();
+                values[i] = reader.f64();
+            }
+            return { topic: "matrix", size, indices, values };
+        }
+        default:
+            throw new Error(`Unknown frame kind ${kind}`);
+    }
+}
+
+/// Rates matrix of the store, streamed to binary clients
+export const useMatrixStore = create((set, get: any) => ({
+    tokens: [] as string[],
+    rates: new Float64Array(0),
+    apply: (update: any) => {
+        if (update.tokens) {
+            set({ tokens: update.tokens, rates: update.rates });
+            return;
+        }
+        const { tokens, rates } = get();
+        // Deltas of a matrix we don't have yet, a snapshot will follow
+        if (tokens.length !== update.size) return;
+        const next = rates.slice();
+        update.indices.forEach((index: number, i: number) => {
+            next[index] = update.values[i];
+        });
+        set({ rates: next });
+    },
+}));
+
 export const useClientState = create((set) => ({
     pairs: [],
     connected: false,
@@ -39,6 +227,8 @@ export const useClientState = create((set) => ({
 
 export class Client {
     url = "ws://localhost:8080/";
+    /// Ask for the binary protocol, the server falls back to JSON if it doesn't support it
+    binary = true;
     ws: WebSocket;
     reconnectTimer: any;
 
@@ -50,7 +240,10 @@ export class Client {
         if (this.ws) {
             this.ws.close();
         }
-        this.ws = new WebSocket(this.url);
+        this.ws = this.binary
+            ? new WebSocket(this.url, BINARY_PROTOCOL)
+            : new WebSocket(this.url);
+        this.ws.binaryType = "arraybuffer";
         this.ws.onopen = this.onOpen.bind(this);
         this.ws.onmessage = this.onMessage.bind(this);
         this.ws.onclose = this.onClose.bind(this);
@@ -69,12 +262,35 @@ export class Client {
         this.reconnectTimer = setTimeout(() => this.connect(), 1000);
     }
 
+    /// Set while a deflated frame is inflated, the messages received in the meantime wait for it to keep their order
+    inflating: Promise<void> | null = null;
+
     onMessage(event: MessageEvent) {
+        const deflated = event.data instanceof ArrayBuffer && isDeflated(event.data);
+        if (!deflated && !this.inflating) {
+            this.handleMessage(event.data);
+            return;
+        }
+        const inflating = (this.inflating ?? Promise.resolve())
+            .then(async () => this.handleMessage(deflated ? await inflateFrame(event.data) : event.data))
+            .catch(() => console.log("Error inflating frame"));
+        this.inflating = inflating;
+        inflating.finally(() => {
+            if (this.inflating === inflating) {
+                this.inflating = null;
+            }
+        });
+    }
+
+    handleMessage(data: string | ArrayBuffer) {
         let message;
         try {
-            message = JSON.parse(event.data);
+            message =
+                data instanceof ArrayBuffer
+                    ? decodeFrame(data)
+                    : JSON.parse(data);
         } catch (e) {
-            console.log("Error parsing message", event.data);
+            console.log("Error parsing message", data);
             return;
         }
         usePulseStore.getState().triggerPulse();
@@ -135,6 +351,15 @@ export class Client {
 
                 useClientState.getState().setArbitrage(false);
                 break;
+            case "matrix":
+                if (message.status === "error") {
+                    console.log("Matrix stream unavailable", message.error);
+                    break;
+                }
+                if (typeof message.status === "undefined") {
+                    useMatrixStore.getState().apply(message);
+                }
+                break;
             case "reset":
                 this.reset();
                 break;
@@ -255,6 +480,16 @@ export class Client {
         );
     }
 
+    /// Needs the binary protocol
+    subscribeToMatrix() {
+        this.send(
+            JSON.stringify({
+                type: "subscribe",
+                topic: "matrix",
+            })
+        );
+    }
+
     unsubscribeFromDecision() {
         this.send(
             JSON.stringify({
@@ -0,0 +1,89 @@
+// Load test of the realtime server: opens many WebSocket clients and measures how fast they
+// connect and how many updates they receive.
+//
+// Every client gets the quotes of the `botconfig.json` queries, so run the bot against a node
+// producing blocks (see `scripts/mockNode.ts`), then compare the server started with
+// `start_server` and with `start_server_threads` (SERVER_THREADS=0 in the demo):
+//   bun run scripts/loadTest.ts --url ws://localhost:8080 --clients 2000 --duration 30 --binary
+
+const BINARY_PROTOCOL = "arbitrage-bot.v1";
+
+function args(): Record<string, string> {
+    const out: Record<string, string> = {};
+    const argv = process.argv.slice(2);
+    for (let i = 0; i < argv.length; i++) {
+        if (!argv[i].startsWith("--")) continue;
+        const next = argv[i + 1];
+        out[argv[i].slice(2)] = next === undefined || next.startsWith("--") ? "true" : argv[++i];
+    }
+    return out;
+}
+
+const percentile = (sorted: number[], p: number) =>
+    sorted.length === 0 ? 0 : sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+
+function open(url: string, binary: boolean): Promise<{ ws: WebSocket; time: number }> {
+    const start = performance.now();
+    return new Promise((resolve, reject) => {
+        const ws = binary ? new WebSocket(url, BINARY_PROTOCOL) : new WebSocket(url);
+        ws.binaryType = "arraybuffer";
+        ws.onopen = () => resolve({ ws, time: performance.now() - start });
+        ws.onerror = () => reject(new Error("Connection failed"));
+    });
+}
+
+async function main() {
+    const options = args();
+    const url = options.url ?? "ws://localhost:8080";
+    const clients = parseInt(options.clients ?? "1000");
+    const duration = parseFloat(options.duration ?? "30") * 1000;
+    const batch = parseInt(options.batch ?? "100"); // Concurrent handshakes
+    const binary = options.binary === "true";
+
+    // MARK: - Connections
+    const sockets: WebSocket[] = [];
+    const connectTimes: number[] = [];
+    let failures = 0;
+    const start = performance.now();
+    for (let i = 0; i < clients; i += batch) {
+        const results = await Promise.allSettled(
+            Array.from({ length: Math.min(batch, clients - i) }, () => open(url, binary))
+        );
+        for (const result of results) {
+            if (result.status === "fulfilled") {
+                sockets.push(result.value.ws);
+                connectTimes.push(result.value.time);
+            } else {
+                failures++;
+            }
+        }
+    }
+    const connectElapsed = (performance.now() - start) / 1000;
+    connectTimes.sort((a, b) => a - b);
+    console.log(
+        `${sockets.length} clients connected in ${connectElapsed.toFixed(2)}s ` +
+            `(${(sockets.length / connectElapsed).toFixed(0)}/s, ${failures} failed), ` +
+            `handshake p50 ${percentile(connectTimes, 0.5).toFixed(1)}ms p99 ${percentile(connectTimes, 0.99).toFixed(1)}ms`
+    );
+
+    // MARK: - Broadcast
+    let messages = 0;
+    let bytes = 0;
+    for (const ws of sockets) {
+        ws.onmessage = (event) => {
+            messages++;
+            bytes += typeof event.data === "string" ? event.data.length : event.data.byteLength;
+        };
+    }
+    await new Promise((resolve) => setTimeout(resolve, duration));
+    const seconds = duration / 1000;
+    console.log(
+        `Received ${messages} messages (${(messages / seconds).toFixed(0)}/s, ` +
+            `${(bytes / seconds / 1024 / 1024).toFixed(2)} MB/s) over ${seconds}s`
+    );
+
+    sockets.forEach((ws) => ws.close());
+    process.exit(0);
+}
+
+main();
@@ -0,0 +1,360 @@
+// Local stand-in for a BSC node, replaying a recorded block/reserve trace.
+//
+// It serves what the bot uses over WebSocket (and HTTP POST): `eth_subscribe` to `newHeads` and
+// to `logs` (UniswapV2 `Sync` events), `eth_call` of `getReserves()` and of Multicall3's
+// `tryAggregate`, `eth_gasPrice`, `eth_getTransactionCount`, `eth_sendRawTransaction` and
+// `eth_getTransactionReceipt`, including JSON-RPC batches. Every received transaction is logged
+// with the time elapsed since the head it reacted to, which gives the block-to-decision latency.
+//
+// Record a trace from a real node:
+//   bun run scripts/mockNode.ts record --url wss://... --pairs 0xPair1,0xPair2 --blocks 200 --out trace.json
+// Replay it (10x faster than recorded, looping at the end):
+//   bun run scripts/mockNode.ts serve --trace trace.json --port 8546 --speed 10 --loop
+// Without `--trace`, it replays `scripts/fixtures/trace.json`: 20 blocks of the development pairs on
+// the testnet exchanges of `ExchangesList.development`.
+// Then point the bot to it: JSON_RPC_URL=ws://localhost:8546 (and TESTNET_JSON_RPC_URL).
+
+import { ethers } from "ethers";
+import { readFileSync, writeFileSync } from "fs";
+import { join } from "path";
+
+const GET_RESERVES = "0x0902f1ac";
+const TRY_AGGREGATE = "0xbce38bd7";
+const SYNC_TOPIC = ethers.utils.id("Sync(uint112,uint112)");
+
+const coder = ethers.utils.defaultAbiCoder;
+const FIXTURE = join(__dirname, "fixtures", "trace.json");
+
+// MARK: - Trace
+
+interface TraceBlock {
+    number: number;
+    timestamp: number;
+    // Pairs whose reserves changed in this block (all of them in the first block)
+    reserves: Record<string, [string, string]>;
+}
+
+interface Trace {
+    chainId: number;
+    gasPrice: string;
+    blocks: TraceBlock[];
+}
+
+function args(): Record<string, string> {
+    const out: Record<string, string> = {};
+    const argv = process.argv.slice(3);
+    for (let i = 0; i < argv.length; i++) {
+        if (!argv[i].startsWith("--")) continue;
+        const next = argv[i + 1];
+        out[argv[i].slice(2)] = next === undefined || next.startsWith("--") ? "true" : argv[++i];
+    }
+    return out;
+}
+
+const hex = (value: ethers.BigNumberish) => ethers.BigNumber.from(value).toHexString().replace(/^0x0+(?=.)/, "0x");
+
+// MARK: - Record
+
+async function record(options: Record<string, string>) {
+    const provider = new ethers.providers.WebSocketProvider(options.url);
+    const pairs = options.pairs.split(",").map((pair) => pair.toLowerCase());
+    const count = parseInt(options.blocks ?? "100");
+    const abi = ["function getReserves() view returns (uint112, uint112, uint32)"];
+
+    const network = await provider.getNetwork();
+    const trace: Trace = {
+        chainId: network.chainId,
+        gasPrice: (await provider.getGasPrice()).toHexString(),
+        blocks: [],
+    };
+    const last: Record<string, string> = {};
+
+    provider.on("block", async (number: number) => {
+        const block = await provider.getBlock(number);
+        const reserves: Record<string, [string, string]> = {};
+        await Promise.all(
+            pairs.map(async (pair) => {
+                const [reserve0, reserve1] = await new ethers.Contract(pair, abi, provider).getReserves({
+                    blockTag: number,
+                });
+                const value: [string, string] = [reserve0.toHexString(), reserve1.toHexString()];
+                if (last[pair] !== value.join()) {
+                    reserves[pair] = value;
+                    last[pair] = value.join();
+                }
+            })
+        );
+        trace.blocks.push({ number, timestamp: block.timestamp, reserves });
+        console.log(`Recorded block ${number}: ${Object.keys(reserves).length} reserve changes`);
+
+        if (trace.blocks.length >= count) {
+            trace.blocks.sort((a, b) => a.number - b.number);
+            writeFileSync(options.out ?? "trace.json", JSON.stringify(trace));
+            console.log(`Saved ${trace.blocks.length} blocks to ${options.out ?? "trace.json"}`);
+            process.exit(0);
+        }
+    });
+}
+
+// MARK: - Chain state
+
+class MockChain {
+    reserves = new Map<string, [string, string]>();
+    nonces = new Map<string, number>();
+    pending: string[] = [];
+    receipts = new Map<string, any>();
+    head: TraceBlock | undefined;
+    headHash = ethers.constants.HashZero;
+    headSentAt = 0;
+
+    constructor(readonly trace: Trace) {}
+
+    // Applies the block, mines pending transactions in it, and returns its header.
+    advance(block: TraceBlock) {
+        for (const [pair, reserves] of Object.entries(block.reserves)) {
+            this.reserves.set(pair.toLowerCase(), reserves);
+        }
+        const parentHash = this.headHash;
+        this.head = block;
+        this.headHash = ethers.utils.id(`block ${block.number} ${Date.now()}`);
+
+        this.pending.forEach((hash, index) => {
+            this.receipts.set(hash, {
+                transactionHash: hash,
+                transactionIndex: hex(index),
+                blockHash: this.headHash,
+                blockNumber: hex(block.number),
+                cumulativeGasUsed: hex(200_000 * (index + 1)),
+                gasUsed: hex(200_000),
+                contractAddress: null,
+                logs: [],
+                logsBloom: "0x" + "00".repeat(256),
+                status: "0x1",
+            });
+        });
+        this.pending = [];
+
+        return {
+            parentHash,
+            sha3Uncles: "0x1dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347",
+            miner: ethers.constants.AddressZero,
+            stateRoot: ethers.constants.HashZero,
+            transactionsRoot: ethers.constants.HashZero,
+            receiptsRoot: ethers.constants.HashZero,
+            logsBloom: "0x" + "00".repeat(256),
+            difficulty: "0x2",
+            number: hex(block.number),
+            gasLimit: "0x2faf080",
+            gasUsed: "0x0",
+            timestamp: hex(block.timestamp),
+            extraData: "0x",
+            mixHash: ethers.constants.HashZero,
+            nonce: "0x0000000000000000",
+            // BSC doesn't burn fees, but parsers expect a quantity
+            baseFeePerGas: "0x0",
+            hash: this.headHash,
+        };
+    }
+
+    syncLogs(block: TraceBlock) {
+        return Object.entries(block.reserves).map(([pair, [reserve0, reserve1]], index) => ({
+            address: pair.toLowerCase(),
+            topics: [SYNC_TOPIC],
+            data: coder.encode(["uint112", "uint112"], [reserve0, reserve1]),
+            blockNumber: hex(block.number),
+            transactionHash: ethers.utils.id(`sync ${block.number} ${index}`),
+            transactionIndex: hex(index),
+            blockHash: this.headHash,
+            logIndex: hex(index),
+            removed: false,
+        }));
+    }
+
+    call(to: string, data: string): string {
+        if (data.startsWith(GET_RESERVES)) {
+            const reserves = this.reserves.get(to.toLowerCase());
+            if (!reserves) return "0x"; // No code at this address
+            return coder.encode(["uint112", "uint112", "uint32"], [...reserves, this.head?.timestamp ?? 0]);
+        }
+        if (data.startsWith(TRY_AGGREGATE)) {
+            const [, calls] = coder.decode(["bool", "tuple(address,bytes)[]"], "0x" + data.slice(10));
+            const results = calls.map(([target, callData]: [string, string]) => {
+                try {
+                    const result = this.call(target, callData);
+                    return [result !== "0x", result];
+                } catch {
+                    return [false, "0x"];
+                }
+            });
+            return coder.encode(["tuple(bool,bytes)[]"], [results]);
+        }
+        throw new Error(`Unsupported call to ${to}: ${data.slice(0, 10)}`);
+    }
+
+    sendRawTransaction(raw: string): string {
+        const tx = ethers.utils.parseTransaction(raw);
+        const from = tx.from!.toLowerCase();
+        this.nonces.set(from, Math.max(this.nonces.get(from) ?? 0, tx.nonce + 1));
+        this.pending.push(tx.hash!);
+        console.log(
+            `Transaction ${tx.hash} from ${from} (nonce ${tx.nonce}), ` +
+                `${(performance.now() - this.headSentAt).toFixed(2)} ms after block ${this.head?.number}`
+        );
+        return tx.hash!;
+    }
+}
+
+// MARK: - JSON-RPC
+
+type Socket = { send(data: string): void };
+
+class MockNode {
+    private subscriptions = new Map<string, { socket: Socket; kind: string; filter?: any }>();
+
+    constructor(readonly chain: MockChain) {}
+
+    handle(payload: string, socket?: Socket): string {
+        const request = JSON.parse(payload);
+        const response = Array.isArray(request)
+            ? request.map((call) => this.dispatch(call, socket))
+            : this.dispatch(request, socket);
+        return JSON.stringify(response);
+    }
+
+    private dispatch(request: any, socket?: Socket) {
+        try {
+            return { jsonrpc: "2.0", id: request.id, result: this.execute(request.method, request.params ?? [], socket) };
+        } catch (error: any) {
+            return { jsonrpc: "2.0", id: request.id, error: { code: -32000, message: error.message } };
+        }
+    }
+
+    private execute(method: string, params: any[], socket?: Socket): any {
+        const chain = this.chain;
+        switch (method) {
+            case "eth_chainId":
+                return hex(chain.trace.chainId);
+            case "net_version":
+                return chain.trace.chainId.toString();
+            case "eth_blockNumber":
+                return hex(chain.head?.number ?? 0);
+            case "eth_gasPrice":
+                return chain.trace.gasPrice;
+            case "eth_estimateGas":
+                return hex(300_000);
+            case "eth_getTransactionCount":
+                return hex(chain.nonces.get(params[0].toLowerCase()) ?? 0);
+            case "eth_call":
+                return chain.call(params[0].to, params[0].data ?? params[0].input);
+            case "eth_sendRawTransaction":
+                return chain.sendRawTransaction(params[0]);
+            case "eth_getTransactionReceipt":
+                return chain.receipts.get(params[0]) ?? null;
+            case "eth_subscribe": {
+                if (!socket) throw new Error("Subscriptions need a WebSocket");
+                if (params[0] !== "newHeads" && params[0] !== "logs") {
+                    throw new Error(`Unsupported subscription ${params[0]}`);
+                }
+                const id = ethers.utils.hexlify(ethers.utils.randomBytes(16));
+                this.subscriptions.set(id, { socket, kind: params[0], filter: params[1] });
+                return id;
+            }
+            case "eth_unsubscribe":
+                return this.subscriptions.delete(params[0]);
+            default:
+                throw new Error(`Method ${method} is not supported by the mock node`);
+        }
+    }
+
+    close(socket: Socket) {
+        for (const [id, subscription] of this.subscriptions) {
+            if (subscription.socket === socket) this.subscriptions.delete(id);
+        }
+    }
+
+    publish(block: TraceBlock) {
+        const header = this.chain.advance(block);
+        const logs = this.chain.syncLogs(block);
+        this.chain.headSentAt = performance.now();
+
+        for (const [id, { socket, kind, filter }] of this.subscriptions) {
+            const notify = (result: any) =>
+                socket.send(JSON.stringify({ jsonrpc: "2.0", method: "eth_subscription", params: { subscription: id, result } }));
+            if (kind === "newHeads") {
+                notify(header);
+                continue;
+            }
+            const addresses = filter?.address
+                ? ([] as string[]).concat(filter.address).map((address) => address.toLowerCase())
+                : undefined;
+            for (const log of logs) {
+                if (!addresses || addresses.includes(log.address)) notify(log);
+            }
+        }
+    }
+}
+
+// MARK: - Serve
+
+function serve(options: Record<string, string>) {
+    const trace: Trace = JSON.parse(readFileSync(options.trace ?? FIXTURE, "utf8"));
+    const port = parseInt(options.port ?? "8546");
+    const speed = parseFloat(options.speed ?? "1");
+    const loop = options.loop === "true";
+    const node = new MockNode(new MockChain(trace));
+
+    // @ts-ignore Bun global
+    Bun.serve({
+        port,
+        async fetch(request: Request, server: any) {
+            if (server.upgrade(request)) return;
+            if (request.method !== "POST") return new Response("Mock JSON-RPC node", { status: 200 });
+            return new Response(node.handle(await request.text()), { headers: { "Content-Type": "application/json" } });
+        },
+        websocket: {
+            message(socket: Socket, message: string) {
+                socket.send(node.handle(message.toString(), socket));
+            },
+            close(socket: Socket) {
+                node.close(socket);
+            },
+        },
+    });
+    console.log(`Mock node listening on ws://localhost:${port}, replaying ${trace.blocks.length} blocks at ${speed}x`);
+
+    // Replays the blocks with their recorded spacing, divided by `speed`. Looping shifts block numbers and
+    // timestamps so they keep increasing, one block interval after the end of the previous pass.
+    const first = trace.blocks[0];
+    const last = trace.blocks[trace.blocks.length - 1];
+    const interval = trace.blocks.length > 1 ? (last.timestamp - first.timestamp) / (trace.blocks.length - 1) : 3;
+    let index = 0;
+    let offset = { number: 0, timestamp: 0 };
+    const next = () => {
+        if (index >= trace.blocks.length) {
+            if (!loop) return console.log("End of trace");
+            offset = {
+                number: offset.number + last.number - first.number + 1,
+                timestamp: offset.timestamp + last.timestamp - first.timestamp + Math.max(Math.round(interval), 1),
+            };
+            index = 0;
+        }
+        const block = trace.blocks[index];
+        node.publish({ ...block, number: block.number + offset.number, timestamp: block.timestamp + offset.timestamp });
+        const following = trace.blocks[index + 1];
+        const delay = following ? (following.timestamp - block.timestamp) * 1000 : interval * 1000;
+        index++;
+        setTimeout(next, Math.max(delay, 1) / speed);
+    };
+    // Leave some time to the bot to connect and subscribe
+    setTimeout(next, parseInt(options.delay ?? "2000"));
+}
+
+const mode = process.argv[2];
+if (mode === "record") {
+    record(args());
+} else if (mode === "serve") {
+    serve(args());
+} else {
+    console.log("Usage: mockNode.ts record --url <wss> --pairs <a,b,...> [--blocks 100] [--out trace.json]");
+    console.log("       mockNode.ts serve [--trace scripts/fixtures/trace.json] [--port 8546] [--speed 1] [--loop] [--delay 2000]");
+}